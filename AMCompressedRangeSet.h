@@ -0,0 +1,540 @@
+/**
+ * @file: AMCompressedRangeSet.h
+ * Read only compressed set of ranges
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMCOMPRESSEDRANGESET_H
+#define AMCORE_AMCOMPRESSEDRANGESET_H
+
+#include "AMRangeSet.h"
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+/**
+ *  @brief number of ranges in one block of compressed set, point lookup decodes at most one block
+ */
+#ifndef AMRANGE_COMPRESSED_BLOCK_SIZE
+#define AMRANGE_COMPRESSED_BLOCK_SIZE 64
+#endif
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Common
+     *  @brief Read only compressed set of ranges
+     *
+     *  Packed set of ranges with integral bounds encoded as deltas in LEB128 varints. Every range is stored
+     *  as gap from previous range and its length (both minus one, packed ranges are nonempty and separated),
+     *  so dense sets with small gaps take two or three bytes per range instead of 2 * sizeof(T).
+     *  Ranges are split into blocks of AMRANGE_COMPRESSED_BLOCK_SIZE ranges, skip index holds first left
+     *  bound, last right bound and byte offset of every block. Point lookup is binary search in skip index
+     *  and decoding of one block, iteration decodes ranges on the fly.
+     *
+     *  Set is immutable, it is built from packed set of ranges and may be expanded back to AMRangeSet.
+     */
+    template<typename T>
+    class AMCompressedRangeSet
+    {
+        static_assert(std::is_integral<T>::value, "compressed set needs integral bounds");
+
+    public:
+        /**
+         *  @brief value type
+         */
+        typedef AMRange<T> value_type;
+        /**
+         *  @brief size type
+         */
+        typedef std::size_t size_type;
+
+    private:
+        typedef typename std::make_unsigned<T>::type U;
+
+        /**
+         *  @brief skip index entry
+         */
+        struct Block
+        {
+            T from;
+            T to;
+            size_type offset;
+        };
+
+    public:
+        /**
+         *  @brief iterator decoding ranges
+         */
+        class const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef AMRange<T> value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const value_type *pointer;
+            typedef const value_type &reference;
+
+            /**
+             *  @brief end iterator of empty set
+             *  @throw This function will not throw an exception.
+             */
+            const_iterator();
+
+            /**
+             *  @brief current range
+             *  @throw This function will not throw an exception.
+             */
+            inline reference operator*() const;
+
+            /**
+             *  @brief current range
+             *  @throw This function will not throw an exception.
+             */
+            inline pointer operator->() const;
+
+            /**
+             *  @brief next range
+             *  @throw This function will not throw an exception.
+             */
+            inline const_iterator &operator++();
+
+            /**
+             *  @brief next range
+             *  @throw This function will not throw an exception.
+             */
+            inline const_iterator operator++(int);
+
+            /**
+             *  @brief comparison operator
+             *  Iterators of the same set are equal when they are at the same index.
+             *  @throw This function will not throw an exception.
+             */
+            inline bool operator==(const const_iterator &right) const;
+
+            /**
+             *  @brief comparison operator
+             *  @throw This function will not throw an exception.
+             */
+            inline bool operator!=(const const_iterator &right) const;
+
+        private:
+            friend class AMCompressedRangeSet;
+
+            /**
+             *  @brief iterator at first range of block, or end when block is behind last block
+             *  @throw This function will not throw an exception.
+             */
+            const_iterator(const AMCompressedRangeSet &set, size_type block);
+
+            const std::uint8_t *mPos;
+            const Block *mBlocks;
+            size_type mIndex;
+            size_type mSize;
+            AMRange<T> mCurrent;
+        };
+
+        /**
+         *  @brief empty constructor
+         *  @throw This function will not throw an exception.
+         */
+        AMCompressedRangeSet();
+
+        /**
+         *  @brief constructor from packed ranges
+         *  Ranges must be packed and sorted in ascending order, it is not checked. Empty ranges are skipped.
+         *  @param first begin of ranges
+         *  @param last end of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename InputIt>
+        AMCompressedRangeSet(InputIt first, InputIt last);
+
+        /**
+         *  @brief compression of flat set of ranges
+         *  @param s set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename Alloc>
+        explicit AMCompressedRangeSet(const AMRangeSet<T, Alloc> &s);
+
+        /**
+         *  @brief compression of set of ranges
+         *  Set of ranges need not to be packed, it is packed before.
+         *  @param s set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename Alloc>
+        explicit AMCompressedRangeSet(const AMRangeStdSet<T, Alloc> &s);
+
+        /**
+         *  @brief decompression
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet<T> toRangeSet() const;
+
+        /**
+         *  @brief first range
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator begin() const;
+
+        /**
+         *  @brief behind last range
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator end() const;
+
+        /**
+         *  @brief number of ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline size_type size() const;
+
+        /**
+         *  @brief test for empty
+         *  @throw This function will not throw an exception.
+         */
+        inline bool empty() const;
+
+        /**
+         *  @brief memory held by set
+         *  Encoded ranges, skip index and the object itself, in bytes.
+         *  @throw This function will not throw an exception.
+         */
+        inline size_type memoryUsage() const;
+
+        /**
+         *  @brief comparison operator
+         *  @param right operand
+         *  @throw This function will not throw an exception.
+         */
+        inline bool operator==(const AMCompressedRangeSet &right) const;
+
+        /**
+         *  @brief comparison operator
+         *  @param right operand
+         *  @throw This function will not throw an exception.
+         */
+        inline bool operator!=(const AMCompressedRangeSet &right) const;
+
+        /**
+         *  @brief find range containing number
+         *  Binary search in skip index and decoding of one block.
+         *  @param num
+         *  @return iterator to range containing num or end()
+         *  @throw This function will not throw an exception.
+         */
+        const_iterator find(T num) const;
+
+        /**
+         *  @brief test that range is fully covered
+         *  Empty range is always covered.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool covers(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief test that range has nonempty intersection with set
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool overlaps(const AMRange<T> &rng) const;
+
+    private:
+        /**
+         *  @brief append range, it must be above last appended range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        void append(const AMRange<T> &rng);
+
+        /**
+         *  @brief first range which ends above num
+         *  @throw This function will not throw an exception.
+         */
+        const_iterator endingAbove(T num) const;
+
+        /**
+         *  @brief write unsigned number as LEB128 varint
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static inline void writeVarint(std::vector<std::uint8_t> &data, U value);
+
+        /**
+         *  @brief read LEB128 varint and move behind it
+         *  @throw This function will not throw an exception.
+         */
+        static inline U readVarint(const std::uint8_t *&pos);
+
+        std::vector<std::uint8_t> mData;
+        std::vector<Block> mBlocks;
+        size_type mSize;
+    };
+
+
+    template<typename T>
+    AMCompressedRangeSet<T>::const_iterator::const_iterator()
+        : mPos(nullptr),
+          mBlocks(nullptr),
+          mIndex(0),
+          mSize(0),
+          mCurrent()
+    {
+    }
+
+    template<typename T>
+    AMCompressedRangeSet<T>::const_iterator::const_iterator(const AMCompressedRangeSet &set, size_type block)
+        : mPos(nullptr),
+          mBlocks(set.mBlocks.data()),
+          mIndex(set.mSize),
+          mSize(set.mSize),
+          mCurrent()
+    {
+        if (block < set.mBlocks.size()) {
+            const Block &b = set.mBlocks[block];
+            mPos = set.mData.data() + b.offset;
+            mIndex = block * AMRANGE_COMPRESSED_BLOCK_SIZE;
+            mCurrent.from = b.from;
+            mCurrent.to = T(U(b.from) + readVarint(mPos) + 1);
+        }
+    }
+
+    template<typename T>
+    inline typename AMCompressedRangeSet<T>::const_iterator::reference
+    AMCompressedRangeSet<T>::const_iterator::operator*() const
+    {
+        return mCurrent;
+    }
+
+    template<typename T>
+    inline typename AMCompressedRangeSet<T>::const_iterator::pointer
+    AMCompressedRangeSet<T>::const_iterator::operator->() const
+    {
+        return &mCurrent;
+    }
+
+    template<typename T>
+    inline typename AMCompressedRangeSet<T>::const_iterator &AMCompressedRangeSet<T>::const_iterator::operator++()
+    {
+        mIndex++;
+        if (mIndex == mSize) {
+            return *this;
+        }
+        // first range of block starts at bound kept in skip index, next ones at gap behind previous range
+        U from = mIndex % AMRANGE_COMPRESSED_BLOCK_SIZE == 0 ? U(mBlocks[mIndex / AMRANGE_COMPRESSED_BLOCK_SIZE].from)
+                                                              : U(mCurrent.to) + readVarint(mPos) + 1;
+        mCurrent.from = T(from);
+        mCurrent.to = T(from + readVarint(mPos) + 1);
+        return *this;
+    }
+
+    template<typename T>
+    inline typename AMCompressedRangeSet<T>::const_iterator AMCompressedRangeSet<T>::const_iterator::operator++(int)
+    {
+        const_iterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    template<typename T>
+    inline bool AMCompressedRangeSet<T>::const_iterator::operator==(const const_iterator &right) const
+    {
+        return mIndex == right.mIndex;
+    }
+
+    template<typename T>
+    inline bool AMCompressedRangeSet<T>::const_iterator::operator!=(const const_iterator &right) const
+    {
+        return mIndex != right.mIndex;
+    }
+
+    template<typename T>
+    AMCompressedRangeSet<T>::AMCompressedRangeSet()
+        : mData(),
+          mBlocks(),
+          mSize(0)
+    {
+    }
+
+    template<typename T>
+    template<typename InputIt>
+    AMCompressedRangeSet<T>::AMCompressedRangeSet(InputIt first, InputIt last)
+        : mData(),
+          mBlocks(),
+          mSize(0)
+    {
+        for (; first != last; first++) {
+            if (first->nonEmpty()) {
+                append(*first);
+            }
+        }
+        mData.shrink_to_fit();
+        mBlocks.shrink_to_fit();
+    }
+
+    template<typename T>
+    template<typename Alloc>
+    AMCompressedRangeSet<T>::AMCompressedRangeSet(const AMRangeSet<T, Alloc> &s)
+        : AMCompressedRangeSet(s.begin(), s.end())
+    {
+    }
+
+    template<typename T>
+    template<typename Alloc>
+    AMCompressedRangeSet<T>::AMCompressedRangeSet(const AMRangeStdSet<T, Alloc> &s)
+        : mData(),
+          mBlocks(),
+          mSize(0)
+    {
+        AMRangeStdSet<T, Alloc> ps(s.get_allocator());
+        const AMRangeStdSet<T, Alloc> &p = isPacked(s) ? s : (ps = pack(s));
+        *this = AMCompressedRangeSet(p.begin(), p.end());
+    }
+
+    template<typename T>
+    void AMCompressedRangeSet<T>::append(const AMRange<T> &rng)
+    {
+        if (mSize % AMRANGE_COMPRESSED_BLOCK_SIZE == 0) {
+            mBlocks.push_back(Block{rng.from, rng.to, mData.size()});
+        } else {
+            writeVarint(mData, U(rng.from) - U(mBlocks.back().to) - 1);
+            mBlocks.back().to = rng.to;
+        }
+        writeVarint(mData, U(rng.to) - U(rng.from) - 1);
+        mSize++;
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMCompressedRangeSet<T>::toRangeSet() const
+    {
+        std::vector<AMRange<T> > ranges;
+        ranges.reserve(mSize);
+        ranges.assign(begin(), end());
+        return AMRangeSet<T>::fromPacked(std::move(ranges));
+    }
+
+    template<typename T>
+    inline typename AMCompressedRangeSet<T>::const_iterator AMCompressedRangeSet<T>::begin() const
+    {
+        return const_iterator(*this, 0);
+    }
+
+    template<typename T>
+    inline typename AMCompressedRangeSet<T>::const_iterator AMCompressedRangeSet<T>::end() const
+    {
+        return const_iterator(*this, mBlocks.size());
+    }
+
+    template<typename T>
+    inline typename AMCompressedRangeSet<T>::size_type AMCompressedRangeSet<T>::size() const
+    {
+        return mSize;
+    }
+
+    template<typename T>
+    inline bool AMCompressedRangeSet<T>::empty() const
+    {
+        return mSize == 0;
+    }
+
+    template<typename T>
+    inline typename AMCompressedRangeSet<T>::size_type AMCompressedRangeSet<T>::memoryUsage() const
+    {
+        return sizeof(*this) + mData.capacity() + mBlocks.capacity() * sizeof(Block);
+    }
+
+    template<typename T>
+    inline bool AMCompressedRangeSet<T>::operator==(const AMCompressedRangeSet<T> &right) const
+    {
+        // encoding of packed set is unique, first range of block is stored in skip index only
+        return mSize == right.mSize && mData == right.mData &&
+               std::equal(mBlocks.begin(), mBlocks.end(), right.mBlocks.begin(), right.mBlocks.end(),
+                          [](const Block &l, const Block &r) { return l.from == r.from && l.to == r.to; });
+    }
+
+    template<typename T>
+    inline bool AMCompressedRangeSet<T>::operator!=(const AMCompressedRangeSet<T> &right) const
+    {
+        return !(*this == right);
+    }
+
+    template<typename T>
+    typename AMCompressedRangeSet<T>::const_iterator AMCompressedRangeSet<T>::endingAbove(T num) const
+    {
+        typename std::vector<Block>::const_iterator block =
+            std::partition_point(mBlocks.begin(), mBlocks.end(), [num](const Block &b) { return b.to <= num; });
+        const_iterator it(*this, block - mBlocks.begin());
+        if (block != mBlocks.end()) {
+            // last range of block ends above num, so decoding stops inside block
+            while (it->to <= num) {
+                ++it;
+            }
+        }
+        return it;
+    }
+
+    template<typename T>
+    typename AMCompressedRangeSet<T>::const_iterator AMCompressedRangeSet<T>::find(T num) const
+    {
+        const_iterator it = endingAbove(num);
+        if (it != end() && it->from <= num) {
+            return it;
+        }
+        return end();
+    }
+
+    template<typename T>
+    bool AMCompressedRangeSet<T>::covers(const AMRange<T> &rng) const
+    {
+        if (!rng.nonEmpty()) {
+            return true;
+        }
+        const_iterator it = find(rng.from);
+        return it != end() && it->to >= rng.to;
+    }
+
+    template<typename T>
+    bool AMCompressedRangeSet<T>::overlaps(const AMRange<T> &rng) const
+    {
+        if (!rng.nonEmpty()) {
+            return false;
+        }
+        const_iterator it = endingAbove(rng.from);
+        return it != end() && it->from < rng.to;
+    }
+
+    template<typename T>
+    inline void AMCompressedRangeSet<T>::writeVarint(std::vector<std::uint8_t> &data, U value)
+    {
+        while (value >= 0x80) {
+            data.push_back(std::uint8_t(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(std::uint8_t(value));
+    }
+
+    template<typename T>
+    inline typename AMCompressedRangeSet<T>::U AMCompressedRangeSet<T>::readVarint(const std::uint8_t *&pos)
+    {
+        U value = *pos & 0x7f;
+        int shift = 7;
+        while (*pos++ & 0x80) {
+            value |= U(*pos & 0x7f) << shift;
+            shift += 7;
+        }
+        return value;
+    }
+}
+
+/** @} */
+
+#endif //AMCORE_AMCOMPRESSEDRANGESET_H
@@ -0,0 +1,496 @@
+/**
+ * @file: AMConcurrentRangeSet.h
+ * Set of ranges shared by threads, readers do not wait
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMCONCURRENTRANGESET_H
+#define AMCORE_AMCONCURRENTRANGESET_H
+
+#include "AMRangeSet.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ *  @brief number of reader counters, threads are spread over them to avoid contention on one cache line
+ */
+#ifndef AMRANGE_CONCURRENT_SHARDS
+#define AMRANGE_CONCURRENT_SHARDS 16
+#endif
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Common
+     *  @brief Set of ranges shared by threads, readers do not wait
+     *
+     *  Current content is immutable AMRangeSet published thru atomic pointer. Reader increments reader counter
+     *  and loads the pointer, e.q. three atomic operations without loop or lock, so lookups are wait-free
+     *  and their latency does not depend on writers. Writer copies current set, changes the copy, publishes it
+     *  by pointer exchange and deletes old set after grace period, when no reader can use it any more.
+     *
+     *  Reader counters are sharded by thread and every shard has counters for two parities. Reader increments
+     *  counter of current parity. Grace period flips parity and waits until counters of old parity drop to zero,
+     *  twice, so writer waits only for readers, which started before publication, even when new readers come
+     *  all the time.
+     *
+     *  Writers are serialized by one lock, every write copies set, e.q. O(n) time. Changes should be grouped
+     *  by update() or modify(), which publish many changes at once. Snapshot held by reader delays writers,
+     *  so it should be short lived.
+     *
+     *  Thread holding snapshot must not write to the same set, also not from function passed to read(),
+     *  writer would wait for its own reader counter forever. Without NDEBUG it is detected by assert,
+     *  snapshots taken by each thread are tracked for it, so snapshot should be destroyed by thread which took it.
+     */
+    template<typename T>
+    class AMConcurrentRangeSet
+    {
+    public:
+        /**
+         *  @brief value type
+         */
+        typedef AMRange<T> value_type;
+        /**
+         *  @brief size type
+         */
+        typedef std::size_t size_type;
+        /**
+         *  @brief type of total length of ranges
+         */
+        typedef AMRangeMeasure<T> measure_type;
+
+        /**
+         *  @brief consistent read only view of set
+         *  Set seen thru snapshot does not change and it is not deleted until snapshot is destroyed.
+         */
+        class Snapshot
+        {
+        public:
+            /**
+             *  @brief move constructor
+             *  @throw This function will not throw an exception.
+             */
+            Snapshot(Snapshot &&other) noexcept;
+
+            Snapshot(const Snapshot &) = delete;
+            Snapshot &operator=(const Snapshot &) = delete;
+            Snapshot &operator=(Snapshot &&) = delete;
+
+            /**
+             *  @brief destructor
+             *  Releases set for writers.
+             *  @throw This function will not throw an exception.
+             */
+            ~Snapshot();
+
+            /**
+             *  @brief set
+             *  @throw This function will not throw an exception.
+             */
+            inline const AMRangeSet<T> &operator*() const;
+
+            /**
+             *  @brief set
+             *  @throw This function will not throw an exception.
+             */
+            inline const AMRangeSet<T> *operator->() const;
+
+        private:
+            friend class AMConcurrentRangeSet;
+
+            Snapshot(const AMConcurrentRangeSet *owner, std::atomic<std::size_t> *counter, const AMRangeSet<T> *set);
+
+            const AMConcurrentRangeSet *mOwner;
+            std::atomic<std::size_t> *mCounter;
+            const AMRangeSet<T> *mSet;
+        };
+
+        /**
+         *  @brief empty constructor
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMConcurrentRangeSet();
+
+        /**
+         *  @brief constructor
+         *  @param s initial content
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        explicit AMConcurrentRangeSet(AMRangeSet<T> s);
+
+        AMConcurrentRangeSet(const AMConcurrentRangeSet &) = delete;
+        AMConcurrentRangeSet &operator=(const AMConcurrentRangeSet &) = delete;
+
+        /**
+         *  @brief destructor
+         *  No reader nor writer may use set any more.
+         *  @throw This function will not throw an exception.
+         */
+        ~AMConcurrentRangeSet();
+
+        /**
+         *  @brief current content for several lookups
+         *  Wait-free.
+         *  @throw This function will not throw an exception.
+         */
+        Snapshot snapshot() const;
+
+        /**
+         *  @brief call function with current content
+         *  Wait-free, except function itself.
+         *  @param f function called with const AMRangeSet&lt;T&gt; &
+         *  @return what function returns
+         *  @throw Only what function throws.
+         */
+        template<typename F>
+        auto read(F f) const -> decltype(f(std::declval<const AMRangeSet<T> &>()));
+
+        /**
+         *  @brief test that number is in set
+         *  Wait-free, binary search, e.q. O(log n) time.
+         *  @param num
+         *  @throw This function will not throw an exception.
+         */
+        bool contains(T num) const;
+
+        /**
+         *  @brief test that range is fully covered
+         *  Wait-free, binary search, e.q. O(log n) time.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool covers(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief test that range has nonempty intersection with set
+         *  Wait-free, binary search, e.q. O(log n) time.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool overlaps(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief number of ranges
+         *  @throw This function will not throw an exception.
+         */
+        size_type size() const;
+
+        /**
+         *  @brief total length of ranges
+         *  @throw This function will not throw an exception.
+         */
+        measure_type measure() const;
+
+        /**
+         *  @brief copy of current content
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet<T> toRangeSet() const;
+
+        /**
+         *  @brief add range
+         *  @param r range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        void insert(const AMRange<T> &r);
+
+        /**
+         *  @brief remove range
+         *  @param r range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        void erase(const AMRange<T> &r);
+
+        /**
+         *  @brief add and remove ranges at once
+         *  Readers see either none or all changes. Ranges are removed after adding.
+         *  @param inserted ranges to add in any order
+         *  @param erased ranges to remove in any order
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        void update(const std::vector<AMRange<T> > &inserted, const std::vector<AMRange<T> > &erased);
+
+        /**
+         *  @brief change copy of current content and publish it
+         *  Readers see either none or all changes. If function throws, nothing is published.
+         *  @param f function called with AMRangeSet&lt;T&gt; &
+         *  @throw std::bad_alloc if allocation fails, or what function throws.
+         */
+        template<typename F>
+        void modify(F f);
+
+        /**
+         *  @brief replace content
+         *  @param s new content
+         *  @throw This function will not throw an exception.
+         */
+        void assign(AMRangeSet<T> s);
+
+    private:
+        /**
+         *  @brief reader counters of one shard
+         */
+        struct alignas(64) Shard
+        {
+            std::atomic<std::size_t> readers[2];
+        };
+
+        /**
+         *  @brief shard of calling thread
+         *  @throw This function will not throw an exception.
+         */
+        static inline unsigned shardIndex();
+
+#ifndef NDEBUG
+        /**
+         *  @brief sets read by snapshots of calling thread, one item per snapshot
+         *  Used only to detect writer waiting for itself.
+         *  @throw This function will not throw an exception.
+         */
+        static inline std::vector<const AMConcurrentRangeSet *> &pinned();
+#endif
+
+        /**
+         *  @brief publish new set and delete old one after grace period
+         *  Writer lock must be held.
+         *  @throw This function will not throw an exception.
+         */
+        void publish(std::unique_ptr<AMRangeSet<T> > s);
+
+        /**
+         *  @brief flip parity and wait for readers of old parity
+         *  @throw This function will not throw an exception.
+         */
+        void flipAndWait();
+
+        mutable Shard mShards[AMRANGE_CONCURRENT_SHARDS];
+        std::atomic<unsigned> mParity;
+        std::atomic<const AMRangeSet<T> *> mCurrent;
+        std::mutex mWriter;
+    };
+
+
+    template<typename T>
+    AMConcurrentRangeSet<T>::Snapshot::Snapshot(const AMConcurrentRangeSet *owner, std::atomic<std::size_t> *counter,
+                                                const AMRangeSet<T> *set)
+        : mOwner(owner),
+          mCounter(counter),
+          mSet(set)
+    {
+#ifndef NDEBUG
+        pinned().push_back(mOwner);
+#endif
+    }
+
+    template<typename T>
+    AMConcurrentRangeSet<T>::Snapshot::Snapshot(Snapshot &&other) noexcept
+        : mOwner(other.mOwner),
+          mCounter(other.mCounter),
+          mSet(other.mSet)
+    {
+        other.mCounter = nullptr;
+    }
+
+    template<typename T>
+    AMConcurrentRangeSet<T>::Snapshot::~Snapshot()
+    {
+        if (mCounter) {
+            mCounter->fetch_sub(1);
+#ifndef NDEBUG
+            std::vector<const AMConcurrentRangeSet *> &p = pinned();
+            typedef typename std::vector<const AMConcurrentRangeSet *>::reverse_iterator pin_iterator;
+            pin_iterator it = std::find(p.rbegin(), p.rend(), mOwner);
+            if (it != p.rend()) {
+                p.erase(std::next(it).base());
+            }
+#endif
+        }
+    }
+
+    template<typename T>
+    inline const AMRangeSet<T> &AMConcurrentRangeSet<T>::Snapshot::operator*() const
+    {
+        return *mSet;
+    }
+
+    template<typename T>
+    inline const AMRangeSet<T> *AMConcurrentRangeSet<T>::Snapshot::operator->() const
+    {
+        return mSet;
+    }
+
+    template<typename T>
+    AMConcurrentRangeSet<T>::AMConcurrentRangeSet()
+        : AMConcurrentRangeSet(AMRangeSet<T>())
+    {
+    }
+
+    template<typename T>
+    AMConcurrentRangeSet<T>::AMConcurrentRangeSet(AMRangeSet<T> s)
+        : mParity(0),
+          mCurrent(new AMRangeSet<T>(std::move(s)))
+    {
+        for (Shard &shard : mShards) {
+            shard.readers[0] = 0;
+            shard.readers[1] = 0;
+        }
+    }
+
+    template<typename T>
+    AMConcurrentRangeSet<T>::~AMConcurrentRangeSet()
+    {
+        delete mCurrent.load();
+    }
+
+    template<typename T>
+    inline unsigned AMConcurrentRangeSet<T>::shardIndex()
+    {
+        static std::atomic<unsigned> next(0);
+        static thread_local unsigned index = next.fetch_add(1, std::memory_order_relaxed) % AMRANGE_CONCURRENT_SHARDS;
+        return index;
+    }
+
+#ifndef NDEBUG
+    template<typename T>
+    inline std::vector<const AMConcurrentRangeSet<T> *> &AMConcurrentRangeSet<T>::pinned()
+    {
+        static thread_local std::vector<const AMConcurrentRangeSet *> sets;
+        return sets;
+    }
+#endif
+
+    template<typename T>
+    typename AMConcurrentRangeSet<T>::Snapshot AMConcurrentRangeSet<T>::snapshot() const
+    {
+        // counter is incremented before pointer is loaded, so grace period of writer which replaces
+        // loaded pointer waits for this reader
+        std::atomic<std::size_t> *counter = &mShards[shardIndex()].readers[mParity.load()];
+        counter->fetch_add(1);
+        return Snapshot(this, counter, mCurrent.load());
+    }
+
+    template<typename T>
+    template<typename F>
+    auto AMConcurrentRangeSet<T>::read(F f) const -> decltype(f(std::declval<const AMRangeSet<T> &>()))
+    {
+        Snapshot s = snapshot();
+        return f(*s);
+    }
+
+    template<typename T>
+    bool AMConcurrentRangeSet<T>::contains(T num) const
+    {
+        Snapshot s = snapshot();
+        return s->find(num) != s->end();
+    }
+
+    template<typename T>
+    bool AMConcurrentRangeSet<T>::covers(const AMRange<T> &rng) const
+    {
+        return snapshot()->covers(rng);
+    }
+
+    template<typename T>
+    bool AMConcurrentRangeSet<T>::overlaps(const AMRange<T> &rng) const
+    {
+        return snapshot()->overlaps(rng);
+    }
+
+    template<typename T>
+    typename AMConcurrentRangeSet<T>::size_type AMConcurrentRangeSet<T>::size() const
+    {
+        return snapshot()->size();
+    }
+
+    template<typename T>
+    typename AMConcurrentRangeSet<T>::measure_type AMConcurrentRangeSet<T>::measure() const
+    {
+        return snapshot()->measure();
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMConcurrentRangeSet<T>::toRangeSet() const
+    {
+        return *snapshot();
+    }
+
+    template<typename T>
+    void AMConcurrentRangeSet<T>::insert(const AMRange<T> &r)
+    {
+        modify([&r](AMRangeSet<T> &s) { s += r; });
+    }
+
+    template<typename T>
+    void AMConcurrentRangeSet<T>::erase(const AMRange<T> &r)
+    {
+        modify([&r](AMRangeSet<T> &s) { s -= r; });
+    }
+
+    template<typename T>
+    void AMConcurrentRangeSet<T>::update(const std::vector<AMRange<T> > &inserted,
+                                         const std::vector<AMRange<T> > &erased)
+    {
+        AMRangeSet<T> add = AMRangeSet<T>::fromUnsorted(inserted.begin(), inserted.end());
+        AMRangeSet<T> remove = AMRangeSet<T>::fromUnsorted(erased.begin(), erased.end());
+        std::lock_guard<std::mutex> lock(mWriter);
+        // new set is built by two passes, current set is not copied before
+        publish(std::unique_ptr<AMRangeSet<T> >(new AMRangeSet<T>(*mCurrent.load() + add - remove)));
+    }
+
+    template<typename T>
+    template<typename F>
+    void AMConcurrentRangeSet<T>::modify(F f)
+    {
+        std::lock_guard<std::mutex> lock(mWriter);
+        std::unique_ptr<AMRangeSet<T> > s(new AMRangeSet<T>(*mCurrent.load()));
+        f(*s);
+        publish(std::move(s));
+    }
+
+    template<typename T>
+    void AMConcurrentRangeSet<T>::assign(AMRangeSet<T> s)
+    {
+        std::unique_ptr<AMRangeSet<T> > p(new AMRangeSet<T>(std::move(s)));
+        std::lock_guard<std::mutex> lock(mWriter);
+        publish(std::move(p));
+    }
+
+    template<typename T>
+    void AMConcurrentRangeSet<T>::publish(std::unique_ptr<AMRangeSet<T> > s)
+    {
+        assert(std::find(pinned().begin(), pinned().end(), this) == pinned().end() &&
+               "thread holding snapshot writes to the same set, it would wait for itself forever");
+        std::unique_ptr<const AMRangeSet<T> > old(mCurrent.exchange(s.release()));
+        // reader which read parity before first flip may increment its counter after first wait,
+        // second flip waits for it too
+        flipAndWait();
+        flipAndWait();
+    }
+
+    template<typename T>
+    void AMConcurrentRangeSet<T>::flipAndWait()
+    {
+        unsigned parity = mParity.load();
+        mParity.store(parity ^ 1);
+        for (Shard &shard : mShards) {
+            while (shard.readers[parity].load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+/** @} */
+
+#endif //AMCORE_AMCONCURRENTRANGESET_H
@@ -0,0 +1,1013 @@
+/**
+ * @file: AMFreeSpaceMap.h
+ * Map of free space with first fit, next fit and best fit search
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMFREESPACEMAP_H
+#define AMCORE_AMFREESPACEMAP_H
+
+#include "AMRangeSet.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Common
+     *  @brief Map of free space with first fit, next fit and best fit search
+     *
+     *  Space is given by range, everything is free at start. Free ranges are kept packed in two balanced
+     *  trees (AVL) sharing nodes. Tree ordered by address keeps longest free range of every subtree,
+     *  so first free range of required length after any address is found in O(log n) time. Tree ordered
+     *  by length and address finds shortest free range of required length, e.q. best fit, in O(log n) time.
+     *  Searches do not allocate.
+     *
+     *  Reserving and releasing changes free range in place, or inserts or removes one node, O(log n) time.
+     *  Node is allocated only when new free range appears, so reserving found range at start of free range
+     *  does not allocate either. Range spanning k free ranges takes O(k log n) time.
+     */
+    template<typename T>
+    class AMFreeSpaceMap
+    {
+    public:
+        /**
+         *  @brief value type
+         */
+        typedef AMRange<T> value_type;
+        /**
+         *  @brief size type
+         */
+        typedef std::size_t size_type;
+        /**
+         *  @brief type of lengths
+         */
+        typedef AMRangeMeasure<T> measure_type;
+
+        /**
+         *  @brief constructor
+         *  @param space whole space, everything is free
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        explicit AMFreeSpaceMap(const AMRange<T> &space);
+
+        /**
+         *  @brief constructor
+         *  O(n log n) time.
+         *  @param space whole space
+         *  @param used reserved ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMFreeSpaceMap(const AMRange<T> &space, const AMRangeSet<T> &used);
+
+        /**
+         *  @brief move constructor
+         *  @throw This function will not throw an exception.
+         */
+        AMFreeSpaceMap(AMFreeSpaceMap &&other) noexcept;
+
+        /**
+         *  @brief move assignment
+         *  @throw This function will not throw an exception.
+         */
+        AMFreeSpaceMap &operator=(AMFreeSpaceMap &&other) noexcept;
+
+        AMFreeSpaceMap(const AMFreeSpaceMap &) = delete;
+        AMFreeSpaceMap &operator=(const AMFreeSpaceMap &) = delete;
+
+        /**
+         *  @brief whole space
+         *  @throw This function will not throw an exception.
+         */
+        inline const AMRange<T> &space() const;
+
+        /**
+         *  @brief number of free ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline size_type size() const;
+
+        /**
+         *  @brief total length of free ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline measure_type freeMeasure() const;
+
+        /**
+         *  @brief length of longest free range
+         *  @throw This function will not throw an exception.
+         */
+        inline measure_type largestFree() const;
+
+        /**
+         *  @brief test that number is free
+         *  O(log n) time.
+         *  @param num
+         *  @throw This function will not throw an exception.
+         */
+        bool isFree(T num) const;
+
+        /**
+         *  @brief test that whole range is free
+         *  O(log n) time.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool isFree(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief free ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet<T> freeRanges() const;
+
+        /**
+         *  @brief reserved ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet<T> usedRanges() const;
+
+        /**
+         *  @brief lowest free range of given length
+         *  O(log n) time.
+         *  @param len length, greater than zero
+         *  @return range at start of first long enough free range, or empty range, when there is none
+         *  @throw This function will not throw an exception.
+         */
+        AMRange<T> firstFit(measure_type len) const;
+
+        /**
+         *  @brief lowest free range of given length inside bound
+         *  O(log n) time.
+         *  @param len length, greater than zero
+         *  @param bound range, which must contain result
+         *  @return free range, or empty range, when there is none
+         *  @throw This function will not throw an exception.
+         */
+        AMRange<T> firstFit(measure_type len, const AMRange<T> &bound) const;
+
+        /**
+         *  @brief lowest free range of given length from hint, continues from start of space
+         *  O(log n) time.
+         *  @param len length, greater than zero
+         *  @param hint address, usually end of previous allocation
+         *  @return free range, or empty range, when there is none
+         *  @throw This function will not throw an exception.
+         */
+        AMRange<T> nextFit(measure_type len, T hint) const;
+
+        /**
+         *  @brief free range of given length at start of shortest long enough free range
+         *  Lowest one of equally long free ranges is chosen. O(log n) time.
+         *  @param len length, greater than zero
+         *  @return free range, or empty range, when there is none
+         *  @throw This function will not throw an exception.
+         */
+        AMRange<T> bestFit(measure_type len) const;
+
+        /**
+         *  @brief mark range as used
+         *  Parts which are not free are ignored. O(log n) time for every overlapped free range,
+         *  allocates only when range is cut out of middle of free range.
+         *  @param rng range
+         *  @throw std::bad_alloc if allocation fails, map is not changed then.
+         */
+        void reserve(const AMRange<T> &rng);
+
+        /**
+         *  @brief mark range as free
+         *  Parts outside of space and parts which are free are ignored. O(log n) time for every touched
+         *  free range, allocates only when released range does not touch any free range.
+         *  @param rng range
+         *  @throw std::bad_alloc if allocation fails, map is not changed then.
+         */
+        void release(const AMRange<T> &rng);
+
+        /**
+         *  @brief find by firstFit() and reserve
+         *  @return reserved range, or empty range, when there is no free range
+         *  @throw This function will not throw an exception.
+         */
+        AMRange<T> reserveFirstFit(measure_type len);
+
+        /**
+         *  @brief find by firstFit() inside bound and reserve
+         *  @return reserved range, or empty range, when there is no free range
+         *  @throw std::bad_alloc if allocation fails, map is not changed then.
+         */
+        AMRange<T> reserveFirstFit(measure_type len, const AMRange<T> &bound);
+
+        /**
+         *  @brief find by nextFit() and reserve
+         *  @return reserved range, or empty range, when there is no free range
+         *  @throw std::bad_alloc if allocation fails, map is not changed then.
+         */
+        AMRange<T> reserveNextFit(measure_type len, T hint);
+
+        /**
+         *  @brief find by bestFit() and reserve
+         *  @return reserved range, or empty range, when there is no free range
+         *  @throw This function will not throw an exception.
+         */
+        AMRange<T> reserveBestFit(measure_type len);
+
+    private:
+        struct Node;
+        typedef std::unique_ptr<Node> NodePtr;
+
+        /**
+         *  @brief free range, node of both trees
+         */
+        struct Node
+        {
+            AMRange<T> range;
+            // tree ordered by address owns nodes
+            NodePtr left;
+            NodePtr right;
+            int height;
+            measure_type longest;
+            // tree ordered by length and address
+            Node *sizeLeft;
+            Node *sizeRight;
+            int sizeHeight;
+        };
+
+        static inline int height(const NodePtr &t);
+        static inline measure_type longest(const NodePtr &t);
+
+        /**
+         *  @brief node n with subtrees l and g
+         *  @throw This function will not throw an exception.
+         */
+        static NodePtr make(NodePtr l, NodePtr n, NodePtr g);
+
+        /**
+         *  @brief node n with subtrees, which differ in height by at most 2, rotated to balance
+         *  @throw This function will not throw an exception.
+         */
+        static NodePtr balance(NodePtr l, NodePtr n, NodePtr g);
+
+        /**
+         *  @brief tree of all ranges of l, n and all ranges of g
+         *  Ranges of l are below n and ranges of g are above n.
+         *  @throw This function will not throw an exception.
+         */
+        static NodePtr join(NodePtr l, NodePtr n, NodePtr g);
+
+        /**
+         *  @brief tree of all ranges of l and g, ranges of l are below g
+         *  @throw This function will not throw an exception.
+         */
+        static NodePtr join(NodePtr l, NodePtr g);
+
+        /**
+         *  @brief remove last node of nonempty tree
+         *  @return rest of tree and last node
+         *  @throw This function will not throw an exception.
+         */
+        static std::pair<NodePtr, NodePtr> splitLast(NodePtr t);
+
+        /**
+         *  @brief perfectly balanced tree of sorted free ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename RandomIt>
+        NodePtr build(RandomIt first, RandomIt last);
+
+        /**
+         *  @brief insert node to tree
+         *  @throw This function will not throw an exception.
+         */
+        static NodePtr insert(NodePtr t, NodePtr n);
+
+        /**
+         *  @brief remove node of free range starting at from and delete it
+         *  @throw This function will not throw an exception.
+         */
+        static NodePtr erase(NodePtr t, T from);
+
+        /**
+         *  @brief change free range starting at from to r, keeping its position
+         *  @return changed node
+         *  @throw This function will not throw an exception.
+         */
+        static Node *resize(Node *t, T from, const AMRange<T> &r);
+
+        /**
+         *  @brief first free range, for which predicate is false
+         *  Predicate must be true for low ranges and false for high ones.
+         *  @throw This function will not throw an exception.
+         */
+        template<typename P>
+        const Node *firstHigh(P isLow) const;
+
+        /**
+         *  @brief first free range ending after number
+         *  @throw This function will not throw an exception.
+         */
+        inline const Node *endingAfter(T num) const;
+
+        /**
+         *  @brief lowest free range of subtree with length at least len starting after number
+         *  @throw This function will not throw an exception.
+         */
+        static const Node *longEnoughAfter(const Node *t, T num, measure_type len);
+
+        /**
+         *  @brief lowest free range of subtree with length at least len
+         *  @throw This function will not throw an exception.
+         */
+        static const Node *longEnough(const Node *t, measure_type len);
+
+        /**
+         *  @brief range of given length at start of free range
+         *  @throw This function will not throw an exception.
+         */
+        static inline AMRange<T> head(T from, measure_type len);
+
+        /**
+         *  @brief test that range of given length fits between bounds
+         *  @throw This function will not throw an exception.
+         */
+        static inline bool fits(T from, T to, measure_type len);
+
+        /**
+         *  @brief add node to size tree and counters
+         *  @throw This function will not throw an exception.
+         */
+        void enroll(Node *n);
+
+        /**
+         *  @brief remove node from size tree and counters
+         *  @throw This function will not throw an exception.
+         */
+        void withdraw(const Node *n);
+
+        /**
+         *  @brief insert new free range
+         *  @throw This function will not throw an exception.
+         */
+        void insertNode(NodePtr n);
+
+        /**
+         *  @brief remove free range
+         *  @throw This function will not throw an exception.
+         */
+        void eraseNode(const Node *n);
+
+        /**
+         *  @brief change free range in place, it must stay between the same neighbours
+         *  @throw This function will not throw an exception.
+         */
+        void resizeNode(const Node *n, const AMRange<T> &r);
+
+        static inline bool sizeLess(const Node *a, const Node *b);
+        static inline int sizeHeight(const Node *t);
+        static Node *sizeRotateLeft(Node *t);
+        static Node *sizeRotateRight(Node *t);
+        static Node *sizeBalance(Node *t);
+        static Node *sizeInsert(Node *t, Node *n);
+        static Node *sizeErase(Node *t, const Node *n);
+        static Node *sizeEraseMin(Node *t, Node *&min);
+
+        AMRange<T> mSpace;
+        NodePtr mRoot;
+        Node *mSizeRoot;
+        size_type mCount;
+        measure_type mFree;
+    };
+
+
+    template<typename T>
+    AMFreeSpaceMap<T>::AMFreeSpaceMap(const AMRange<T> &space)
+        : AMFreeSpaceMap(space, AMRangeSet<T>())
+    {
+    }
+
+    template<typename T>
+    AMFreeSpaceMap<T>::AMFreeSpaceMap(const AMRange<T> &space, const AMRangeSet<T> &used)
+        : mSpace(space),
+          mSizeRoot(nullptr),
+          mCount(0),
+          mFree(0)
+    {
+        AMRangeSet<T> free = AMRangeSet<T>(space) - used;
+        mRoot = build(free.begin(), free.end());
+    }
+
+    template<typename T>
+    AMFreeSpaceMap<T>::AMFreeSpaceMap(AMFreeSpaceMap &&other) noexcept
+        : mSpace(other.mSpace),
+          mRoot(std::move(other.mRoot)),
+          mSizeRoot(other.mSizeRoot),
+          mCount(other.mCount),
+          mFree(other.mFree)
+    {
+        other.mSizeRoot = nullptr;
+        other.mCount = 0;
+        other.mFree = 0;
+    }
+
+    template<typename T>
+    AMFreeSpaceMap<T> &AMFreeSpaceMap<T>::operator=(AMFreeSpaceMap &&other) noexcept
+    {
+        mSpace = other.mSpace;
+        mRoot = std::move(other.mRoot);
+        mSizeRoot = other.mSizeRoot;
+        mCount = other.mCount;
+        mFree = other.mFree;
+        other.mSizeRoot = nullptr;
+        other.mCount = 0;
+        other.mFree = 0;
+        return *this;
+    }
+
+    template<typename T>
+    inline const AMRange<T> &AMFreeSpaceMap<T>::space() const
+    {
+        return mSpace;
+    }
+
+    template<typename T>
+    inline typename AMFreeSpaceMap<T>::size_type AMFreeSpaceMap<T>::size() const
+    {
+        return mCount;
+    }
+
+    template<typename T>
+    inline typename AMFreeSpaceMap<T>::measure_type AMFreeSpaceMap<T>::freeMeasure() const
+    {
+        return mFree;
+    }
+
+    template<typename T>
+    inline typename AMFreeSpaceMap<T>::measure_type AMFreeSpaceMap<T>::largestFree() const
+    {
+        return longest(mRoot);
+    }
+
+    template<typename T>
+    bool AMFreeSpaceMap<T>::isFree(T num) const
+    {
+        const Node *t = endingAfter(num);
+        return t && t->range.from <= num;
+    }
+
+    template<typename T>
+    bool AMFreeSpaceMap<T>::isFree(const AMRange<T> &rng) const
+    {
+        if (!rng.nonEmpty()) {
+            return true;
+        }
+        const Node *t = endingAfter(rng.from);
+        return t && t->range.from <= rng.from && t->range.to >= rng.to;
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMFreeSpaceMap<T>::freeRanges() const
+    {
+        std::vector<AMRange<T> > v;
+        v.reserve(mCount);
+        std::vector<const Node *> stack;
+        for (const Node *t = mRoot.get(); t || !stack.empty(); t = t->right.get()) {
+            for (; t; t = t->left.get()) {
+                stack.push_back(t);
+            }
+            t = stack.back();
+            stack.pop_back();
+            v.push_back(t->range);
+        }
+        return AMRangeSet<T>::fromPacked(std::move(v));
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMFreeSpaceMap<T>::usedRanges() const
+    {
+        return AMRangeSet<T>(mSpace) - freeRanges();
+    }
+
+    template<typename T>
+    AMRange<T> AMFreeSpaceMap<T>::firstFit(measure_type len) const
+    {
+        const Node *t = longEnough(mRoot.get(), len);
+        return t ? head(t->range.from, len) : AMRange<T>();
+    }
+
+    template<typename T>
+    AMRange<T> AMFreeSpaceMap<T>::firstFit(measure_type len, const AMRange<T> &bound) const
+    {
+        if (!bound.nonEmpty()) {
+            return AMRange<T>();
+        }
+        //free range containing start of bound is cut by bound, following ones are whole up to last one
+        const Node *t = endingAfter(bound.from);
+        if (!t) {
+            return AMRange<T>();
+        }
+        T from = std::max(t->range.from, bound.from);
+        if (from < bound.to && fits(from, std::min(t->range.to, bound.to), len)) {
+            return head(from, len);
+        }
+        t = longEnoughAfter(mRoot.get(), bound.from, len);
+        if (t && t->range.from < bound.to && fits(t->range.from, bound.to, len)) {
+            return head(t->range.from, len);
+        }
+        return AMRange<T>();
+    }
+
+    template<typename T>
+    AMRange<T> AMFreeSpaceMap<T>::nextFit(measure_type len, T hint) const
+    {
+        if (hint > mSpace.from && hint < mSpace.to) {
+            AMRange<T> r = firstFit(len, AMRange<T>(hint, mSpace.to));
+            if (r.nonEmpty()) {
+                return r;
+            }
+        }
+        return firstFit(len);
+    }
+
+    template<typename T>
+    AMRange<T> AMFreeSpaceMap<T>::bestFit(measure_type len) const
+    {
+        const Node *found = nullptr;
+        for (const Node *t = mSizeRoot; t;) {
+            if (AMCore::measure(t->range) >= len) {
+                found = t;
+                t = t->sizeLeft;
+            } else {
+                t = t->sizeRight;
+            }
+        }
+        return found ? head(found->range.from, len) : AMRange<T>();
+    }
+
+    template<typename T>
+    void AMFreeSpaceMap<T>::reserve(const AMRange<T> &rng)
+    {
+        if (!rng.nonEmpty()) {
+            return;
+        }
+        for (;;) {
+            const Node *t = endingAfter(rng.from);
+            if (!t || t->range.from >= rng.to) {
+                return;
+            }
+            AMRange<T> r = t->range;
+            if (r.from < rng.from && r.to > rng.to) {
+                //cut out of middle, node is allocated before anything is changed
+                NodePtr n(new Node());
+                n->range = AMRange<T>(rng.to, r.to);
+                resizeNode(t, AMRange<T>(r.from, rng.from));
+                insertNode(std::move(n));
+                return;
+            }
+            if (r.from < rng.from) {
+                resizeNode(t, AMRange<T>(r.from, rng.from));
+            } else if (r.to > rng.to) {
+                resizeNode(t, AMRange<T>(rng.to, r.to));
+                return;
+            } else {
+                eraseNode(t);
+            }
+        }
+    }
+
+    template<typename T>
+    void AMFreeSpaceMap<T>::release(const AMRange<T> &rng)
+    {
+        AMRange<T> r = intersect(rng, mSpace);
+        if (isFree(r)) {
+            return;
+        }
+        const Node *t = firstHigh([&r](const AMRange<T> &x) { return x.to < r.from; });
+        if (!t || t->range.from > r.to) {
+            NodePtr n(new Node());
+            n->range = r;
+            insertNode(std::move(n));
+            return;
+        }
+        //first touching free range takes following touching ones
+        T key = t->range.from;
+        AMRange<T> merged(std::min(key, r.from), std::max(t->range.to, r.to));
+        for (;;) {
+            const Node *next = firstHigh([key](const AMRange<T> &x) { return x.from <= key; });
+            if (!next || next->range.from > r.to) {
+                break;
+            }
+            merged.to = std::max(merged.to, next->range.to);
+            eraseNode(next);
+        }
+        resizeNode(t, merged);
+    }
+
+    template<typename T>
+    AMRange<T> AMFreeSpaceMap<T>::reserveFirstFit(measure_type len)
+    {
+        AMRange<T> r = firstFit(len);
+        reserve(r);
+        return r;
+    }
+
+    template<typename T>
+    AMRange<T> AMFreeSpaceMap<T>::reserveFirstFit(measure_type len, const AMRange<T> &bound)
+    {
+        AMRange<T> r = firstFit(len, bound);
+        reserve(r);
+        return r;
+    }
+
+    template<typename T>
+    AMRange<T> AMFreeSpaceMap<T>::reserveNextFit(measure_type len, T hint)
+    {
+        AMRange<T> r = nextFit(len, hint);
+        reserve(r);
+        return r;
+    }
+
+    template<typename T>
+    AMRange<T> AMFreeSpaceMap<T>::reserveBestFit(measure_type len)
+    {
+        AMRange<T> r = bestFit(len);
+        reserve(r);
+        return r;
+    }
+
+    template<typename T>
+    inline int AMFreeSpaceMap<T>::height(const NodePtr &t)
+    {
+        return t ? t->height : 0;
+    }
+
+    template<typename T>
+    inline typename AMFreeSpaceMap<T>::measure_type AMFreeSpaceMap<T>::longest(const NodePtr &t)
+    {
+        return t ? t->longest : measure_type(0);
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::NodePtr AMFreeSpaceMap<T>::make(NodePtr l, NodePtr n, NodePtr g)
+    {
+        n->height = 1 + std::max(height(l), height(g));
+        n->longest = std::max(AMCore::measure(n->range), std::max(longest(l), longest(g)));
+        n->left = std::move(l);
+        n->right = std::move(g);
+        return n;
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::NodePtr AMFreeSpaceMap<T>::balance(NodePtr l, NodePtr n, NodePtr g)
+    {
+        if (height(l) > height(g) + 1) {
+            NodePtr ll = std::move(l->left);
+            NodePtr lr = std::move(l->right);
+            if (height(ll) >= height(lr)) {
+                return make(std::move(ll), std::move(l), make(std::move(lr), std::move(n), std::move(g)));
+            }
+            NodePtr lrl = std::move(lr->left);
+            NodePtr lrr = std::move(lr->right);
+            return make(make(std::move(ll), std::move(l), std::move(lrl)), std::move(lr),
+                        make(std::move(lrr), std::move(n), std::move(g)));
+        }
+        if (height(g) > height(l) + 1) {
+            NodePtr gl = std::move(g->left);
+            NodePtr gr = std::move(g->right);
+            if (height(gr) >= height(gl)) {
+                return make(make(std::move(l), std::move(n), std::move(gl)), std::move(g), std::move(gr));
+            }
+            NodePtr gll = std::move(gl->left);
+            NodePtr glr = std::move(gl->right);
+            return make(make(std::move(l), std::move(n), std::move(gll)), std::move(gl),
+                        make(std::move(glr), std::move(g), std::move(gr)));
+        }
+        return make(std::move(l), std::move(n), std::move(g));
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::NodePtr AMFreeSpaceMap<T>::join(NodePtr l, NodePtr n, NodePtr g)
+    {
+        //descend along spine of higher tree to subtree of about the same height as lower one
+        if (height(l) > height(g) + 1) {
+            NodePtr ll = std::move(l->left);
+            NodePtr lr = std::move(l->right);
+            return balance(std::move(ll), std::move(l), join(std::move(lr), std::move(n), std::move(g)));
+        }
+        if (height(g) > height(l) + 1) {
+            NodePtr gl = std::move(g->left);
+            NodePtr gr = std::move(g->right);
+            return balance(join(std::move(l), std::move(n), std::move(gl)), std::move(g), std::move(gr));
+        }
+        return make(std::move(l), std::move(n), std::move(g));
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::NodePtr AMFreeSpaceMap<T>::join(NodePtr l, NodePtr g)
+    {
+        if (!l) {
+            return g;
+        }
+        if (!g) {
+            return l;
+        }
+        std::pair<NodePtr, NodePtr> p = splitLast(std::move(l));
+        return join(std::move(p.first), std::move(p.second), std::move(g));
+    }
+
+    template<typename T>
+    std::pair<typename AMFreeSpaceMap<T>::NodePtr, typename AMFreeSpaceMap<T>::NodePtr>
+    AMFreeSpaceMap<T>::splitLast(NodePtr t)
+    {
+        NodePtr l = std::move(t->left);
+        NodePtr g = std::move(t->right);
+        if (!g) {
+            return std::make_pair(std::move(l), std::move(t));
+        }
+        std::pair<NodePtr, NodePtr> p = splitLast(std::move(g));
+        return std::make_pair(join(std::move(l), std::move(t), std::move(p.first)), std::move(p.second));
+    }
+
+    template<typename T>
+    template<typename RandomIt>
+    typename AMFreeSpaceMap<T>::NodePtr AMFreeSpaceMap<T>::build(RandomIt first, RandomIt last)
+    {
+        if (first == last) {
+            return NodePtr();
+        }
+        RandomIt middle = first + (last - first) / 2;
+        NodePtr l = build(first, middle);
+        NodePtr n(new Node());
+        n->range = *middle;
+        enroll(n.get());
+        return make(std::move(l), std::move(n), build(middle + 1, last));
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::NodePtr AMFreeSpaceMap<T>::insert(NodePtr t, NodePtr n)
+    {
+        if (!t) {
+            return make(NodePtr(), std::move(n), NodePtr());
+        }
+        NodePtr l = std::move(t->left);
+        NodePtr g = std::move(t->right);
+        if (n->range.from < t->range.from) {
+            l = insert(std::move(l), std::move(n));
+        } else {
+            g = insert(std::move(g), std::move(n));
+        }
+        return balance(std::move(l), std::move(t), std::move(g));
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::NodePtr AMFreeSpaceMap<T>::erase(NodePtr t, T from)
+    {
+        NodePtr l = std::move(t->left);
+        NodePtr g = std::move(t->right);
+        if (t->range.from == from) {
+            return join(std::move(l), std::move(g));
+        }
+        if (from < t->range.from) {
+            l = erase(std::move(l), from);
+        } else {
+            g = erase(std::move(g), from);
+        }
+        return balance(std::move(l), std::move(t), std::move(g));
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::Node *AMFreeSpaceMap<T>::resize(Node *t, T from, const AMRange<T> &r)
+    {
+        Node *changed = t;
+        if (t->range.from == from) {
+            t->range = r;
+        } else {
+            changed = resize(from < t->range.from ? t->left.get() : t->right.get(), from, r);
+        }
+        t->longest = std::max(AMCore::measure(t->range), std::max(longest(t->left), longest(t->right)));
+        return changed;
+    }
+
+    template<typename T>
+    template<typename P>
+    const typename AMFreeSpaceMap<T>::Node *AMFreeSpaceMap<T>::firstHigh(P isLow) const
+    {
+        const Node *found = nullptr;
+        for (const Node *t = mRoot.get(); t;) {
+            if (!isLow(t->range)) {
+                found = t;
+                t = t->left.get();
+            } else {
+                t = t->right.get();
+            }
+        }
+        return found;
+    }
+
+    template<typename T>
+    inline const typename AMFreeSpaceMap<T>::Node *AMFreeSpaceMap<T>::endingAfter(T num) const
+    {
+        return firstHigh([num](const AMRange<T> &r) { return r.to <= num; });
+    }
+
+    template<typename T>
+    const typename AMFreeSpaceMap<T>::Node *AMFreeSpaceMap<T>::longEnoughAfter(const Node *t, T num, measure_type len)
+    {
+        //one path down to num, right subtrees above it are searched by longEnough() only when they surely succeed
+        while (t && t->longest >= len) {
+            if (t->range.from > num) {
+                if (const Node *found = longEnoughAfter(t->left.get(), num, len)) {
+                    return found;
+                }
+                if (AMCore::measure(t->range) >= len) {
+                    return t;
+                }
+                return longEnough(t->right.get(), len);
+            }
+            t = t->right.get();
+        }
+        return nullptr;
+    }
+
+    template<typename T>
+    const typename AMFreeSpaceMap<T>::Node *AMFreeSpaceMap<T>::longEnough(const Node *t, measure_type len)
+    {
+        while (t && t->longest >= len) {
+            if (longest(t->left) >= len) {
+                t = t->left.get();
+            } else if (AMCore::measure(t->range) >= len) {
+                return t;
+            } else {
+                t = t->right.get();
+            }
+        }
+        return nullptr;
+    }
+
+    template<typename T>
+    inline AMRange<T> AMFreeSpaceMap<T>::head(T from, measure_type len)
+    {
+        return AMRange<T>(from, T(from + len));
+    }
+
+    template<typename T>
+    inline bool AMFreeSpaceMap<T>::fits(T from, T to, measure_type len)
+    {
+        return AMCore::measure(AMRange<T>(from, to)) >= len;
+    }
+
+    template<typename T>
+    void AMFreeSpaceMap<T>::enroll(Node *n)
+    {
+        mSizeRoot = sizeInsert(mSizeRoot, n);
+        mCount++;
+        mFree += AMCore::measure(n->range);
+    }
+
+    template<typename T>
+    void AMFreeSpaceMap<T>::withdraw(const Node *n)
+    {
+        mSizeRoot = sizeErase(mSizeRoot, n);
+        mCount--;
+        mFree -= AMCore::measure(n->range);
+    }
+
+    template<typename T>
+    void AMFreeSpaceMap<T>::insertNode(NodePtr n)
+    {
+        enroll(n.get());
+        mRoot = insert(std::move(mRoot), std::move(n));
+    }
+
+    template<typename T>
+    void AMFreeSpaceMap<T>::eraseNode(const Node *n)
+    {
+        withdraw(n);
+        mRoot = erase(std::move(mRoot), n->range.from);
+    }
+
+    template<typename T>
+    void AMFreeSpaceMap<T>::resizeNode(const Node *n, const AMRange<T> &r)
+    {
+        withdraw(n);
+        enroll(resize(mRoot.get(), n->range.from, r));
+    }
+
+    template<typename T>
+    inline bool AMFreeSpaceMap<T>::sizeLess(const Node *a, const Node *b)
+    {
+        measure_type la = AMCore::measure(a->range);
+        measure_type lb = AMCore::measure(b->range);
+        return la < lb || (la == lb && a->range.from < b->range.from);
+    }
+
+    template<typename T>
+    inline int AMFreeSpaceMap<T>::sizeHeight(const Node *t)
+    {
+        return t ? t->sizeHeight : 0;
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::Node *AMFreeSpaceMap<T>::sizeRotateLeft(Node *t)
+    {
+        Node *r = t->sizeRight;
+        t->sizeRight = r->sizeLeft;
+        t->sizeHeight = 1 + std::max(sizeHeight(t->sizeLeft), sizeHeight(t->sizeRight));
+        r->sizeLeft = t;
+        r->sizeHeight = 1 + std::max(sizeHeight(r->sizeLeft), sizeHeight(r->sizeRight));
+        return r;
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::Node *AMFreeSpaceMap<T>::sizeRotateRight(Node *t)
+    {
+        Node *l = t->sizeLeft;
+        t->sizeLeft = l->sizeRight;
+        t->sizeHeight = 1 + std::max(sizeHeight(t->sizeLeft), sizeHeight(t->sizeRight));
+        l->sizeRight = t;
+        l->sizeHeight = 1 + std::max(sizeHeight(l->sizeLeft), sizeHeight(l->sizeRight));
+        return l;
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::Node *AMFreeSpaceMap<T>::sizeBalance(Node *t)
+    {
+        int hl = sizeHeight(t->sizeLeft);
+        int hr = sizeHeight(t->sizeRight);
+        if (hl > hr + 1) {
+            if (sizeHeight(t->sizeLeft->sizeLeft) < sizeHeight(t->sizeLeft->sizeRight)) {
+                t->sizeLeft = sizeRotateLeft(t->sizeLeft);
+            }
+            return sizeRotateRight(t);
+        }
+        if (hr > hl + 1) {
+            if (sizeHeight(t->sizeRight->sizeRight) < sizeHeight(t->sizeRight->sizeLeft)) {
+                t->sizeRight = sizeRotateRight(t->sizeRight);
+            }
+            return sizeRotateLeft(t);
+        }
+        t->sizeHeight = 1 + std::max(hl, hr);
+        return t;
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::Node *AMFreeSpaceMap<T>::sizeInsert(Node *t, Node *n)
+    {
+        if (!t) {
+            n->sizeLeft = nullptr;
+            n->sizeRight = nullptr;
+            n->sizeHeight = 1;
+            return n;
+        }
+        if (sizeLess(n, t)) {
+            t->sizeLeft = sizeInsert(t->sizeLeft, n);
+        } else {
+            t->sizeRight = sizeInsert(t->sizeRight, n);
+        }
+        return sizeBalance(t);
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::Node *AMFreeSpaceMap<T>::sizeErase(Node *t, const Node *n)
+    {
+        if (t == n) {
+            if (!t->sizeLeft) {
+                return t->sizeRight;
+            }
+            if (!t->sizeRight) {
+                return t->sizeLeft;
+            }
+            Node *min = nullptr;
+            Node *right = sizeEraseMin(t->sizeRight, min);
+            min->sizeLeft = t->sizeLeft;
+            min->sizeRight = right;
+            return sizeBalance(min);
+        }
+        if (sizeLess(n, t)) {
+            t->sizeLeft = sizeErase(t->sizeLeft, n);
+        } else {
+            t->sizeRight = sizeErase(t->sizeRight, n);
+        }
+        return sizeBalance(t);
+    }
+
+    template<typename T>
+    typename AMFreeSpaceMap<T>::Node *AMFreeSpaceMap<T>::sizeEraseMin(Node *t, Node *&min)
+    {
+        if (!t->sizeLeft) {
+            min = t;
+            return t->sizeRight;
+        }
+        t->sizeLeft = sizeEraseMin(t->sizeLeft, min);
+        return sizeBalance(t);
+    }
+}
+
+/** @} */
+
+#endif //AMCORE_AMFREESPACEMAP_H
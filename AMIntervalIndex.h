@@ -0,0 +1,363 @@
+/**
+ * @file: AMIntervalIndex.h
+ * Static interval tree over overlapping ranges
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMINTERVALINDEX_H
+#define AMCORE_AMINTERVALINDEX_H
+
+#include "AMRange.h"
+#include <vector>
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Common
+     *  @brief Static interval tree over overlapping ranges
+     *
+     *  Ranges are not packed, every range is kept with its payload. Index is built in bulk, ranges are sorted
+     *  into contiguous array which is laid out as implicit balanced binary tree (in order layout, node at
+     *  index i on level k has children at i - 2^(k-1) and i + 2^(k-1)). Every node is augmented with maximal
+     *  right bound in its subtree, so stabbing and overlap queries skip subtrees which end too early and
+     *  run in O(log n + k) time, where k is number of hits.
+     *
+     *  Empty and invalid ranges are kept, but never reported by queries.
+     */
+    template<typename T, typename Payload>
+    class AMIntervalIndex
+    {
+    public:
+        /**
+         *  @brief range with payload
+         */
+        struct Entry
+        {
+            /**
+             *  @brief range
+             */
+            AMRange<T> range;
+            /**
+             *  @brief payload
+             */
+            Payload payload;
+        };
+
+        /**
+         *  @brief iterator type
+         */
+        typedef typename std::vector<Entry>::const_iterator const_iterator;
+        /**
+         *  @brief size type
+         */
+        typedef std::size_t size_type;
+
+        /**
+         *  @brief empty constructor
+         *  @throw This function will not throw an exception.
+         */
+        AMIntervalIndex();
+
+        /**
+         *  @brief bulk build
+         *  Entries may be in any order.
+         *  @param entries ranges with payloads
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        explicit AMIntervalIndex(std::vector<Entry> entries);
+
+        /**
+         *  @brief bulk build
+         *  Replaces current content. Entries may be in any order. O(n log n) time.
+         *  @param entries ranges with payloads
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        void build(std::vector<Entry> entries);
+
+        /**
+         *  @brief entries sorted by range
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator begin() const;
+
+        /**
+         *  @brief behind last entry
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator end() const;
+
+        /**
+         *  @brief number of entries
+         *  @throw This function will not throw an exception.
+         */
+        inline size_type size() const;
+
+        /**
+         *  @brief test for empty
+         *  @throw This function will not throw an exception.
+         */
+        inline bool empty() const;
+
+        /**
+         *  @brief entry at index
+         *  Entries are sorted by range, index is position in sorted order.
+         *  @param i index, must be lower than size()
+         *  @throw This function will not throw an exception.
+         */
+        inline const Entry &operator[](size_type i) const;
+
+        /**
+         *  @brief stabbing query
+         *  Calls visitor for every entry whose range contains num, in ascending order of ranges.
+         *  @param num
+         *  @param visitor callable taking const Entry &
+         *  @throw Only what visitor throws.
+         */
+        template<typename Visitor>
+        void forEachContaining(T num, Visitor visitor) const;
+
+        /**
+         *  @brief overlap query
+         *  Calls visitor for every entry whose range has nonempty intersection with rng, in ascending order of ranges.
+         *  @param rng range
+         *  @param visitor callable taking const Entry &
+         *  @throw Only what visitor throws.
+         */
+        template<typename Visitor>
+        void forEachOverlapping(const AMRange<T> &rng, Visitor visitor) const;
+
+        /**
+         *  @brief stabbing query
+         *  @param num
+         *  @return indices of entries whose range contains num
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        std::vector<size_type> containing(T num) const;
+
+        /**
+         *  @brief overlap query
+         *  @param rng range
+         *  @return indices of entries whose range has nonempty intersection with rng
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        std::vector<size_type> overlapping(const AMRange<T> &rng) const;
+
+    private:
+        /**
+         *  @brief compute maximal right bound of every subtree
+         *  @throw This function will not throw an exception.
+         */
+        void augment();
+
+        /**
+         *  @brief walk tree and report entries overlapping &lt; from, to )
+         *  Stabbing query is overlap with &lt; num, num ], it is selected by closed flag.
+         *  @throw Only what visitor throws.
+         */
+        template<typename Visitor>
+        void query(T from, T to, bool closed, Visitor &visitor) const;
+
+        std::vector<Entry> mEntries;
+        std::vector<T> mMax;
+        int mLevels;
+    };
+
+
+    template<typename T, typename Payload>
+    AMIntervalIndex<T, Payload>::AMIntervalIndex()
+        : mEntries(),
+          mMax(),
+          mLevels(-1)
+    {
+    }
+
+    template<typename T, typename Payload>
+    AMIntervalIndex<T, Payload>::AMIntervalIndex(std::vector<Entry> entries)
+        : mEntries(),
+          mMax(),
+          mLevels(-1)
+    {
+        build(std::move(entries));
+    }
+
+    template<typename T, typename Payload>
+    void AMIntervalIndex<T, Payload>::build(std::vector<Entry> entries)
+    {
+        mEntries = std::move(entries);
+        std::stable_sort(mEntries.begin(), mEntries.end(),
+                         [](const Entry &a, const Entry &b) { return a.range < b.range; });
+        augment();
+    }
+
+    template<typename T, typename Payload>
+    inline typename AMIntervalIndex<T, Payload>::const_iterator AMIntervalIndex<T, Payload>::begin() const
+    {
+        return mEntries.begin();
+    }
+
+    template<typename T, typename Payload>
+    inline typename AMIntervalIndex<T, Payload>::const_iterator AMIntervalIndex<T, Payload>::end() const
+    {
+        return mEntries.end();
+    }
+
+    template<typename T, typename Payload>
+    inline typename AMIntervalIndex<T, Payload>::size_type AMIntervalIndex<T, Payload>::size() const
+    {
+        return mEntries.size();
+    }
+
+    template<typename T, typename Payload>
+    inline bool AMIntervalIndex<T, Payload>::empty() const
+    {
+        return mEntries.empty();
+    }
+
+    template<typename T, typename Payload>
+    inline const typename AMIntervalIndex<T, Payload>::Entry &AMIntervalIndex<T, Payload>::operator[](size_type i) const
+    {
+        return mEntries[i];
+    }
+
+    template<typename T, typename Payload>
+    void AMIntervalIndex<T, Payload>::augment()
+    {
+        size_type n = mEntries.size();
+        mMax.resize(n);
+        mLevels = -1;
+        if (n == 0) {
+            return;
+        }
+        // leaves are at even indices
+        size_type lastIndex = 0;
+        T last = T();
+        for (size_type i = 0; i < n; i += 2) {
+            lastIndex = i;
+            last = mMax[i] = mEntries[i].range.to;
+        }
+        int k = 1;
+        for (; (size_type(1) << k) <= n; k++) {
+            size_type x = size_type(1) << (k - 1);
+            size_type i0 = (x << 1) - 1;
+            size_type step = x << 2;
+            for (size_type i = i0; i < n; i += step) {
+                // right child may be missing when tree is not complete, last is maximum of rightmost existing subtree
+                T el = mMax[i - x];
+                T er = i + x < n ? mMax[i + x] : last;
+                T e = mEntries[i].range.to;
+                if (el > e) {
+                    e = el;
+                }
+                if (er > e) {
+                    e = er;
+                }
+                mMax[i] = e;
+            }
+            lastIndex = (lastIndex >> k & 1) ? lastIndex - x : lastIndex + x;
+            if (lastIndex < n && mMax[lastIndex] > last) {
+                last = mMax[lastIndex];
+            }
+        }
+        mLevels = k - 1;
+    }
+
+    template<typename T, typename Payload>
+    template<typename Visitor>
+    void AMIntervalIndex<T, Payload>::query(T from, T to, bool closed, Visitor &visitor) const
+    {
+        struct Node
+        {
+            size_type x;
+            int k;
+            bool visited;
+        };
+        if (mLevels < 0) {
+            return;
+        }
+        size_type n = mEntries.size();
+        Node stack[128];
+        int t = 0;
+        stack[t++] = Node{(size_type(1) << mLevels) - 1, mLevels, false};
+        while (t > 0) {
+            Node z = stack[--t];
+            if (z.k <= 3) {
+                // small subtree, scan it linearly
+                size_type i0 = z.x >> z.k << z.k;
+                size_type i1 = i0 + (size_type(1) << (z.k + 1)) - 1;
+                if (i1 > n) {
+                    i1 = n;
+                }
+                for (size_type i = i0; i < i1; i++) {
+                    const AMRange<T> &r = mEntries[i].range;
+                    if (closed ? r.from > from : r.from >= to) {
+                        break;
+                    }
+                    if (r.to > from && r.from < r.to) {
+                        visitor(mEntries[i]);
+                    }
+                }
+            } else if (!z.visited) {
+                // go left first, skip left subtree when it ends too early
+                size_type y = z.x - (size_type(1) << (z.k - 1));
+                stack[t++] = Node{z.x, z.k, true};
+                if (y >= n || mMax[y] > from) {
+                    stack[t++] = Node{y, z.k - 1, false};
+                }
+            } else if (z.x < n) {
+                const AMRange<T> &r = mEntries[z.x].range;
+                if (closed ? r.from <= from : r.from < to) {
+                    if (r.to > from && r.from < r.to) {
+                        visitor(mEntries[z.x]);
+                    }
+                    stack[t++] = Node{z.x + (size_type(1) << (z.k - 1)), z.k - 1, false};
+                }
+            }
+        }
+    }
+
+    template<typename T, typename Payload>
+    template<typename Visitor>
+    void AMIntervalIndex<T, Payload>::forEachContaining(T num, Visitor visitor) const
+    {
+        query(num, num, true, visitor);
+    }
+
+    template<typename T, typename Payload>
+    template<typename Visitor>
+    void AMIntervalIndex<T, Payload>::forEachOverlapping(const AMRange<T> &rng, Visitor visitor) const
+    {
+        if (!rng.nonEmpty()) {
+            return;
+        }
+        query(rng.from, rng.to, false, visitor);
+    }
+
+    template<typename T, typename Payload>
+    std::vector<typename AMIntervalIndex<T, Payload>::size_type> AMIntervalIndex<T, Payload>::containing(T num) const
+    {
+        std::vector<size_type> result;
+        const Entry *first = mEntries.data();
+        forEachContaining(num, [&result, first](const Entry &e) { result.push_back(&e - first); });
+        return result;
+    }
+
+    template<typename T, typename Payload>
+    std::vector<typename AMIntervalIndex<T, Payload>::size_type>
+    AMIntervalIndex<T, Payload>::overlapping(const AMRange<T> &rng) const
+    {
+        std::vector<size_type> result;
+        const Entry *first = mEntries.data();
+        forEachOverlapping(rng, [&result, first](const Entry &e) { result.push_back(&e - first); });
+        return result;
+    }
+}
+
+/** @} */
+
+#endif //AMCORE_AMINTERVALINDEX_H
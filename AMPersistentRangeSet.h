@@ -0,0 +1,920 @@
+/**
+ * @file: AMPersistentRangeSet.h
+ * Persistent set of ranges, versions share unchanged nodes
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMPERSISTENTRANGESET_H
+#define AMCORE_AMPERSISTENTRANGESET_H
+
+#include "AMRangeSet.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <iterator>
+#include <initializer_list>
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Common
+     *  @brief Persistent set of ranges, versions share unchanged nodes
+     *
+     *  Packed ranges are stored in balanced binary tree (AVL) of immutable nodes owned by shared pointers.
+     *  Operation with range does not change any node, it splits tree at both ends of range and joins parts
+     *  back with merged or cut ranges, so only O(log n) nodes on paths are created and everything else
+     *  is shared with previous version. Copy of set shares whole tree, e.q. O(1) time, and every version
+     *  stays valid as long as any copy holds it, so thousands of snapshots take O(log n) memory each.
+     *
+     *  Nodes are never changed after construction, so versions can be read from many threads at once.
+     *  Single set object is not synchronized, like std::shared_ptr.
+     *
+     *  Nodes keep count and total length of their subtree, so size() and measure() take O(1) time.
+     */
+    template<typename T>
+    class AMPersistentRangeSet
+    {
+        struct Node;
+        typedef std::shared_ptr<const Node> NodePtr;
+
+    public:
+        /**
+         *  @brief value type
+         */
+        typedef AMRange<T> value_type;
+        /**
+         *  @brief size type
+         */
+        typedef std::size_t size_type;
+        /**
+         *  @brief type of total length of ranges
+         */
+        typedef AMRangeMeasure<T> measure_type;
+
+        /**
+         *  @brief iterator over ranges in ascending order
+         *  Iterator is valid as long as version, it was taken from, is held by any set.
+         */
+        class const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef AMRange<T> value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const value_type *pointer;
+            typedef const value_type &reference;
+
+            /**
+             *  @brief end iterator
+             *  @throw This function will not throw an exception.
+             */
+            const_iterator();
+
+            /**
+             *  @brief current range
+             *  @throw This function will not throw an exception.
+             */
+            inline reference operator*() const;
+
+            /**
+             *  @brief current range
+             *  @throw This function will not throw an exception.
+             */
+            inline pointer operator->() const;
+
+            /**
+             *  @brief next range
+             *  @throw std::bad_alloc if allocation fails.
+             */
+            inline const_iterator &operator++();
+
+            /**
+             *  @brief next range
+             *  @throw std::bad_alloc if allocation fails.
+             */
+            inline const_iterator operator++(int);
+
+            /**
+             *  @brief comparison operator
+             *  Iterators are equal when they are at the same node.
+             *  @throw This function will not throw an exception.
+             */
+            inline bool operator==(const const_iterator &right) const;
+
+            /**
+             *  @brief comparison operator
+             *  @throw This function will not throw an exception.
+             */
+            inline bool operator!=(const const_iterator &right) const;
+
+        private:
+            friend class AMPersistentRangeSet;
+
+            /**
+             *  @brief push node and its left descendants
+             *  @throw std::bad_alloc if allocation fails.
+             */
+            void pushLeft(const Node *node);
+
+            // current node on top, below it ancestors, which are not visited yet
+            std::vector<const Node *> mStack;
+        };
+
+        /**
+         *  @brief empty constructor
+         *  @throw This function will not throw an exception.
+         */
+        AMPersistentRangeSet();
+
+        /**
+         *  @brief constructor
+         *  @param r range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMPersistentRangeSet(const AMRange<T> &r);
+
+        /**
+         *  @brief constructor
+         *  @param l list of ranges in any order
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMPersistentRangeSet(std::initializer_list<AMRange<T> > l);
+
+        /**
+         *  @brief constructor
+         *  Tree is built from packed ranges at once, e.q. O(n) time.
+         *  @param s set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        explicit AMPersistentRangeSet(const AMRangeSet<T> &s);
+
+        /**
+         *  @brief constructor
+         *  @param s std::set of ranges, needs not be packed
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        explicit AMPersistentRangeSet(const AMRangeStdSet<T> &s);
+
+        /**
+         *  @brief constructor
+         *  @param first first range in any order
+         *  @param last end of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename InputIt>
+        AMPersistentRangeSet(InputIt first, InputIt last);
+
+        /**
+         *  @brief first range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        const_iterator begin() const;
+
+        /**
+         *  @brief end of ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator end() const;
+
+        /**
+         *  @brief number of ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline size_type size() const;
+
+        /**
+         *  @brief test that set is empty
+         *  @throw This function will not throw an exception.
+         */
+        inline bool empty() const;
+
+        /**
+         *  @brief total length of ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline measure_type measure() const;
+
+        /**
+         *  @brief height of tree
+         *  Height is at most 1.44 log2(n + 2).
+         *  @throw This function will not throw an exception.
+         */
+        inline int height() const;
+
+        /**
+         *  @brief remove all ranges
+         *  Other versions are not affected.
+         *  @throw This function will not throw an exception.
+         */
+        inline void clear();
+
+        /**
+         *  @brief range containing number
+         *  Tree search, e.q. O(log n) time.
+         *  @param num
+         *  @return iterator to range or end()
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        const_iterator find(T num) const;
+
+        /**
+         *  @brief test that number is in set
+         *  Tree search, e.q. O(log n) time.
+         *  @param num
+         *  @throw This function will not throw an exception.
+         */
+        bool contains(T num) const;
+
+        /**
+         *  @brief test that range is fully covered
+         *  Tree search, e.q. O(log n) time.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool covers(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief test that range has nonempty intersection with set
+         *  Tree search, e.q. O(log n) time.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool overlaps(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief comparison operator
+         *  Versions sharing whole tree are equal in O(1) time.
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        bool operator==(const AMPersistentRangeSet &right) const;
+
+        /**
+         *  @brief comparison operator
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        inline bool operator!=(const AMPersistentRangeSet &right) const;
+
+        /**
+         *  @brief conversion to flat set
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet<T> toRangeSet() const;
+
+        /**
+         *  @brief conversion to std::set
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeStdSet<T> toSet() const;
+
+        /**
+         *  @brief plus operator
+         *  Adds range, creates O(log n) nodes, previous version is not changed.
+         *  @param right range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMPersistentRangeSet &operator+=(const AMRange<T> &right);
+
+        /**
+         *  @brief minus operator
+         *  Subtracts range, creates O(log n) nodes, previous version is not changed.
+         *  @param right range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMPersistentRangeSet &operator-=(const AMRange<T> &right);
+
+        /**
+         *  @brief plus operator
+         *  Adds ranges one by one, e.q. O(m log n) time. Empty set takes whole tree of right one.
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMPersistentRangeSet &operator+=(const AMPersistentRangeSet &right);
+
+        /**
+         *  @brief minus operator
+         *  Subtracts ranges one by one, e.q. O(m log n) time.
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMPersistentRangeSet &operator-=(const AMPersistentRangeSet &right);
+
+    private:
+        /**
+         *  @brief immutable node of tree
+         */
+        struct Node
+        {
+            Node(const NodePtr &l, const AMRange<T> &r, const NodePtr &g)
+                : range(r),
+                  left(l),
+                  right(g),
+                  height(1 + std::max(AMPersistentRangeSet::height(l), AMPersistentRangeSet::height(g))),
+                  size(1 + AMPersistentRangeSet::size(l) + AMPersistentRangeSet::size(g)),
+                  measure(AMCore::measure(r) + AMPersistentRangeSet::measure(l) + AMPersistentRangeSet::measure(g))
+            {
+            }
+
+            AMRange<T> range;
+            NodePtr left;
+            NodePtr right;
+            int height;
+            size_type size;
+            measure_type measure;
+        };
+
+        explicit AMPersistentRangeSet(NodePtr root);
+
+        static inline int height(const NodePtr &t);
+        static inline size_type size(const NodePtr &t);
+        static inline measure_type measure(const NodePtr &t);
+
+        /**
+         *  @brief new node
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static inline NodePtr make(const NodePtr &l, const AMRange<T> &r, const NodePtr &g);
+
+        /**
+         *  @brief new node with subtrees, which differ in height by at most 2, rotated to balance
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static NodePtr balance(const NodePtr &l, const AMRange<T> &r, const NodePtr &g);
+
+        /**
+         *  @brief tree of all ranges of l, r and all ranges of g
+         *  Ranges of l are below r and ranges of g are above r. Nodes on one spine are created,
+         *  e.q. O(|height(l) - height(g)|) time.
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static NodePtr join(const NodePtr &l, const AMRange<T> &r, const NodePtr &g);
+
+        /**
+         *  @brief tree of all ranges of l and g, ranges of l are below g
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static NodePtr join(const NodePtr &l, const NodePtr &g);
+
+        /**
+         *  @brief split tree to ranges, which satisfy predicate, and the rest
+         *  Predicate must be true for low ranges and false for high ones, e.q. O(log n) time.
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename P>
+        static std::pair<NodePtr, NodePtr> split(const NodePtr &t, P isLow);
+
+        /**
+         *  @brief remove last range of nonempty tree
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static std::pair<NodePtr, AMRange<T> > splitLast(const NodePtr &t);
+
+        /**
+         *  @brief perfectly balanced tree of sorted packed ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename RandomIt>
+        static NodePtr build(RandomIt first, RandomIt last);
+
+        static inline const AMRange<T> &first(const Node *t);
+        static inline const AMRange<T> &last(const Node *t);
+
+        /**
+         *  @brief first range ending after number
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        const_iterator endingAfter(T num) const;
+
+        /**
+         *  @brief first range ending after number, without iterator
+         *  @throw This function will not throw an exception.
+         */
+        const AMRange<T> *nodeEndingAfter(T num) const;
+
+        NodePtr mRoot;
+    };
+
+    /**
+     *  @brief plus operator
+     *  @param left set of ranges, it is not changed
+     *  @param right range
+     *  @return new version sharing unchanged nodes with left one
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T>
+    AMPersistentRangeSet<T> operator+(const AMPersistentRangeSet<T> &left, const AMRange<T> &right);
+
+    /**
+     *  @brief minus operator
+     *  @param left set of ranges, it is not changed
+     *  @param right range
+     *  @return new version sharing unchanged nodes with left one
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T>
+    AMPersistentRangeSet<T> operator-(const AMPersistentRangeSet<T> &left, const AMRange<T> &right);
+
+    /**
+     *  @brief plus operator
+     *  @param left set of ranges, it is not changed
+     *  @param right set of ranges
+     *  @return new version sharing unchanged nodes with left one
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T>
+    AMPersistentRangeSet<T> operator+(const AMPersistentRangeSet<T> &left, const AMPersistentRangeSet<T> &right);
+
+    /**
+     *  @brief minus operator
+     *  @param left set of ranges, it is not changed
+     *  @param right set of ranges
+     *  @return new version sharing unchanged nodes with left one
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T>
+    AMPersistentRangeSet<T> operator-(const AMPersistentRangeSet<T> &left, const AMPersistentRangeSet<T> &right);
+
+
+    template<typename T>
+    AMPersistentRangeSet<T>::const_iterator::const_iterator()
+    {
+    }
+
+    template<typename T>
+    inline typename AMPersistentRangeSet<T>::const_iterator::reference
+    AMPersistentRangeSet<T>::const_iterator::operator*() const
+    {
+        return mStack.back()->range;
+    }
+
+    template<typename T>
+    inline typename AMPersistentRangeSet<T>::const_iterator::pointer
+    AMPersistentRangeSet<T>::const_iterator::operator->() const
+    {
+        return &mStack.back()->range;
+    }
+
+    template<typename T>
+    inline typename AMPersistentRangeSet<T>::const_iterator &AMPersistentRangeSet<T>::const_iterator::operator++()
+    {
+        const Node *node = mStack.back();
+        mStack.pop_back();
+        pushLeft(node->right.get());
+        return *this;
+    }
+
+    template<typename T>
+    inline typename AMPersistentRangeSet<T>::const_iterator AMPersistentRangeSet<T>::const_iterator::operator++(int)
+    {
+        const_iterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    template<typename T>
+    inline bool AMPersistentRangeSet<T>::const_iterator::operator==(const const_iterator &right) const
+    {
+        if (mStack.empty() || right.mStack.empty()) {
+            return mStack.empty() == right.mStack.empty();
+        }
+        return mStack.back() == right.mStack.back();
+    }
+
+    template<typename T>
+    inline bool AMPersistentRangeSet<T>::const_iterator::operator!=(const const_iterator &right) const
+    {
+        return !(*this == right);
+    }
+
+    template<typename T>
+    void AMPersistentRangeSet<T>::const_iterator::pushLeft(const Node *node)
+    {
+        for (; node; node = node->left.get()) {
+            mStack.push_back(node);
+        }
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T>::AMPersistentRangeSet()
+    {
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T>::AMPersistentRangeSet(NodePtr root)
+        : mRoot(std::move(root))
+    {
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T>::AMPersistentRangeSet(const AMRange<T> &r)
+    {
+        *this += r;
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T>::AMPersistentRangeSet(std::initializer_list<AMRange<T> > l)
+        : AMPersistentRangeSet(l.begin(), l.end())
+    {
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T>::AMPersistentRangeSet(const AMRangeSet<T> &s)
+        : mRoot(build(s.begin(), s.end()))
+    {
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T>::AMPersistentRangeSet(const AMRangeStdSet<T> &s)
+        : AMPersistentRangeSet(AMRangeSet<T>(s))
+    {
+    }
+
+    template<typename T>
+    template<typename InputIt>
+    AMPersistentRangeSet<T>::AMPersistentRangeSet(InputIt first, InputIt last)
+        : AMPersistentRangeSet(AMRangeSet<T>::fromUnsorted(first, last))
+    {
+    }
+
+    template<typename T>
+    typename AMPersistentRangeSet<T>::const_iterator AMPersistentRangeSet<T>::begin() const
+    {
+        const_iterator it;
+        it.pushLeft(mRoot.get());
+        return it;
+    }
+
+    template<typename T>
+    inline typename AMPersistentRangeSet<T>::const_iterator AMPersistentRangeSet<T>::end() const
+    {
+        return const_iterator();
+    }
+
+    template<typename T>
+    inline typename AMPersistentRangeSet<T>::size_type AMPersistentRangeSet<T>::size() const
+    {
+        return size(mRoot);
+    }
+
+    template<typename T>
+    inline bool AMPersistentRangeSet<T>::empty() const
+    {
+        return !mRoot;
+    }
+
+    template<typename T>
+    inline typename AMPersistentRangeSet<T>::measure_type AMPersistentRangeSet<T>::measure() const
+    {
+        return measure(mRoot);
+    }
+
+    template<typename T>
+    inline int AMPersistentRangeSet<T>::height() const
+    {
+        return height(mRoot);
+    }
+
+    template<typename T>
+    inline void AMPersistentRangeSet<T>::clear()
+    {
+        mRoot.reset();
+    }
+
+    template<typename T>
+    typename AMPersistentRangeSet<T>::const_iterator AMPersistentRangeSet<T>::find(T num) const
+    {
+        const_iterator it = endingAfter(num);
+        if (it != end() && it->from <= num) {
+            return it;
+        }
+        return end();
+    }
+
+    template<typename T>
+    bool AMPersistentRangeSet<T>::contains(T num) const
+    {
+        const AMRange<T> *r = nodeEndingAfter(num);
+        return r && r->from <= num;
+    }
+
+    template<typename T>
+    bool AMPersistentRangeSet<T>::covers(const AMRange<T> &rng) const
+    {
+        if (!rng.nonEmpty()) {
+            return true;
+        }
+        const AMRange<T> *r = nodeEndingAfter(rng.from);
+        return r && r->from <= rng.from && r->to >= rng.to;
+    }
+
+    template<typename T>
+    bool AMPersistentRangeSet<T>::overlaps(const AMRange<T> &rng) const
+    {
+        if (!rng.nonEmpty()) {
+            return false;
+        }
+        const AMRange<T> *r = nodeEndingAfter(rng.from);
+        return r && r->from < rng.to;
+    }
+
+    template<typename T>
+    bool AMPersistentRangeSet<T>::operator==(const AMPersistentRangeSet &right) const
+    {
+        if (mRoot == right.mRoot) {
+            return true;
+        }
+        if (size() != right.size() || measure() != right.measure()) {
+            return false;
+        }
+        return std::equal(begin(), end(), right.begin());
+    }
+
+    template<typename T>
+    inline bool AMPersistentRangeSet<T>::operator!=(const AMPersistentRangeSet &right) const
+    {
+        return !(*this == right);
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMPersistentRangeSet<T>::toRangeSet() const
+    {
+        std::vector<AMRange<T> > v;
+        v.reserve(size());
+        v.assign(begin(), end());
+        return AMRangeSet<T>::fromPacked(std::move(v));
+    }
+
+    template<typename T>
+    AMRangeStdSet<T> AMPersistentRangeSet<T>::toSet() const
+    {
+        return AMRangeStdSet<T>(begin(), end());
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T> &AMPersistentRangeSet<T>::operator+=(const AMRange<T> &right)
+    {
+        if (covers(right)) {
+            return *this;
+        }
+        //ranges touching added range are merged with it
+        std::pair<NodePtr, NodePtr> low = split(mRoot, [&right](const AMRange<T> &r) { return r.to < right.from; });
+        std::pair<NodePtr, NodePtr> mid = split(low.second, [&right](const AMRange<T> &r) { return r.from <= right.to; });
+        AMRange<T> merged = right;
+        if (mid.first) {
+            merged.from = std::min(first(mid.first.get()).from, right.from);
+            merged.to = std::max(last(mid.first.get()).to, right.to);
+        }
+        mRoot = join(low.first, merged, mid.second);
+        return *this;
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T> &AMPersistentRangeSet<T>::operator-=(const AMRange<T> &right)
+    {
+        if (!overlaps(right)) {
+            return *this;
+        }
+        std::pair<NodePtr, NodePtr> low = split(mRoot, [&right](const AMRange<T> &r) { return r.to <= right.from; });
+        std::pair<NodePtr, NodePtr> mid = split(low.second, [&right](const AMRange<T> &r) { return r.from < right.to; });
+        //only first and last overlapped range can stick out
+        NodePtr t = low.first;
+        const AMRange<T> &lo = first(mid.first.get());
+        if (lo.from < right.from) {
+            t = join(t, AMRange<T>(lo.from, right.from), NodePtr());
+        }
+        const AMRange<T> &hi = last(mid.first.get());
+        if (hi.to > right.to) {
+            mRoot = join(t, AMRange<T>(right.to, hi.to), mid.second);
+        } else {
+            mRoot = join(t, mid.second);
+        }
+        return *this;
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T> &AMPersistentRangeSet<T>::operator+=(const AMPersistentRangeSet &right)
+    {
+        if (empty()) {
+            mRoot = right.mRoot;
+            return *this;
+        }
+        for (const AMRange<T> &r : right) {
+            *this += r;
+        }
+        return *this;
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T> &AMPersistentRangeSet<T>::operator-=(const AMPersistentRangeSet &right)
+    {
+        if (mRoot == right.mRoot) {
+            clear();
+            return *this;
+        }
+        for (const AMRange<T> &r : right) {
+            *this -= r;
+        }
+        return *this;
+    }
+
+    template<typename T>
+    inline int AMPersistentRangeSet<T>::height(const NodePtr &t)
+    {
+        return t ? t->height : 0;
+    }
+
+    template<typename T>
+    inline typename AMPersistentRangeSet<T>::size_type AMPersistentRangeSet<T>::size(const NodePtr &t)
+    {
+        return t ? t->size : 0;
+    }
+
+    template<typename T>
+    inline typename AMPersistentRangeSet<T>::measure_type AMPersistentRangeSet<T>::measure(const NodePtr &t)
+    {
+        return t ? t->measure : measure_type(0);
+    }
+
+    template<typename T>
+    inline typename AMPersistentRangeSet<T>::NodePtr
+    AMPersistentRangeSet<T>::make(const NodePtr &l, const AMRange<T> &r, const NodePtr &g)
+    {
+        return std::make_shared<Node>(l, r, g);
+    }
+
+    template<typename T>
+    typename AMPersistentRangeSet<T>::NodePtr
+    AMPersistentRangeSet<T>::balance(const NodePtr &l, const AMRange<T> &r, const NodePtr &g)
+    {
+        if (height(l) > height(g) + 1) {
+            if (height(l->left) >= height(l->right)) {
+                return make(l->left, l->range, make(l->right, r, g));
+            }
+            const NodePtr &lr = l->right;
+            return make(make(l->left, l->range, lr->left), lr->range, make(lr->right, r, g));
+        }
+        if (height(g) > height(l) + 1) {
+            if (height(g->right) >= height(g->left)) {
+                return make(make(l, r, g->left), g->range, g->right);
+            }
+            const NodePtr &gl = g->left;
+            return make(make(l, r, gl->left), gl->range, make(gl->right, g->range, g->right));
+        }
+        return make(l, r, g);
+    }
+
+    template<typename T>
+    typename AMPersistentRangeSet<T>::NodePtr
+    AMPersistentRangeSet<T>::join(const NodePtr &l, const AMRange<T> &r, const NodePtr &g)
+    {
+        //descend along spine of higher tree to subtree of about the same height as lower one,
+        //joined subtree is at most one higher than replaced one
+        if (height(l) > height(g) + 1) {
+            return balance(l->left, l->range, join(l->right, r, g));
+        }
+        if (height(g) > height(l) + 1) {
+            return balance(join(l, r, g->left), g->range, g->right);
+        }
+        return make(l, r, g);
+    }
+
+    template<typename T>
+    typename AMPersistentRangeSet<T>::NodePtr AMPersistentRangeSet<T>::join(const NodePtr &l, const NodePtr &g)
+    {
+        if (!l) {
+            return g;
+        }
+        if (!g) {
+            return l;
+        }
+        std::pair<NodePtr, AMRange<T> > p = splitLast(l);
+        return join(p.first, p.second, g);
+    }
+
+    template<typename T>
+    template<typename P>
+    std::pair<typename AMPersistentRangeSet<T>::NodePtr, typename AMPersistentRangeSet<T>::NodePtr>
+    AMPersistentRangeSet<T>::split(const NodePtr &t, P isLow)
+    {
+        if (!t) {
+            return std::pair<NodePtr, NodePtr>();
+        }
+        if (isLow(t->range)) {
+            std::pair<NodePtr, NodePtr> p = split(t->right, isLow);
+            return std::make_pair(join(t->left, t->range, p.first), std::move(p.second));
+        }
+        std::pair<NodePtr, NodePtr> p = split(t->left, isLow);
+        return std::make_pair(std::move(p.first), join(p.second, t->range, t->right));
+    }
+
+    template<typename T>
+    std::pair<typename AMPersistentRangeSet<T>::NodePtr, AMRange<T> >
+    AMPersistentRangeSet<T>::splitLast(const NodePtr &t)
+    {
+        if (!t->right) {
+            return std::make_pair(t->left, t->range);
+        }
+        std::pair<NodePtr, AMRange<T> > p = splitLast(t->right);
+        return std::make_pair(join(t->left, t->range, p.first), p.second);
+    }
+
+    template<typename T>
+    template<typename RandomIt>
+    typename AMPersistentRangeSet<T>::NodePtr AMPersistentRangeSet<T>::build(RandomIt first, RandomIt last)
+    {
+        if (first == last) {
+            return NodePtr();
+        }
+        RandomIt middle = first + (last - first) / 2;
+        return make(build(first, middle), *middle, build(middle + 1, last));
+    }
+
+    template<typename T>
+    inline const AMRange<T> &AMPersistentRangeSet<T>::first(const Node *t)
+    {
+        while (t->left) {
+            t = t->left.get();
+        }
+        return t->range;
+    }
+
+    template<typename T>
+    inline const AMRange<T> &AMPersistentRangeSet<T>::last(const Node *t)
+    {
+        while (t->right) {
+            t = t->right.get();
+        }
+        return t->range;
+    }
+
+    template<typename T>
+    typename AMPersistentRangeSet<T>::const_iterator AMPersistentRangeSet<T>::endingAfter(T num) const
+    {
+        const_iterator it;
+        for (const Node *t = mRoot.get(); t;) {
+            if (t->range.to > num) {
+                it.mStack.push_back(t);
+                t = t->left.get();
+            } else {
+                t = t->right.get();
+            }
+        }
+        return it;
+    }
+
+    template<typename T>
+    const AMRange<T> *AMPersistentRangeSet<T>::nodeEndingAfter(T num) const
+    {
+        const AMRange<T> *found = nullptr;
+        for (const Node *t = mRoot.get(); t;) {
+            if (t->range.to > num) {
+                found = &t->range;
+                t = t->left.get();
+            } else {
+                t = t->right.get();
+            }
+        }
+        return found;
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T> operator+(const AMPersistentRangeSet<T> &left, const AMRange<T> &right)
+    {
+        AMPersistentRangeSet<T> s = left;
+        s += right;
+        return s;
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T> operator-(const AMPersistentRangeSet<T> &left, const AMRange<T> &right)
+    {
+        AMPersistentRangeSet<T> s = left;
+        s -= right;
+        return s;
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T> operator+(const AMPersistentRangeSet<T> &left, const AMPersistentRangeSet<T> &right)
+    {
+        AMPersistentRangeSet<T> s = left;
+        s += right;
+        return s;
+    }
+
+    template<typename T>
+    AMPersistentRangeSet<T> operator-(const AMPersistentRangeSet<T> &left, const AMPersistentRangeSet<T> &right)
+    {
+        AMPersistentRangeSet<T> s = left;
+        s -= right;
+        return s;
+    }
+}
+
+/** @} */
+
+#endif //AMCORE_AMPERSISTENTRANGESET_H
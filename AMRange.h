@@ -9,7 +9,18 @@
 #define AMCORE_AMRANGE_H
 
 #include <set>
+#include <memory>
+#include <vector>
 #include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+/**
+ *  @brief minimal number of ranges with integral bounds sorted by radix sort, fewer ranges are sorted by std::sort
+ */
+#ifndef AMRANGE_RADIX_SORT_THRESHOLD
+#define AMRANGE_RADIX_SORT_THRESHOLD 1024
+#endif
 
 /**
  *  @ingroup Common
@@ -34,6 +45,11 @@ namespace AMCore {
     class AMRange
     {
     public:
+        /**
+         *  @brief bound type
+         */
+        typedef T value_type;
+
         /**
          *  @brief left bound
          */
@@ -48,7 +64,7 @@ namespace AMCore {
          *  Uses T() for init bounds.
          *  @throw This function will not throw an exception.
          */
-        AMRange();
+        constexpr AMRange() noexcept;
 
         /**
          *  @brief empty constructor
@@ -57,7 +73,7 @@ namespace AMCore {
          *  @param _to bound
          *  @throw This function will not throw an exception.
          */
-        AMRange(T _from, T _to);
+        constexpr AMRange(T _from, T _to) noexcept;
 
         /**
          *  @brief less operator
@@ -65,7 +81,7 @@ namespace AMCore {
          *  @param right operand
          *  @throw This function will not throw an exception.
          */
-        inline bool operator<(const AMRange &right) const;
+        constexpr bool operator<(const AMRange &right) const noexcept;
 
         /**
          *  @brief minus operator
@@ -75,7 +91,7 @@ namespace AMCore {
          *  @param right operand
          *  @throw This function will not throw an exception.
          */
-        inline AMRange &operator-=(const AMRange &right);
+        constexpr AMRange &operator-=(const AMRange &right) noexcept;
 
         /**
          *  @brief plus operator
@@ -85,7 +101,7 @@ namespace AMCore {
          *  @param right operand
          *  @throw This function will not throw an exception.
          */
-        inline AMRange &operator+=(const AMRange &right);
+        constexpr AMRange &operator+=(const AMRange &right) noexcept;
 
         /**
          *  @brief comparison operator
@@ -93,7 +109,7 @@ namespace AMCore {
          *  @param right operand
          *  @throw This function will not throw an exception.
          */
-        inline bool operator==(const AMRange &right) const;
+        constexpr bool operator==(const AMRange &right) const noexcept;
 
         /**
          *  @brief comparison operator
@@ -101,7 +117,7 @@ namespace AMCore {
          *  @param right operand
          *  @throw This function will not throw an exception.
          */
-        inline bool operator!=(const AMRange &right) const;
+        constexpr bool operator!=(const AMRange &right) const noexcept;
 
         /**
          *  @brief intersect
@@ -110,21 +126,21 @@ namespace AMCore {
          *  @param right operand
          *  @throw This function will not throw an exception.
          */
-        inline AMRange &intersect(const AMRange &right);
+        constexpr AMRange &intersect(const AMRange &right) noexcept;
 
         /**
          *  @brief test for validity
          *  Simply checks that from bound >= to bound
          *  @throw This function will not throw an exception.
          */
-        inline bool valid() const;
+        constexpr bool valid() const noexcept;
 
         /**
          *  @brief test for validity and empty
          *  Simply checks that from bound > to bound
          *  @throw This function will not throw an exception.
          */
-        inline bool nonEmpty() const;
+        constexpr bool nonEmpty() const noexcept;
 
         /**
          *  @brief check that number is inside
@@ -132,7 +148,7 @@ namespace AMCore {
          *  @param num
          *  @throw This function will not throw an exception.
          */
-        inline bool in(T num) const;
+        constexpr bool in(T num) const noexcept;
 
         /**
          *  @brief check that number is inside
@@ -140,14 +156,14 @@ namespace AMCore {
          *  @param rng
          *  @throw This function will not throw an exception.
          */
-        inline bool in(const AMRange &rng) const;
+        constexpr bool in(const AMRange &rng) const noexcept;
 
         /**
          *  @brief test for empty
          *  Simply checks that from bound == to bound
          *  @throw This function will not throw an exception.
          */
-        inline bool empty() const;
+        constexpr bool empty() const noexcept;
     };
 
     /**
@@ -159,7 +175,7 @@ namespace AMCore {
      *  @throw This function will not throw an exception.
      */
     template<typename T>
-    inline AMRange<T> intersect(const AMRange<T> &left, const AMRange<T> &right);
+    constexpr AMRange<T> intersect(const AMRange<T> &left, const AMRange<T> &right) noexcept;
     /**
      *  @brief plus operator
      *  Cut part of range by intersect with right operand.
@@ -170,7 +186,7 @@ namespace AMCore {
      *  @throw This function will not throw an exception.
      */
     template<typename T>
-    inline AMRange<T> operator+(const AMRange<T> &left, const AMRange<T> &right);
+    constexpr AMRange<T> operator+(const AMRange<T> &left, const AMRange<T> &right) noexcept;
     /**
      *  @brief minus operator
      *  Cut part of range by intersect with right operand.
@@ -181,7 +197,46 @@ namespace AMCore {
      *  @throw This function will not throw an exception.
      */
     template<typename T>
-    inline AMRange<T> operator-(const AMRange<T> &left, const AMRange<T> &right);
+    constexpr AMRange<T> operator-(const AMRange<T> &left, const AMRange<T> &right) noexcept;
+
+    /**
+     *  @brief set of ranges
+     *  Operations below accept std::set of ranges with any allocator, e.q. std::pmr::set&lt;AMRange&lt;T&gt; &gt;
+     *  backed by monotonic arena. Result and temporary sets are allocated by allocator of left operand
+     *  (or of the set operand, when other operand is range), so they never fall back to global heap.
+     */
+    template<typename T, typename Alloc = std::allocator<AMRange<T> > >
+    using AMRangeStdSet = std::set<AMRange<T>, std::less<AMRange<T> >, Alloc>;
+
+    /**
+     *  @brief type of measure (total length) of ranges
+     *  Unsigned type of the same size for integral bounds, total length of packed set always fits into it
+     *  and it is exact even when it is updated by wrapping additions and subtractions. Bound type itself
+     *  for floating point bounds.
+     */
+    template<typename T>
+    using AMRangeMeasure = typename std::conditional<std::is_integral<T>::value, std::make_unsigned<T>,
+                                                     std::enable_if<true, T> >::type::type;
+
+    /**
+     *  @brief statistics of packed set of ranges
+     */
+    template<typename T>
+    struct AMRangeStats
+    {
+        /**
+         *  @brief number of ranges
+         */
+        std::size_t count;
+        /**
+         *  @brief total length of ranges
+         */
+        AMRangeMeasure<T> measure;
+        /**
+         *  @brief length of longest gap between two ranges, zero for less than two ranges
+         */
+        AMRangeMeasure<T> largestGap;
+    };
 
     /**
      *  @brief packed test
@@ -191,16 +246,16 @@ namespace AMCore {
      *  @param s set of ranges
      *  @throw This function will not throw an exception.
      */
-    template<typename T>
-    bool isPacked(const std::set<AMRange<T> > &s);
+    template<typename T, typename Alloc>
+    bool isPacked(const AMRangeStdSet<T, Alloc> &s);
     /**
      *  @brief valid test
      *  Set of ranges is valid when all range in are valid
      *  @param s set of ranges
      *  @throw This function will not throw an exception.
      */
-    template<typename T>
-    bool valid(const std::set<AMRange<T> > &s);
+    template<typename T, typename Alloc>
+    bool valid(const AMRangeStdSet<T, Alloc> &s);
     /**
      *  @brief pack a set of ranges
      *  Set of ranges is packed when, ranges has not intersections. E.q. Second range starts above first range end,
@@ -209,9 +264,119 @@ namespace AMCore {
      *  @param s set of ranges
      *  @throw This function will not throw an exception.
      */
-    template<typename T>
-    std::set<AMRange<T> > pack(const std::set<AMRange<T> > &s);
-    template<typename T>
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> pack(const AMRangeStdSet<T, Alloc> &s);
+    /**
+     *  @brief LSD radix sort of ranges with integral bounds
+     *  Stable sort by bytes of right bound and then by bytes of left bound, e.q. in O(n * sizeof(T)) time.
+     *  Histograms of all bytes are counted in one pass, passes over bytes equal for all ranges are skipped.
+     *  Sorted copy of ranges and one buffer of the same size are allocated.
+     *  @param first begin of ranges
+     *  @param last end of ranges
+     *  @param fromOnly sort by left bound only, order of ranges with equal left bound is kept, it is enough for packing
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename RandomIt>
+    void radixSortRanges(RandomIt first, RandomIt last, bool fromOnly = false);
+    /**
+     *  @brief LSD radix sort of ranges with integral bounds
+     *  The same as radixSortRanges above, copy of ranges and buffer are allocated by alloc.
+     *  @param first begin of ranges
+     *  @param last end of ranges
+     *  @param fromOnly sort by left bound only
+     *  @param alloc allocator, rebound to range type
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename RandomIt, typename Alloc>
+    void radixSortRanges(RandomIt first, RandomIt last, bool fromOnly, const Alloc &alloc);
+    /**
+     *  @brief sort ranges
+     *  Ranges are sorted in ascending order (as by operator&lt;). Radix sort is used for integral bounds
+     *  and at least AMRANGE_RADIX_SORT_THRESHOLD ranges, std::sort otherwise.
+     *  @param first begin of ranges
+     *  @param last end of ranges
+     *  @param fromOnly sort by left bound only, order of ranges with equal left bound is unspecified
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename RandomIt>
+    void sortRanges(RandomIt first, RandomIt last, bool fromOnly = false);
+    /**
+     *  @brief sort ranges
+     *  The same as sortRanges above, temporary arrays of radix sort are allocated by alloc.
+     *  @param first begin of ranges
+     *  @param last end of ranges
+     *  @param fromOnly sort by left bound only
+     *  @param alloc allocator, rebound to range type
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename RandomIt, typename Alloc>
+    void sortRanges(RandomIt first, RandomIt last, bool fromOnly, const Alloc &alloc);
+    /**
+     *  @brief sort and pack ranges in place
+     *  Ranges in any order are sorted by sortRanges and then packed in single linear pass,
+     *  invalid and empty ranges are dropped.
+     *  @param first begin of ranges
+     *  @param last end of ranges
+     *  @return end of packed ranges, ranges behind it have unspecified values
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename RandomIt>
+    RandomIt sortAndPack(RandomIt first, RandomIt last);
+    /**
+     *  @brief sort and pack ranges in place
+     *  The same as sortAndPack above, temporary arrays of sort are allocated by alloc.
+     *  @param first begin of ranges
+     *  @param last end of ranges
+     *  @param alloc allocator, rebound to range type
+     *  @return end of packed ranges, ranges behind it have unspecified values
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename RandomIt, typename Alloc>
+    RandomIt sortAndPack(RandomIt first, RandomIt last, const Alloc &alloc);
+    /**
+     *  @brief sort and pack vector of ranges in place
+     *  Ranges behind packed ones are erased, temporary arrays of sort are allocated by allocator of v.
+     *  @param v ranges in any order
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    void sortAndPack(std::vector<AMRange<T>, Alloc> &v);
+    /**
+     *  @brief packed set of ranges from ranges in any order
+     *  Ranges are sorted and packed in contiguous storage, set is built by appending at its end,
+     *  so there are no tree insertions with searching, and no unpacked set is built.
+     *  @param first begin of ranges
+     *  @param last end of ranges
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename InputIt>
+    std::set<typename std::iterator_traits<InputIt>::value_type> packUnsorted(InputIt first, InputIt last);
+    /**
+     *  @brief packed set of ranges from ranges in any order
+     *  The same as packUnsorted above, result set and temporary array are allocated by alloc.
+     *  @param first begin of ranges
+     *  @param last end of ranges
+     *  @param alloc allocator
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename InputIt, typename Alloc>
+    AMRangeStdSet<typename std::iterator_traits<InputIt>::value_type::value_type, Alloc>
+    packUnsorted(InputIt first, InputIt last, const Alloc &alloc);
+    /**
+     *  @brief union of two sorted sequences of ranges
+     *  Sequences must be sorted in ascending order (as in std::set), ranges need not to be packed.
+     *  Invalid and empty ranges are skipped.
+     *  Result is written packed in ascending order in single pass, e.q. in O(n + m) time.
+     *  @param first1 begin of first sequence
+     *  @param last1 end of first sequence
+     *  @param first2 begin of second sequence
+     *  @param last2 end of second sequence
+     *  @param out output iterator
+     *  @return output iterator behind last written range
+     *  @throw This function will not throw an exception, unless output iterator throws.
+     */
+    template<typename InputIt1, typename InputIt2, typename OutputIt>
+    OutputIt unite(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out);
     /**
      *  @brief plus operator
      *  Adds two set of ranges.
@@ -221,7 +386,33 @@ namespace AMCore {
      *  @param right set of ranges
      *  @throw This function will not throw an exception.
      */
-    std::set<AMRange<T> > operator+(const std::set<AMRange<T> > &left, const std::set<AMRange<T> > &right);
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator+(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right);
+    /**
+     *  @brief difference of two sorted sequences of ranges
+     *  Sequences must be sorted in ascending order (as in std::set), ranges need not to be packed.
+     *  Invalid and empty ranges are skipped.
+     *  Result is written packed in ascending order in single pass, e.q. in O(n + m) time.
+     *  @param first1 begin of sequence to subtract from
+     *  @param last1 end of sequence to subtract from
+     *  @param first2 begin of subtracted sequence
+     *  @param last2 end of subtracted sequence
+     *  @param out output iterator
+     *  @return output iterator behind last written range
+     *  @throw This function will not throw an exception, unless output iterator throws.
+     */
+    template<typename InputIt1, typename InputIt2, typename OutputIt>
+    OutputIt subtract(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out);
+    /**
+     *  @brief difference
+     *  Subtracts two set of ranges, sets are not packed before.
+     *  Result set of ranges is packed.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> subtract(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right);
     /**
      *  @brief minus operator
      *  Subtracts two set of ranges.
@@ -231,8 +422,8 @@ namespace AMCore {
      *  @param right set of ranges
      *  @throw This function will not throw an exception.
      */
-    template<typename T>
-    std::set<AMRange<T> > operator-(const std::set<AMRange<T> > &left, const std::set<AMRange<T> > &right);
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator-(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right);
     /**
      *  @brief plus operator
      *  Adds range and  set of ranges.
@@ -242,8 +433,8 @@ namespace AMCore {
      *  @param right set of ranges
      *  @throw This function will not throw an exception.
      */
-    template<typename T>
-    std::set<AMRange<T> > operator+(const AMRange<T> &left, const std::set<AMRange<T> > &right);
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator+(const AMRange<T> &left, const AMRangeStdSet<T, Alloc> &right);
     /**
      *  @brief minus operator
      *  Subtracts range and  set of ranges.
@@ -253,8 +444,8 @@ namespace AMCore {
      *  @param right set of ranges
      *  @throw This function will not throw an exception.
      */
-    template<typename T>
-    std::set<AMRange<T> > operator-(const AMRange<T> &left, const std::set<AMRange<T> > &right);
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator-(const AMRange<T> &left, const AMRangeStdSet<T, Alloc> &right);
     /**
      *  @brief plus operator
      *  Adds set of ranges and range
@@ -264,8 +455,8 @@ namespace AMCore {
      *  @param right range
      *  @throw This function will not throw an exception.
      */
-    template<typename T>
-    std::set<AMRange<T> > operator+(const std::set<AMRange<T> > &left, const AMRange<T> &right);
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator+(const AMRangeStdSet<T, Alloc> &left, const AMRange<T> &right);
     /**
      *  @brief minus operator
      *  Subtracts set of ranges and range
@@ -275,26 +466,309 @@ namespace AMCore {
      *  @param right range
      *  @throw This function will not throw an exception.
      */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator-(const AMRangeStdSet<T, Alloc> &left, const AMRange<T> &right);
+    /**
+     *  @brief intersection of two sorted sequences of ranges
+     *  Sequences must be packed and sorted in ascending order (as in std::set).
+     *  Result is written packed in ascending order in single pass, e.q. in O(n + m) time.
+     *  @param first1 begin of first sequence
+     *  @param last1 end of first sequence
+     *  @param first2 begin of second sequence
+     *  @param last2 end of second sequence
+     *  @param out output iterator
+     *  @return output iterator behind last written range
+     *  @throw This function will not throw an exception, unless output iterator throws.
+     */
+    template<typename InputIt1, typename InputIt2, typename OutputIt>
+    OutputIt intersect(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out);
+    /**
+     *  @brief intersect
+     *  Intersection of two sets of ranges.
+     *  Sets of ranges must be valid.
+     *  Result set of ranges is packed.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> intersect(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right);
+    /**
+     *  @brief and operator
+     *  Intersection of two sets of ranges.
+     *  Sets of ranges must be valid.
+     *  Result set of ranges is packed.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator&(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right);
+    /**
+     *  @brief and operator
+     *  Intersection of range and set of ranges.
+     *  Set of range must be valid.
+     *  Result set of ranges is packed.
+     *  @param left range
+     *  @param right set of ranges
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator&(const AMRange<T> &left, const AMRangeStdSet<T, Alloc> &right);
+    /**
+     *  @brief and operator
+     *  Intersection of set of ranges and range.
+     *  Set of range must be valid.
+     *  Result set of ranges is packed.
+     *  @param left set of ranges
+     *  @param right range
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator&(const AMRangeStdSet<T, Alloc> &left, const AMRange<T> &right);
+    /**
+     *  @brief symmetric difference of two sorted sequences of ranges
+     *  Sequences must be packed and sorted in ascending order (as in std::set).
+     *  Result is written packed in ascending order in single pass, e.q. in O(n + m) time.
+     *  @param first1 begin of first sequence
+     *  @param last1 end of first sequence
+     *  @param first2 begin of second sequence
+     *  @param last2 end of second sequence
+     *  @param out output iterator
+     *  @return output iterator behind last written range
+     *  @throw This function will not throw an exception, unless output iterator throws.
+     */
+    template<typename InputIt1, typename InputIt2, typename OutputIt>
+    OutputIt symmetricDifference(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out);
+    /**
+     *  @brief symmetric difference
+     *  Ranges covered by exactly one of two sets of ranges.
+     *  Sets of ranges must be valid.
+     *  Result set of ranges is packed.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> symmetricDifference(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right);
+    /**
+     *  @brief xor operator
+     *  Symmetric difference of two sets of ranges.
+     *  Sets of ranges must be valid.
+     *  Result set of ranges is packed.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator^(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right);
+    /**
+     *  @brief complement of sorted sequence of ranges within universe
+     *  Gaps between ranges, clipped to universe range.
+     *  Sequence must be packed and sorted in ascending order (as in std::set).
+     *  Result is written packed in ascending order in single pass, e.q. in O(n) time.
+     *  @param first begin of sequence
+     *  @param last end of sequence
+     *  @param universe bounding range
+     *  @param out output iterator
+     *  @return output iterator behind last written range
+     *  @throw This function will not throw an exception, unless output iterator throws.
+     */
+    template<typename InputIt, typename OutputIt>
+    OutputIt complement(InputIt first, InputIt last, const typename std::iterator_traits<InputIt>::value_type &universe,
+                        OutputIt out);
+    /**
+     *  @brief complement
+     *  Gaps of set of ranges inside universe, e.q. universe - s
+     *  Set of ranges must be valid.
+     *  Result set of ranges is packed.
+     *  @param s set of ranges
+     *  @param universe bounding range
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> complement(const AMRangeStdSet<T, Alloc> &s, const AMRange<T> &universe);
+    /**
+     *  @brief plus operator
+     *  Adds range to set of ranges in place.
+     *  Only ranges overlapping or touching added range are touched, e.q. O(log n + k) time.
+     *  Set of ranges must be packed, it stays packed.
+     *  @param left set of ranges
+     *  @param right range
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> &operator+=(AMRangeStdSet<T, Alloc> &left, const AMRange<T> &right);
+    /**
+     *  @brief minus operator
+     *  Subtracts range from set of ranges in place.
+     *  Only ranges overlapping subtracted range are touched, e.q. O(log n + k) time.
+     *  Set of ranges must be packed, it stays packed.
+     *  @param left set of ranges
+     *  @param right range
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> &operator-=(AMRangeStdSet<T, Alloc> &left, const AMRange<T> &right);
+    /**
+     *  @brief and operator
+     *  Intersects set of ranges with range in place.
+     *  Ranges outside are erased, boundary ranges are clipped, e.q. O(log n + k) time.
+     *  Set of ranges must be packed, it stays packed.
+     *  @param left set of ranges
+     *  @param right range
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> &operator&=(AMRangeStdSet<T, Alloc> &left, const AMRange<T> &right);
+    /**
+     *  @brief plus operator
+     *  Adds set of ranges in place, range by range.
+     *  Left set of ranges must be packed, it stays packed. Right set of ranges must be valid.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> &operator+=(AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right);
+    /**
+     *  @brief minus operator
+     *  Subtracts set of ranges in place, range by range.
+     *  Left set of ranges must be packed, it stays packed. Right set of ranges must be valid.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> &operator-=(AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right);
+    /**
+     *  @brief and operator
+     *  Intersects set of ranges with another set of ranges.
+     *  Sets of ranges must be valid. Result set of ranges is packed.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> &operator&=(AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right);
+    /**
+     *  @brief find range containing number
+     *  Binary search, e.q. O(log n) time.
+     *  Set of ranges must be packed.
+     *  @param s set of ranges
+     *  @param num
+     *  @return iterator to range containing num or s.end()
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    typename AMRangeStdSet<T, Alloc>::const_iterator find(const AMRangeStdSet<T, Alloc> &s,
+                                                        const typename AMRange<T>::value_type &num);
+    /**
+     *  @brief test that range is fully covered by set of ranges
+     *  Empty range is always covered. Binary search, e.q. O(log n) time.
+     *  Set of ranges must be packed.
+     *  @param s set of ranges
+     *  @param rng range
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    bool covers(const AMRangeStdSet<T, Alloc> &s, const AMRange<T> &rng);
+    /**
+     *  @brief test that range has nonempty intersection with set of ranges
+     *  Binary search, e.q. O(log n) time.
+     *  Set of ranges must be packed.
+     *  @param s set of ranges
+     *  @param rng range
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    bool overlaps(const AMRangeStdSet<T, Alloc> &s, const AMRange<T> &rng);
+    /**
+     *  @brief ranges having nonempty intersection with range
+     *  Binary search, e.q. O(log n) time, hits are iterated by returned iterators.
+     *  Set of ranges must be packed.
+     *  @param s set of ranges
+     *  @param rng range
+     *  @return first and behind last overlapping range
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    std::pair<typename AMRangeStdSet<T, Alloc>::const_iterator, typename AMRangeStdSet<T, Alloc>::const_iterator>
+    overlapping(const AMRangeStdSet<T, Alloc> &s, const AMRange<T> &rng);
+    /**
+     *  @brief length of range
+     *  Empty and invalid range has zero length.
+     *  @param r range
+     *  @throw This function will not throw an exception.
+     */
     template<typename T>
-    std::set<AMRange<T> > operator-(const std::set<AMRange<T> > &left, const AMRange<T> &right);
+    constexpr AMRangeMeasure<T> measure(const AMRange<T> &r) noexcept;
+    /**
+     *  @brief statistics of sorted sequence of ranges
+     *  Number of ranges, total length and longest gap in single pass, e.q. O(n) time.
+     *  Sequence must be packed and sorted in ascending order (as in std::set).
+     *  @param first begin of sequence
+     *  @param last end of sequence
+     *  @throw This function will not throw an exception.
+     */
+    template<typename InputIt>
+    AMRangeStats<typename std::iterator_traits<InputIt>::value_type::value_type> stats(InputIt first, InputIt last);
+    /**
+     *  @brief statistics of set of ranges
+     *  Set of ranges must be valid, unpacked set is packed first.
+     *  @param s set of ranges
+     *  @throw std::bad_alloc if set is not packed and allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeStats<T> stats(const AMRangeStdSet<T, Alloc> &s);
+    /**
+     *  @brief total length of set of ranges
+     *  O(n) time. Set of ranges must be valid, unpacked set is packed first.
+     *  @param s set of ranges
+     *  @throw std::bad_alloc if set is not packed and allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeMeasure<T> measure(const AMRangeStdSet<T, Alloc> &s);
+    /**
+     *  @brief total length of intersection of two sorted sequences of ranges
+     *  Same as measure of intersect() result, but nothing is written, e.q. O(n + m) time without allocation.
+     *  Sequences must be packed and sorted in ascending order (as in std::set).
+     *  @param first1 begin of first sequence
+     *  @param last1 end of first sequence
+     *  @param first2 begin of second sequence
+     *  @param last2 end of second sequence
+     *  @throw This function will not throw an exception.
+     */
+    template<typename InputIt1, typename InputIt2>
+    AMRangeMeasure<typename std::iterator_traits<InputIt1>::value_type::value_type>
+    overlapMeasure(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2);
+    /**
+     *  @brief total length of intersection of two sets of ranges
+     *  Same as measure of left & right. Sets of ranges must be valid, unpacked sets are packed first.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw std::bad_alloc if a set is not packed and allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeMeasure<T> overlapMeasure(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right);
 
 
     template<typename T>
-    AMRange<T>::AMRange()
+    constexpr AMRange<T>::AMRange() noexcept
         : from(),
           to()
     {
     };
 
     template<typename T>
-    AMRange<T>::AMRange(T _from, T _to)
+    constexpr AMRange<T>::AMRange(T _from, T _to) noexcept
         : from(_from),
           to(_to)
     {
     };
 
     template<typename T>
-    inline bool AMRange<T>::operator<(const AMRange<T> &right) const
+    constexpr bool AMRange<T>::operator<(const AMRange<T> &right) const noexcept
     {
         if (from < right.from)  {
             return true;
@@ -305,7 +779,7 @@ namespace AMCore {
     }
 
     template<typename T>
-    inline AMRange<T> &AMRange<T>::operator-=(const AMRange<T> &right)
+    constexpr AMRange<T> &AMRange<T>::operator-=(const AMRange<T> &right) noexcept
     {
         if (!valid()) {
             return *this;
@@ -334,7 +808,7 @@ namespace AMCore {
     }
 
     template<typename T>
-    inline AMRange<T> &AMRange<T>::intersect(const AMRange<T> &right)
+    constexpr AMRange<T> &AMRange<T>::intersect(const AMRange<T> &right) noexcept
     {
         if (from < right.from) {
             from = right.from;
@@ -349,7 +823,7 @@ namespace AMCore {
     }
 
     template<typename T>
-    inline AMRange<T> &AMRange<T>::operator+=(const AMRange<T> &right)
+    constexpr AMRange<T> &AMRange<T>::operator+=(const AMRange<T> &right) noexcept
     {
         if (!valid()) {
             return *this;
@@ -380,50 +854,50 @@ namespace AMCore {
     }
 
     template<typename T>
-    inline bool AMRange<T>::operator==(const AMRange<T> &right) const
+    constexpr bool AMRange<T>::operator==(const AMRange<T> &right) const noexcept
     {
         return (from == right.from && to == right.to);
     }
 
     template<typename T>
-    inline bool AMRange<T>::operator!=(const AMRange<T> &right) const
+    constexpr bool AMRange<T>::operator!=(const AMRange<T> &right) const noexcept
     {
         return (from != right.from || to != right.to);
     }
 
 
     template<typename T>
-    inline bool AMRange<T>::valid() const
+    constexpr bool AMRange<T>::valid() const noexcept
     {
         return (to >= from);
     }
 
     template<typename T>
-    inline bool AMRange<T>::in(T num) const
+    constexpr bool AMRange<T>::in(T num) const noexcept
     {
         return ((num >= from) && (num < to));
     }
 
     template<typename T>
-    inline bool AMRange<T>::empty() const
+    constexpr bool AMRange<T>::empty() const noexcept
     {
         return to == from;
     }
 
     template<typename T>
-    inline bool AMRange<T>::nonEmpty() const
+    constexpr bool AMRange<T>::nonEmpty() const noexcept
     {
         return to > from;
     }
 
     template<typename T>
-    inline bool AMRange<T>::in(const AMRange<T> &_rng) const
+    constexpr bool AMRange<T>::in(const AMRange<T> &_rng) const noexcept
     {
         return ((_rng.from >= from) && (_rng.to <= to) && (_rng.from < _rng.to));
     }
 
     template<typename T>
-    inline AMRange<T> operator+(const AMRange<T> &left, const AMRange<T> &right)
+    constexpr AMRange<T> operator+(const AMRange<T> &left, const AMRange<T> &right) noexcept
     {
         AMRange<T> r = left;
         r += right;
@@ -431,7 +905,7 @@ namespace AMCore {
     }
 
     template<typename T>
-    inline AMRange<T> operator-(const AMRange<T> &left, const AMRange<T> &right)
+    constexpr AMRange<T> operator-(const AMRange<T> &left, const AMRange<T> &right) noexcept
     {
         AMRange<T> r = left;
         r -= right;
@@ -439,21 +913,21 @@ namespace AMCore {
     }
 
     template<typename T>
-    inline AMRange<T> intersect(const AMRange<T> &left, const AMRange<T> &right)
+    constexpr AMRange<T> intersect(const AMRange<T> &left, const AMRange<T> &right) noexcept
     {
         AMRange<T> r = left;
         r.intersect(right);
         return r;
     }
 
-    template<typename T>
-    bool isPacked(const std::set<AMRange<T> > &s)
+    template<typename T, typename Alloc>
+    bool isPacked(const AMRangeStdSet<T, Alloc> &s)
     {
-        typename std::set<AMRange<T> >::iterator it = s.begin();
+        typename AMRangeStdSet<T, Alloc>::iterator it = s.begin();
         if (it == s.end()) {
             return true;
         }
-        typename std::set<AMRange<T> >::iterator itn = it;
+        typename AMRangeStdSet<T, Alloc>::iterator itn = it;
         if (!itn->valid()) {
             return false;
         }
@@ -472,10 +946,10 @@ namespace AMCore {
         return true;
     }
 
-    template<typename T>
-    bool valid(const std::set<AMRange<T> > &s)
+    template<typename T, typename Alloc>
+    bool valid(const AMRangeStdSet<T, Alloc> &s)
     {
-        for(typename std::set<AMRange<T> >::iterator it = s.begin(); it != s.end(); it++) {
+        for(typename AMRangeStdSet<T, Alloc>::iterator it = s.begin(); it != s.end(); it++) {
             if (!it->valid()) {
                 return false;
             }
@@ -483,13 +957,13 @@ namespace AMCore {
         return true;
     }
 
-    template<typename T>
-    std::set<AMRange<T> > pack(const std::set<AMRange<T> > &s)
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> pack(const AMRangeStdSet<T, Alloc> &s)
     {
         AMRange<T> r;
-        std::set<AMRange<T> > result;
+        AMRangeStdSet<T, Alloc> result(s.get_allocator());
         bool start = true;
-        typename std::set<AMRange<T> >::iterator it = s.begin();
+        typename AMRangeStdSet<T, Alloc>::iterator it = s.begin();
 
         do {
             do {
@@ -521,106 +995,687 @@ namespace AMCore {
         } while(1);
     }
 
-    template<typename T>
-    std::set<AMRange<T> > operator+(const std::set<AMRange<T> > &left, const std::set<AMRange<T> > &right)
+    template<typename RandomIt>
+    void radixSortRanges(RandomIt first, RandomIt last, bool fromOnly)
+    {
+        radixSortRanges(first, last, fromOnly, std::allocator<typename std::iterator_traits<RandomIt>::value_type>());
+    }
+
+    template<typename RandomIt, typename Alloc>
+    void radixSortRanges(RandomIt first, RandomIt last, bool fromOnly, const Alloc &alloc)
+    {
+        typedef typename std::iterator_traits<RandomIt>::value_type Range;
+        typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Range> RangeAlloc;
+        typedef typename Range::value_type T;
+        typedef typename std::make_unsigned<T>::type U;
+        static_assert(std::is_integral<T>::value, "radix sort needs integral bounds");
+        const int bytes = sizeof(T);
+        // signed bounds are ordered as unsigned with flipped sign bit
+        const U flip = std::is_signed<T>::value ? U(U(1) << (bytes * 8 - 1)) : U(0);
+        std::size_t n = last - first;
+        if (n < 2) {
+            return;
+        }
+        std::vector<Range, RangeAlloc> a(first, last, RangeAlloc(alloc));
+        std::vector<Range, RangeAlloc> b(n, Range(), RangeAlloc(alloc));
+        // counts[0 .. bytes) are bytes of right bound, counts[bytes .. 2 * bytes) bytes of left bound
+        std::size_t counts[2 * sizeof(T)][256] = {};
+        for (const Range &r : a) {
+            U from = U(r.from) ^ flip;
+            U to = U(r.to) ^ flip;
+            for (int k = 0; k < bytes; k++) {
+                counts[k][(to >> (k * 8)) & 0xff]++;
+                counts[bytes + k][(from >> (k * 8)) & 0xff]++;
+            }
+        }
+        Range *src = a.data();
+        Range *dst = b.data();
+        for (int pass = fromOnly ? bytes : 0; pass < 2 * bytes; pass++) {
+            int shift = (pass % bytes) * 8;
+            bool left = pass >= bytes;
+            std::size_t *count = counts[pass];
+            U digit = (U(left ? src[0].from : src[0].to) ^ flip) >> shift & 0xff;
+            if (count[digit] == n) {
+                continue;
+            }
+            std::size_t offset = 0;
+            for (int d = 0; d < 256; d++) {
+                std::size_t c = count[d];
+                count[d] = offset;
+                offset += c;
+            }
+            for (std::size_t i = 0; i < n; i++) {
+                U key = U(left ? src[i].from : src[i].to) ^ flip;
+                dst[count[(key >> shift) & 0xff]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+        std::copy(src, src + n, first);
+    }
+
+    template<typename RandomIt>
+    void sortRanges(RandomIt first, RandomIt last, bool fromOnly)
+    {
+        sortRanges(first, last, fromOnly, std::allocator<typename std::iterator_traits<RandomIt>::value_type>());
+    }
+
+    template<typename RandomIt, typename Alloc>
+    void sortRanges(RandomIt first, RandomIt last, bool fromOnly, const Alloc &alloc)
+    {
+        typedef typename std::iterator_traits<RandomIt>::value_type::value_type T;
+        if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value) {
+            if (last - first >= AMRANGE_RADIX_SORT_THRESHOLD) {
+                radixSortRanges(first, last, fromOnly, alloc);
+                return;
+            }
+        }
+        std::sort(first, last);
+    }
+
+    template<typename RandomIt>
+    RandomIt sortAndPack(RandomIt first, RandomIt last)
+    {
+        return sortAndPack(first, last, std::allocator<typename std::iterator_traits<RandomIt>::value_type>());
+    }
+
+    template<typename RandomIt, typename Alloc>
+    RandomIt sortAndPack(RandomIt first, RandomIt last, const Alloc &alloc)
+    {
+        // packing merges ranges starting at the same number, order of right bounds does not matter
+        sortRanges(first, last, true, alloc);
+        RandomIt out = first;
+        bool start = true;
+        for (RandomIt it = first; it != last; it++) {
+            if (!it->nonEmpty()) {
+                continue;
+            }
+            if (start) {
+                *out = *it;
+                start = false;
+            } else if (it->from > out->to) {
+                out++;
+                *out = *it;
+            } else if (it->to > out->to) {
+                out->to = it->to;
+            }
+        }
+        return start ? first : out + 1;
+    }
+
+    template<typename T, typename Alloc>
+    void sortAndPack(std::vector<AMRange<T>, Alloc> &v)
     {
-        std::set<AMRange<T> > result = left;
-        std::merge(left.begin(), left.end(),
-            right.begin(), right.end(),
-            std::inserter(result, result.begin()));
-        result = pack(result);
+        v.erase(sortAndPack(v.begin(), v.end(), v.get_allocator()), v.end());
+    }
+
+    template<typename InputIt>
+    std::set<typename std::iterator_traits<InputIt>::value_type> packUnsorted(InputIt first, InputIt last)
+    {
+        return packUnsorted(first, last, std::allocator<typename std::iterator_traits<InputIt>::value_type>());
+    }
+
+    template<typename InputIt, typename Alloc>
+    AMRangeStdSet<typename std::iterator_traits<InputIt>::value_type::value_type, Alloc>
+    packUnsorted(InputIt first, InputIt last, const Alloc &alloc)
+    {
+        typedef typename std::iterator_traits<InputIt>::value_type Range;
+        std::vector<Range, Alloc> v(first, last, alloc);
+        AMRangeStdSet<typename Range::value_type, Alloc> result(alloc);
+        std::copy(v.begin(), sortAndPack(v.begin(), v.end(), alloc), std::inserter(result, result.end()));
         return result;
     }
 
-    template<typename T>
-    std::set<AMRange<T> > operator-(const std::set<AMRange<T> > &left, const std::set<AMRange<T> > &right)
+    template<typename InputIt1, typename InputIt2, typename OutputIt>
+    OutputIt unite(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out)
     {
-        if (left.size() == 0) {
-            return std::set<AMRange<T> >();
+        typedef typename std::iterator_traits<InputIt1>::value_type Range;
+        Range r;
+        bool start = true;
+        while (first1 != last1 || first2 != last2) {
+            Range next;
+            if (first2 == last2 || (first1 != last1 && *first1 < *first2)) {
+                next = *first1;
+                first1++;
+            } else {
+                next = *first2;
+                first2++;
+            }
+            if (!next.nonEmpty()) {
+                continue;
+            }
+            if (start) {
+                r = next;
+                start = false;
+            } else if (next.from > r.to) {
+                *out = r;
+                out++;
+                r = next;
+            } else if (next.to > r.to) {
+                r.to = next.to;
+            }
         }
-        if (right.size() == 0) {
-            return left;
+        if (!start) {
+            *out = r;
+            out++;
         }
-        std::set<AMRange<T> > ls = pack(left);
-        std::set<AMRange<T> > rs = pack(right);
-        std::set<AMRange<T> > result;
-        typename std::set<AMRange<T> >::iterator lit = ls.begin();
-        typename std::set<AMRange<T> >::iterator rit = rs.begin();
-        AMRange<int> r = *lit;
-        while (1) {
-            if (lit != ls.end()) {
-                if (rit != rs.end()) {
-                    AMRange<T> tr = r - *rit;
-                    if (!tr.valid()) {
-                        AMRange ir(r.from, rit->from);
-                        if (ir.nonEmpty()) {
-                            result.insert(ir);
-                        }
-                        r.from = rit->to;
-                    } else {
-                        r = tr;
-                    }
-                    if (lit->to > rit->to) {
-                        rit++;
-                    } else {
-                        lit++;
-                        if (lit != ls.end()) {
-                            if (r.nonEmpty()) {
-                                result.insert(r);
-                            }
-                            r = *lit;
-                        }
+        return out;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator+(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        AMRangeStdSet<T, Alloc> result(left.get_allocator());
+        unite(left.begin(), left.end(), right.begin(), right.end(), std::inserter(result, result.end()));
+        return result;
+    }
+
+    template<typename InputIt1, typename InputIt2, typename OutputIt>
+    OutputIt subtract(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out)
+    {
+        typedef typename std::iterator_traits<InputIt1>::value_type Range;
+        while (first1 != last1) {
+            Range l = *first1;
+            first1++;
+            if (!l.nonEmpty()) {
+                continue;
+            }
+            // ranges of first sequence which overlap or touch are merged, so pieces are packed
+            while (first1 != last1 && first1->from <= l.to) {
+                if (first1->to > l.to) {
+                    l.to = first1->to;
+                }
+                first1++;
+            }
+            // subtracted ranges are sorted by left bound, cursor moves to the highest right bound seen
+            typename Range::value_type from = l.from;
+            while (first2 != last2 && first2->from < l.to) {
+                if (first2->nonEmpty() && first2->to > from) {
+                    if (first2->from > from) {
+                        *out = Range(from, first2->from);
+                        out++;
                     }
-                } else {
-                    lit++;
-                    if (lit != ls.end()) {
-                        if (r.nonEmpty()) {
-                            result.insert(r);
-                        }
-                        r = *lit;
+                    from = first2->to;
+                    if (from >= l.to) {
+                        // range may reach to next range of first sequence
+                        break;
                     }
                 }
+                first2++;
+            }
+            if (from < l.to) {
+                *out = Range(from, l.to);
+                out++;
+            }
+        }
+        return out;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> subtract(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        AMRangeStdSet<T, Alloc> result(left.get_allocator());
+        subtract(left.begin(), left.end(), right.begin(), right.end(), std::inserter(result, result.end()));
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator-(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        return subtract(left, right);
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator+(const AMRange<T> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        AMRangeStdSet<T, Alloc> result(right.get_allocator());
+        unite(&left, &left + 1, right.begin(), right.end(), std::inserter(result, result.end()));
+        return result;
+    }
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator-(const AMRange<T> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        AMRangeStdSet<T, Alloc> result(right.get_allocator());
+        subtract(&left, &left + 1, right.begin(), right.end(), std::inserter(result, result.end()));
+        return result;
+    }
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator+(const AMRangeStdSet<T, Alloc> &left, const AMRange<T> &right)
+    {
+        AMRangeStdSet<T, Alloc> result(left.get_allocator());
+        unite(left.begin(), left.end(), &right, &right + 1, std::inserter(result, result.end()));
+        return result;
+    }
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator-(const AMRangeStdSet<T, Alloc> &left, const AMRange<T> &right)
+    {
+        AMRangeStdSet<T, Alloc> result(left.get_allocator());
+        subtract(left.begin(), left.end(), &right, &right + 1, std::inserter(result, result.end()));
+        return result;
+    }
+
+    template<typename InputIt1, typename InputIt2, typename OutputIt>
+    OutputIt intersect(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out)
+    {
+        typedef typename std::iterator_traits<InputIt1>::value_type Range;
+        while (first1 != last1 && first2 != last2) {
+            Range r = *first1;
+            r.intersect(*first2);
+            if (r.nonEmpty()) {
+                *out = r;
+                out++;
+            }
+            if (first1->to < first2->to) {
+                first1++;
             } else {
-                if (rit != rs.end()) {
-                    rit++;
+                first2++;
+            }
+        }
+        return out;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> intersect(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        AMRangeStdSet<T, Alloc> result(left.get_allocator());
+        if (left.empty() || right.empty()) {
+            return result;
+        }
+        AMRangeStdSet<T, Alloc> ls(left.get_allocator()), rs(left.get_allocator());
+        const AMRangeStdSet<T, Alloc> &l = isPacked(left) ? left : (ls = pack(left));
+        const AMRangeStdSet<T, Alloc> &r = isPacked(right) ? right : (rs = pack(right));
+        intersect(l.begin(), l.end(), r.begin(), r.end(), std::inserter(result, result.end()));
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator&(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        return intersect(left, right);
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator&(const AMRange<T> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        AMRangeStdSet<T, Alloc> result(right.get_allocator());
+        if (!left.nonEmpty()) {
+            return result;
+        }
+        AMRangeStdSet<T, Alloc> rs(right.get_allocator());
+        const AMRangeStdSet<T, Alloc> &r = isPacked(right) ? right : (rs = pack(right));
+        intersect(&left, &left + 1, r.begin(), r.end(), std::inserter(result, result.end()));
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator&(const AMRangeStdSet<T, Alloc> &left, const AMRange<T> &right)
+    {
+        return right & left;
+    }
+
+    template<typename InputIt1, typename InputIt2, typename OutputIt>
+    OutputIt symmetricDifference(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt out)
+    {
+        typedef typename std::iterator_traits<InputIt1>::value_type Range;
+        Range r;
+        Range pos;
+        bool pending = false;
+        bool start = true;
+        bool in1 = false;
+        bool in2 = false;
+        while (first1 != last1 || first2 != last2) {
+            bool take1 = false;
+            bool take2 = false;
+            if (first1 != last1) {
+                pos.to = in1 ? first1->to : first1->from;
+                take1 = true;
+            }
+            if (first2 != last2) {
+                typename Range::value_type b = in2 ? first2->to : first2->from;
+                if (!take1 || b < pos.to) {
+                    pos.to = b;
+                    take1 = false;
+                    take2 = true;
+                } else if (b == pos.to) {
+                    take2 = true;
+                }
+            }
+            if (start) {
+                start = false;
+            } else if (in1 != in2 && pos.from < pos.to) {
+                if (pending && r.to == pos.from) {
+                    r.to = pos.to;
                 } else {
-                    break;
+                    if (pending) {
+                        *out = r;
+                        out++;
+                    }
+                    r = pos;
+                    pending = true;
+                }
+            }
+            pos.from = pos.to;
+            if (take1) {
+                in1 = !in1;
+                if (!in1) {
+                    first1++;
+                }
+            }
+            if (take2) {
+                in2 = !in2;
+                if (!in2) {
+                    first2++;
                 }
             }
         }
-        if (r.nonEmpty()) {
-            result.insert(r);
+        if (pending) {
+            *out = r;
+            out++;
         }
+        return out;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> symmetricDifference(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        AMRangeStdSet<T, Alloc> result(left.get_allocator());
+        AMRangeStdSet<T, Alloc> ls(left.get_allocator()), rs(left.get_allocator());
+        const AMRangeStdSet<T, Alloc> &l = isPacked(left) ? left : (ls = pack(left));
+        const AMRangeStdSet<T, Alloc> &r = isPacked(right) ? right : (rs = pack(right));
+        symmetricDifference(l.begin(), l.end(), r.begin(), r.end(), std::inserter(result, result.end()));
         return result;
     }
 
-    template<typename T>
-    std::set<AMRange<T> > operator+(const AMRange<T> &left, const std::set<AMRange<T> > &right)
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> operator^(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        return symmetricDifference(left, right);
+    }
+
+    template<typename InputIt, typename OutputIt>
+    OutputIt complement(InputIt first, InputIt last, const typename std::iterator_traits<InputIt>::value_type &universe,
+                        OutputIt out)
+    {
+        typedef typename std::iterator_traits<InputIt>::value_type Range;
+        if (!universe.nonEmpty()) {
+            return out;
+        }
+        Range r(universe.from, universe.from);
+        for (; first != last; first++) {
+            if (first->to <= r.from || !first->nonEmpty()) {
+                continue;
+            }
+            if (first->from >= universe.to) {
+                break;
+            }
+            if (first->from > r.from) {
+                r.to = first->from;
+                *out = r;
+                out++;
+            }
+            r.from = first->to;
+        }
+        if (r.from < universe.to) {
+            r.to = universe.to;
+            *out = r;
+            out++;
+        }
+        return out;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> complement(const AMRangeStdSet<T, Alloc> &s, const AMRange<T> &universe)
     {
-        std::set<AMRange<T> > result = right;
-        result.insert(left);
-        result = pack(result);
+        AMRangeStdSet<T, Alloc> result(s.get_allocator());
+        AMRangeStdSet<T, Alloc> ps(s.get_allocator());
+        const AMRangeStdSet<T, Alloc> &p = isPacked(s) ? s : (ps = pack(s));
+        complement(p.begin(), p.end(), universe, std::inserter(result, result.end()));
         return result;
     }
-    template<typename T>
-    std::set<AMRange<T> > operator-(const AMRange<T> &left, const std::set<AMRange<T> > &right)
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> &operator+=(AMRangeStdSet<T, Alloc> &left, const AMRange<T> &right)
+    {
+        if (!right.nonEmpty()) {
+            return left;
+        }
+        AMRange<T> r = right;
+        typename AMRangeStdSet<T, Alloc>::iterator it = left.lower_bound(AMRange<T>(right.from, right.from));
+        if (it != left.begin()) {
+            typename AMRangeStdSet<T, Alloc>::iterator prev = it;
+            prev--;
+            if (prev->to >= right.from) {
+                it = prev;
+            }
+        }
+        while (it != left.end() && it->from <= r.to) {
+            if (it->from < r.from) {
+                r.from = it->from;
+            }
+            if (it->to > r.to) {
+                r.to = it->to;
+            }
+            it = left.erase(it);
+        }
+        left.insert(it, r);
+        return left;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> &operator-=(AMRangeStdSet<T, Alloc> &left, const AMRange<T> &right)
+    {
+        if (!right.nonEmpty()) {
+            return left;
+        }
+        typename AMRangeStdSet<T, Alloc>::iterator it = left.lower_bound(AMRange<T>(right.from, right.from));
+        if (it != left.begin()) {
+            typename AMRangeStdSet<T, Alloc>::iterator prev = it;
+            prev--;
+            if (prev->to > right.from) {
+                it = prev;
+            }
+        }
+        while (it != left.end() && it->from < right.to) {
+            AMRange<T> r = *it;
+            it = left.erase(it);
+            if (r.from < right.from) {
+                left.insert(it, AMRange<T>(r.from, right.from));
+            }
+            if (r.to > right.to) {
+                left.insert(it, AMRange<T>(right.to, r.to));
+                break;
+            }
+        }
+        return left;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> &operator&=(AMRangeStdSet<T, Alloc> &left, const AMRange<T> &right)
     {
-        std::set<AMRange<T> > ls = {left};
-        return ls - right;
+        if (!right.nonEmpty()) {
+            left.clear();
+            return left;
+        }
+        typename AMRangeStdSet<T, Alloc>::iterator it = left.lower_bound(AMRange<T>(right.from, right.from));
+        if (it != left.begin()) {
+            typename AMRangeStdSet<T, Alloc>::iterator prev = it;
+            prev--;
+            if (prev->to > right.from) {
+                it = prev;
+            }
+        }
+        left.erase(left.begin(), it);
+        left.erase(left.lower_bound(AMRange<T>(right.to, right.to)), left.end());
+        if (left.empty()) {
+            return left;
+        }
+        if (left.begin()->from < right.from) {
+            AMRange<T> r = *left.begin();
+            r.from = right.from;
+            left.insert(left.erase(left.begin()), r);
+        }
+        it = left.end();
+        it--;
+        if (it->to > right.to) {
+            AMRange<T> r = *it;
+            r.to = right.to;
+            left.insert(left.erase(it), r);
+        }
+        return left;
     }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> &operator+=(AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        for (typename AMRangeStdSet<T, Alloc>::const_iterator it = right.begin(); it != right.end(); it++) {
+            left += *it;
+        }
+        return left;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> &operator-=(AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        for (typename AMRangeStdSet<T, Alloc>::const_iterator it = right.begin(); it != right.end(); it++) {
+            left -= *it;
+        }
+        return left;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> &operator&=(AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right)
+    {
+        left = intersect(left, right);
+        return left;
+    }
+
+    template<typename T, typename Alloc>
+    typename AMRangeStdSet<T, Alloc>::const_iterator find(const AMRangeStdSet<T, Alloc> &s,
+                                                        const typename AMRange<T>::value_type &num)
+    {
+        typename AMRangeStdSet<T, Alloc>::const_iterator it = s.upper_bound(AMRange<T>(num, num));
+        if (it != s.end() && it->from == num) {
+            return it;
+        }
+        if (it != s.begin()) {
+            it--;
+            if (it->in(num)) {
+                return it;
+            }
+        }
+        return s.end();
+    }
+
+    template<typename T, typename Alloc>
+    bool covers(const AMRangeStdSet<T, Alloc> &s, const AMRange<T> &rng)
+    {
+        if (!rng.nonEmpty()) {
+            return true;
+        }
+        typename AMRangeStdSet<T, Alloc>::const_iterator it = find(s, rng.from);
+        return it != s.end() && it->to >= rng.to;
+    }
+
+    template<typename T, typename Alloc>
+    bool overlaps(const AMRangeStdSet<T, Alloc> &s, const AMRange<T> &rng)
+    {
+        typename AMRangeStdSet<T, Alloc>::const_iterator it = overlapping(s, rng).first;
+        return rng.nonEmpty() && it != s.end() && it->from < rng.to;
+    }
+
+    template<typename T, typename Alloc>
+    std::pair<typename AMRangeStdSet<T, Alloc>::const_iterator, typename AMRangeStdSet<T, Alloc>::const_iterator>
+    overlapping(const AMRangeStdSet<T, Alloc> &s, const AMRange<T> &rng)
+    {
+        typename AMRangeStdSet<T, Alloc>::const_iterator first = s.upper_bound(AMRange<T>(rng.from, rng.from));
+        if (first != s.begin()) {
+            typename AMRangeStdSet<T, Alloc>::const_iterator prev = first;
+            prev--;
+            if (prev->to > rng.from) {
+                first = prev;
+            }
+        }
+        if (!rng.nonEmpty()) {
+            return std::make_pair(first, first);
+        }
+        typename AMRangeStdSet<T, Alloc>::const_iterator last = s.lower_bound(AMRange<T>(rng.to, rng.to));
+        return std::make_pair(first, last);
+    }
+
     template<typename T>
-    std::set<AMRange<T> > operator+(const std::set<AMRange<T> > &left, const AMRange<T> &right)
+    constexpr AMRangeMeasure<T> measure(const AMRange<T> &r) noexcept
     {
-        std::set<AMRange<T> > result = left;
-        result.insert(right);
-        result = pack(result);
+        return r.nonEmpty() ? AMRangeMeasure<T>(AMRangeMeasure<T>(r.to) - AMRangeMeasure<T>(r.from)) : AMRangeMeasure<T>();
+    }
+
+    template<typename InputIt>
+    AMRangeStats<typename std::iterator_traits<InputIt>::value_type::value_type> stats(InputIt first, InputIt last)
+    {
+        typedef typename std::iterator_traits<InputIt>::value_type::value_type T;
+        AMRangeStats<T> result = {0, AMRangeMeasure<T>(), AMRangeMeasure<T>()};
+        T end = T();
+        for (; first != last; first++) {
+            if (result.count > 0) {
+                AMRangeMeasure<T> gap = measure(AMRange<T>(end, first->from));
+                if (gap > result.largestGap) {
+                    result.largestGap = gap;
+                }
+            }
+            result.count++;
+            result.measure += measure(*first);
+            end = first->to;
+        }
         return result;
     }
-    template<typename T>
-    std::set<AMRange<T> > operator-(const std::set<AMRange<T> > &left, const AMRange<T> &right)
+
+    template<typename T, typename Alloc>
+    AMRangeStats<T> stats(const AMRangeStdSet<T, Alloc> &s)
+    {
+        AMRangeStdSet<T, Alloc> ps(s.get_allocator());
+        const AMRangeStdSet<T, Alloc> &p = isPacked(s) ? s : (ps = pack(s));
+        return stats(p.begin(), p.end());
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeMeasure<T> measure(const AMRangeStdSet<T, Alloc> &s)
+    {
+        AMRangeStdSet<T, Alloc> ps(s.get_allocator());
+        const AMRangeStdSet<T, Alloc> &p = isPacked(s) ? s : (ps = pack(s));
+        AMRangeMeasure<T> sum = AMRangeMeasure<T>();
+        for (const AMRange<T> &r : p) {
+            sum += measure(r);
+        }
+        return sum;
+    }
+
+    template<typename InputIt1, typename InputIt2>
+    AMRangeMeasure<typename std::iterator_traits<InputIt1>::value_type::value_type>
+    overlapMeasure(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2)
+    {
+        typedef typename std::iterator_traits<InputIt1>::value_type::value_type T;
+        AMRangeMeasure<T> sum = AMRangeMeasure<T>();
+        while (first1 != last1 && first2 != last2) {
+            T from = first1->from > first2->from ? first1->from : first2->from;
+            T to = first1->to < first2->to ? first1->to : first2->to;
+            if (from < to) {
+                sum += measure(AMRange<T>(from, to));
+            }
+            // range ending first cannot overlap anything behind the other one
+            if (first1->to < first2->to) {
+                first1++;
+            } else {
+                first2++;
+            }
+        }
+        return sum;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeMeasure<T> overlapMeasure(const AMRangeStdSet<T, Alloc> &left, const AMRangeStdSet<T, Alloc> &right)
     {
-        std::set<AMRange<T> > rs = {right};
-        return left - rs;
+        AMRangeStdSet<T, Alloc> ls(left.get_allocator()), rs(left.get_allocator());
+        const AMRangeStdSet<T, Alloc> &l = isPacked(left) ? left : (ls = pack(left));
+        const AMRangeStdSet<T, Alloc> &r = isPacked(right) ? right : (rs = pack(right));
+        return overlapMeasure(l.begin(), l.end(), r.begin(), r.end());
     }
 }
 
@@ -0,0 +1,642 @@
+/**
+ * @file: AMRangeFile.h
+ * Binary format of packed set of ranges and memory mapped set
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMRANGEFILE_H
+#define AMCORE_AMRANGEFILE_H
+
+#include "AMRangeSet.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define AMRANGE_HAS_MMAP 1
+#endif
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    template<typename T>
+    class AMMappedRangeSet;
+
+    /**
+     *  @ingroup Common
+     *  @brief Binary format of packed set of ranges
+     *
+     *  File is 24 bytes header followed by ranges, every range is left and right bound, all numbers are
+     *  little endian. Header is magic "AMRS", version (uint16), kind of bounds (uint8, 0 signed integer,
+     *  1 unsigned integer, 2 floating point), size of bound in bytes (uint8), number of ranges (uint64)
+     *  and 8 reserved zero bytes. Ranges are packed and sorted in ascending order, so on little endian host
+     *  ranges in file have the same layout as AMRangeSet storage and they are read by one block copy,
+     *  or they are used in place by AMMappedRangeSet.
+     *
+     *  Reader refuses file with other magic, newer version or different bound type than T.
+     */
+    template<typename T>
+    class AMRangeFile
+    {
+        static_assert(std::is_arithmetic<T>::value, "file format needs arithmetic bounds");
+        static_assert(sizeof(AMRange<T>) == 2 * sizeof(T), "AMRange must not be padded");
+
+    public:
+        /**
+         *  @brief format version written to header
+         */
+        static constexpr std::uint16_t version = 1;
+
+        /**
+         *  @brief size of header in bytes, ranges start behind it
+         */
+        static constexpr std::size_t headerSize = 24;
+
+        /**
+         *  @brief write flat set of ranges
+         *  @param out output stream, opened in binary mode
+         *  @param s set of ranges
+         *  @return true if stream is good after writing
+         *  @throw Only what stream throws, when exceptions are enabled on it.
+         */
+        template<typename Alloc>
+        static bool write(std::ostream &out, const AMRangeSet<T, Alloc> &s);
+
+        /**
+         *  @brief write set of ranges
+         *  Set of ranges need not to be packed, it is packed before.
+         *  @param out output stream, opened in binary mode
+         *  @param s set of ranges
+         *  @return true if stream is good after writing
+         *  @throw std::bad_alloc if allocation fails, or what stream throws.
+         */
+        template<typename Alloc>
+        static bool write(std::ostream &out, const AMRangeStdSet<T, Alloc> &s);
+
+        /**
+         *  @brief read flat set of ranges
+         *  On failure set is left unchanged.
+         *  @param in input stream, opened in binary mode
+         *  @param s set of ranges
+         *  @param verify check that ranges are packed, O(n) time
+         *  @return false on bad header, short file or, when verified, on ranges which are not packed
+         *  @throw std::bad_alloc if allocation fails, or what stream throws.
+         */
+        static bool read(std::istream &in, AMRangeSet<T> &s, bool verify = true);
+
+    private:
+        friend class AMMappedRangeSet<T>;
+
+        /**
+         *  @brief number of ranges swapped or written at once
+         */
+        static constexpr std::size_t chunk = 65536;
+
+        /**
+         *  @brief fill header for count ranges
+         *  @throw This function will not throw an exception.
+         */
+        static void encodeHeader(unsigned char *header, std::uint64_t count);
+
+        /**
+         *  @brief check header and read number of ranges from it
+         *  @return false when header is not header of set of T
+         *  @throw This function will not throw an exception.
+         */
+        static bool decodeHeader(const unsigned char *header, std::uint64_t &count);
+
+        /**
+         *  @brief write ranges in little endian
+         *  @throw Only what stream throws.
+         */
+        static void writeRanges(std::ostream &out, const AMRange<T> *ranges, std::size_t count);
+
+        /**
+         *  @brief convert little endian ranges to host order in place
+         *  Nothing is done on little endian host.
+         *  @throw This function will not throw an exception.
+         */
+        static void swapRanges(AMRange<T> *ranges, std::size_t count);
+
+        /**
+         *  @brief test that ranges are nonempty, sorted and separated
+         *  @throw This function will not throw an exception.
+         */
+        static bool packed(const AMRange<T> *ranges, std::size_t count);
+
+        /**
+         *  @brief host is little endian
+         *  @throw This function will not throw an exception.
+         */
+        static inline bool littleEndian();
+    };
+
+#ifdef AMRANGE_HAS_MMAP
+    /**
+     *  @ingroup Common
+     *  @brief Read only set of ranges mapped from file
+     *
+     *  File written by AMRangeFile is mapped to memory and its ranges are used in place, nothing is read
+     *  or copied on open, pages are loaded by system when they are touched. So opening costs the same for
+     *  small and huge files. Lookups are binary searches like in AMRangeSet, iterators are pointers to mapped
+     *  ranges, so set can be used as operand of sequence algorithms and views.
+     *
+     *  Ranges are used in place only on little endian hosts, open fails on big endian ones, where set must
+     *  be loaded by AMRangeFile::read. File must not be changed while it is mapped.
+     */
+    template<typename T>
+    class AMMappedRangeSet
+    {
+    public:
+        /**
+         *  @brief iterator type
+         */
+        typedef const AMRange<T> *const_iterator;
+        /**
+         *  @brief iterator type
+         */
+        typedef const_iterator iterator;
+        /**
+         *  @brief value type
+         */
+        typedef AMRange<T> value_type;
+        /**
+         *  @brief size type
+         */
+        typedef std::size_t size_type;
+
+        /**
+         *  @brief empty constructor
+         *  Set is closed and empty.
+         *  @throw This function will not throw an exception.
+         */
+        AMMappedRangeSet();
+
+        /**
+         *  @brief move constructor
+         *  @throw This function will not throw an exception.
+         */
+        AMMappedRangeSet(AMMappedRangeSet &&other) noexcept;
+
+        /**
+         *  @brief move assignment
+         *  @throw This function will not throw an exception.
+         */
+        AMMappedRangeSet &operator=(AMMappedRangeSet &&other) noexcept;
+
+        AMMappedRangeSet(const AMMappedRangeSet &) = delete;
+        AMMappedRangeSet &operator=(const AMMappedRangeSet &) = delete;
+
+        /**
+         *  @brief destructor
+         *  File is unmapped.
+         *  @throw This function will not throw an exception.
+         */
+        ~AMMappedRangeSet();
+
+        /**
+         *  @brief map file
+         *  Previously mapped file is unmapped. Only header is checked, unless verify is set.
+         *  @param path path to file
+         *  @param verify check that ranges are packed, it touches all pages of file
+         *  @return false when file cannot be mapped or it is not set of T
+         *  @throw This function will not throw an exception.
+         */
+        bool open(const char *path, bool verify = false);
+
+        /**
+         *  @brief unmap file
+         *  Set becomes empty.
+         *  @throw This function will not throw an exception.
+         */
+        void close();
+
+        /**
+         *  @brief test that file is mapped
+         *  @throw This function will not throw an exception.
+         */
+        inline bool isOpen() const;
+
+        /**
+         *  @brief copy of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet<T> toRangeSet() const;
+
+        /**
+         *  @brief first range
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator begin() const;
+
+        /**
+         *  @brief behind last range
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator end() const;
+
+        /**
+         *  @brief number of ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline size_type size() const;
+
+        /**
+         *  @brief test for empty
+         *  @throw This function will not throw an exception.
+         */
+        inline bool empty() const;
+
+        /**
+         *  @brief range at index
+         *  @param i index, must be lower than size()
+         *  @throw This function will not throw an exception.
+         */
+        inline const AMRange<T> &operator[](size_type i) const;
+
+        /**
+         *  @brief mapped array of ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline const AMRange<T> *data() const;
+
+        /**
+         *  @brief find range containing number
+         *  Binary search, e.q. O(log n) time.
+         *  @param num
+         *  @return iterator to range containing num or end()
+         *  @throw This function will not throw an exception.
+         */
+        const_iterator find(T num) const;
+
+        /**
+         *  @brief test that range is fully covered
+         *  Empty range is always covered. Binary search, e.q. O(log n) time.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool covers(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief test that range has nonempty intersection with set
+         *  Binary search, e.q. O(log n) time.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool overlaps(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief ranges having nonempty intersection with range
+         *  Binary search, e.q. O(log n) time, hits are iterated by returned iterators.
+         *  @param rng range
+         *  @return first and behind last overlapping range
+         *  @throw This function will not throw an exception.
+         */
+        std::pair<const_iterator, const_iterator> overlapping(const AMRange<T> &rng) const;
+
+    private:
+        void *mMap;
+        std::size_t mLength;
+        const AMRange<T> *mRanges;
+        size_type mSize;
+    };
+#endif
+
+
+    template<typename T>
+    inline bool AMRangeFile<T>::littleEndian()
+    {
+        const std::uint16_t one = 1;
+        unsigned char first;
+        std::memcpy(&first, &one, 1);
+        return first == 1;
+    }
+
+    template<typename T>
+    void AMRangeFile<T>::encodeHeader(unsigned char *header, std::uint64_t count)
+    {
+        std::memset(header, 0, headerSize);
+        std::memcpy(header, "AMRS", 4);
+        header[4] = static_cast<unsigned char>(version & 0xff);
+        header[5] = static_cast<unsigned char>(version >> 8);
+        header[6] = std::is_floating_point<T>::value ? 2 : std::is_signed<T>::value ? 0 : 1;
+        header[7] = sizeof(T);
+        for (int i = 0; i < 8; i++) {
+            header[8 + i] = static_cast<unsigned char>(count >> (8 * i));
+        }
+    }
+
+    template<typename T>
+    bool AMRangeFile<T>::decodeHeader(const unsigned char *header, std::uint64_t &count)
+    {
+        unsigned char expected[headerSize];
+        encodeHeader(expected, 0);
+        std::uint16_t v = static_cast<std::uint16_t>(header[4] | header[5] << 8);
+        if (std::memcmp(header, expected, 4) != 0 || v == 0 || v > version ||
+            header[6] != expected[6] || header[7] != expected[7]) {
+            return false;
+        }
+        count = 0;
+        for (int i = 0; i < 8; i++) {
+            count |= std::uint64_t(header[8 + i]) << (8 * i);
+        }
+        return true;
+    }
+
+    template<typename T>
+    void AMRangeFile<T>::swapRanges(AMRange<T> *ranges, std::size_t count)
+    {
+        if (littleEndian()) {
+            return;
+        }
+        unsigned char *bytes = reinterpret_cast<unsigned char *>(ranges);
+        for (std::size_t i = 0; i < 2 * count; i++, bytes += sizeof(T)) {
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+    }
+
+    template<typename T>
+    void AMRangeFile<T>::writeRanges(std::ostream &out, const AMRange<T> *ranges, std::size_t count)
+    {
+        if (littleEndian()) {
+            out.write(reinterpret_cast<const char *>(ranges), std::streamsize(count * sizeof(AMRange<T>)));
+            return;
+        }
+        std::vector<AMRange<T> > buffer;
+        for (std::size_t i = 0; i < count && out; i += chunk) {
+            std::size_t n = count - i < chunk ? count - i : chunk;
+            buffer.assign(ranges + i, ranges + i + n);
+            swapRanges(buffer.data(), n);
+            out.write(reinterpret_cast<const char *>(buffer.data()), std::streamsize(n * sizeof(AMRange<T>)));
+        }
+    }
+
+    template<typename T>
+    bool AMRangeFile<T>::packed(const AMRange<T> *ranges, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            if (!ranges[i].nonEmpty() || (i > 0 && !(ranges[i].from > ranges[i - 1].to))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename T>
+    template<typename Alloc>
+    bool AMRangeFile<T>::write(std::ostream &out, const AMRangeSet<T, Alloc> &s)
+    {
+        unsigned char header[headerSize];
+        encodeHeader(header, s.size());
+        out.write(reinterpret_cast<const char *>(header), headerSize);
+        writeRanges(out, s.data(), s.size());
+        return out.good();
+    }
+
+    template<typename T>
+    template<typename Alloc>
+    bool AMRangeFile<T>::write(std::ostream &out, const AMRangeStdSet<T, Alloc> &s)
+    {
+        AMRangeStdSet<T, Alloc> ps(s.get_allocator());
+        const AMRangeStdSet<T, Alloc> &p = isPacked(s) ? s : (ps = pack(s));
+        unsigned char header[headerSize];
+        encodeHeader(header, p.size());
+        out.write(reinterpret_cast<const char *>(header), headerSize);
+        // tree is not contiguous, ranges are written thru buffer
+        std::vector<AMRange<T> > buffer;
+        buffer.reserve(p.size() < chunk ? p.size() : chunk);
+        typename AMRangeStdSet<T, Alloc>::const_iterator it = p.begin();
+        while (it != p.end() && out) {
+            buffer.clear();
+            for (; it != p.end() && buffer.size() < chunk; it++) {
+                buffer.push_back(*it);
+            }
+            writeRanges(out, buffer.data(), buffer.size());
+        }
+        return out.good();
+    }
+
+    template<typename T>
+    bool AMRangeFile<T>::read(std::istream &in, AMRangeSet<T> &s, bool verify)
+    {
+        unsigned char header[headerSize];
+        std::uint64_t count;
+        if (!in.read(reinterpret_cast<char *>(header), headerSize) || !decodeHeader(header, count)) {
+            return false;
+        }
+        // count is not trusted before ranges are there, storage grows by chunks
+        std::vector<AMRange<T> > ranges;
+        for (std::uint64_t i = 0; i < count; i += chunk) {
+            std::size_t n = count - i < chunk ? std::size_t(count - i) : chunk;
+            std::size_t size = ranges.size();
+            ranges.resize(size + n);
+            if (!in.read(reinterpret_cast<char *>(ranges.data() + size), std::streamsize(n * sizeof(AMRange<T>)))) {
+                return false;
+            }
+            swapRanges(ranges.data() + size, n);
+        }
+        if (verify && !packed(ranges.data(), ranges.size())) {
+            return false;
+        }
+        s = AMRangeSet<T>::fromPacked(std::move(ranges));
+        return true;
+    }
+
+#ifdef AMRANGE_HAS_MMAP
+    template<typename T>
+    AMMappedRangeSet<T>::AMMappedRangeSet()
+        : mMap(nullptr),
+          mLength(0),
+          mRanges(nullptr),
+          mSize(0)
+    {
+    }
+
+    template<typename T>
+    AMMappedRangeSet<T>::AMMappedRangeSet(AMMappedRangeSet &&other) noexcept
+        : mMap(other.mMap),
+          mLength(other.mLength),
+          mRanges(other.mRanges),
+          mSize(other.mSize)
+    {
+        other.mMap = nullptr;
+        other.mLength = 0;
+        other.mRanges = nullptr;
+        other.mSize = 0;
+    }
+
+    template<typename T>
+    AMMappedRangeSet<T> &AMMappedRangeSet<T>::operator=(AMMappedRangeSet &&other) noexcept
+    {
+        if (this != &other) {
+            close();
+            std::swap(mMap, other.mMap);
+            std::swap(mLength, other.mLength);
+            std::swap(mRanges, other.mRanges);
+            std::swap(mSize, other.mSize);
+        }
+        return *this;
+    }
+
+    template<typename T>
+    AMMappedRangeSet<T>::~AMMappedRangeSet()
+    {
+        close();
+    }
+
+    template<typename T>
+    bool AMMappedRangeSet<T>::open(const char *path, bool verify)
+    {
+        close();
+        if (!AMRangeFile<T>::littleEndian()) {
+            return false;
+        }
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size < off_t(AMRangeFile<T>::headerSize)) {
+            ::close(fd);
+            return false;
+        }
+        std::size_t length = std::size_t(st.st_size);
+        void *map = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        // mapping keeps file referenced after descriptor is closed
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            return false;
+        }
+        std::uint64_t count;
+        const unsigned char *bytes = static_cast<const unsigned char *>(map);
+        const AMRange<T> *ranges = reinterpret_cast<const AMRange<T> *>(bytes + AMRangeFile<T>::headerSize);
+        if (!AMRangeFile<T>::decodeHeader(bytes, count) ||
+            count > (length - AMRangeFile<T>::headerSize) / sizeof(AMRange<T>) ||
+            (verify && !AMRangeFile<T>::packed(ranges, std::size_t(count)))) {
+            ::munmap(map, length);
+            return false;
+        }
+        mMap = map;
+        mLength = length;
+        mRanges = ranges;
+        mSize = size_type(count);
+        return true;
+    }
+
+    template<typename T>
+    void AMMappedRangeSet<T>::close()
+    {
+        if (mMap) {
+            ::munmap(mMap, mLength);
+        }
+        mMap = nullptr;
+        mLength = 0;
+        mRanges = nullptr;
+        mSize = 0;
+    }
+
+    template<typename T>
+    inline bool AMMappedRangeSet<T>::isOpen() const
+    {
+        return mMap != nullptr;
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMMappedRangeSet<T>::toRangeSet() const
+    {
+        return AMRangeSet<T>::fromPacked(std::vector<AMRange<T> >(begin(), end()));
+    }
+
+    template<typename T>
+    inline typename AMMappedRangeSet<T>::const_iterator AMMappedRangeSet<T>::begin() const
+    {
+        return mRanges;
+    }
+
+    template<typename T>
+    inline typename AMMappedRangeSet<T>::const_iterator AMMappedRangeSet<T>::end() const
+    {
+        return mRanges + mSize;
+    }
+
+    template<typename T>
+    inline typename AMMappedRangeSet<T>::size_type AMMappedRangeSet<T>::size() const
+    {
+        return mSize;
+    }
+
+    template<typename T>
+    inline bool AMMappedRangeSet<T>::empty() const
+    {
+        return mSize == 0;
+    }
+
+    template<typename T>
+    inline const AMRange<T> &AMMappedRangeSet<T>::operator[](size_type i) const
+    {
+        return mRanges[i];
+    }
+
+    template<typename T>
+    inline const AMRange<T> *AMMappedRangeSet<T>::data() const
+    {
+        return mRanges;
+    }
+
+    template<typename T>
+    typename AMMappedRangeSet<T>::const_iterator AMMappedRangeSet<T>::find(T num) const
+    {
+        const_iterator it = std::partition_point(begin(), end(), [num](const AMRange<T> &r) { return r.to <= num; });
+        if (it != end() && it->from <= num) {
+            return it;
+        }
+        return end();
+    }
+
+    template<typename T>
+    bool AMMappedRangeSet<T>::covers(const AMRange<T> &rng) const
+    {
+        if (!rng.nonEmpty()) {
+            return true;
+        }
+        const_iterator it = find(rng.from);
+        return it != end() && it->to >= rng.to;
+    }
+
+    template<typename T>
+    bool AMMappedRangeSet<T>::overlaps(const AMRange<T> &rng) const
+    {
+        const_iterator it = overlapping(rng).first;
+        return rng.nonEmpty() && it != end() && it->from < rng.to;
+    }
+
+    template<typename T>
+    std::pair<typename AMMappedRangeSet<T>::const_iterator, typename AMMappedRangeSet<T>::const_iterator>
+    AMMappedRangeSet<T>::overlapping(const AMRange<T> &rng) const
+    {
+        const_iterator first = std::partition_point(begin(), end(),
+                                                    [&rng](const AMRange<T> &r) { return r.to <= rng.from; });
+        if (!rng.nonEmpty()) {
+            return std::make_pair(first, first);
+        }
+        const_iterator last = std::partition_point(first, end(),
+                                                   [&rng](const AMRange<T> &r) { return r.from < rng.to; });
+        return std::make_pair(first, last);
+    }
+#endif
+}
+
+/** @} */
+
+#endif //AMCORE_AMRANGEFILE_H
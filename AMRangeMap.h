@@ -0,0 +1,420 @@
+/**
+ * @file: AMRangeMap.h
+ * Map of ranges to values
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMRANGEMAP_H
+#define AMCORE_AMRANGEMAP_H
+
+#include "AMRangeSet.h"
+#include <new>
+#include <vector>
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Common
+     *  @brief Map of ranges to values
+     *
+     *  Assigns value to every number of range. Entries are stored in sorted contiguous array,
+     *  ranges of entries are nonempty and do not overlap. Assignment splits entries it overlaps,
+     *  the same way as AMRange::operator-= cuts ranges, and coalesces touching entries with equal values,
+     *  the same way as pack merges touching ranges. So map never holds two touching entries with equal value.
+     *
+     *  Value type must be copyable and equality comparable, default constructor is not required.
+     */
+    template<typename T, typename V>
+    class AMRangeMap
+    {
+    public:
+        /**
+         *  @brief range with value
+         */
+        struct Entry
+        {
+            /**
+             *  @brief range
+             */
+            AMRange<T> range;
+            /**
+             *  @brief value
+             */
+            V value;
+
+            /**
+             *  @brief comparison operator
+             *  @param right operand
+             *  @throw Only what V::operator== throws.
+             */
+            bool operator==(const Entry &right) const
+            {
+                return range == right.range && value == right.value;
+            }
+
+            /**
+             *  @brief comparison operator
+             *  @param right operand
+             *  @throw Only what V::operator== throws.
+             */
+            bool operator!=(const Entry &right) const
+            {
+                return !(*this == right);
+            }
+        };
+
+        /**
+         *  @brief iterator type
+         *  Entries cannot be modified thru iterator, it would break coalesced invariant.
+         */
+        typedef typename std::vector<Entry>::const_iterator const_iterator;
+        /**
+         *  @brief iterator type
+         */
+        typedef const_iterator iterator;
+        /**
+         *  @brief size type
+         */
+        typedef std::size_t size_type;
+
+        /**
+         *  @brief empty constructor
+         *  @throw This function will not throw an exception.
+         */
+        AMRangeMap();
+
+        /**
+         *  @brief assign value to range
+         *  Overlapped entries are split, touching entries with equal value are coalesced.
+         *  Binary search and one splice of array, e.q. O(log n + k) comparisons.
+         *  Empty or invalid range is ignored.
+         *  @param rng range
+         *  @param value value
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        void assign(const AMRange<T> &rng, const V &value);
+
+        /**
+         *  @brief remove values from range
+         *  Overlapped entries are split.
+         *  Empty or invalid range is ignored.
+         *  @param rng range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        void erase(const AMRange<T> &rng);
+
+        /**
+         *  @brief find entry containing number
+         *  Binary search, e.q. O(log n) time.
+         *  @param num
+         *  @return iterator to entry containing num or end()
+         *  @throw This function will not throw an exception.
+         */
+        const_iterator find(T num) const;
+
+        /**
+         *  @brief value at number
+         *  @param num
+         *  @return pointer to value or nullptr when no value is assigned to num
+         *  @throw This function will not throw an exception.
+         */
+        const V *at(T num) const;
+
+        /**
+         *  @brief entries having nonempty intersection with range
+         *  @param rng range
+         *  @return first and behind last overlapping entry
+         *  @throw This function will not throw an exception.
+         */
+        std::pair<const_iterator, const_iterator> overlapping(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief set of ranges with any value assigned
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet<T> ranges() const;
+
+        /**
+         *  @brief first entry
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator begin() const;
+
+        /**
+         *  @brief behind last entry
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator end() const;
+
+        /**
+         *  @brief number of entries
+         *  @throw This function will not throw an exception.
+         */
+        inline size_type size() const;
+
+        /**
+         *  @brief test for empty
+         *  @throw This function will not throw an exception.
+         */
+        inline bool empty() const;
+
+        /**
+         *  @brief entry at index
+         *  @param i index, must be lower than size()
+         *  @throw This function will not throw an exception.
+         */
+        inline const Entry &operator[](size_type i) const;
+
+        /**
+         *  @brief remove all entries
+         *  @throw This function will not throw an exception.
+         */
+        inline void clear();
+
+        /**
+         *  @brief comparison operator
+         *  @param right operand
+         *  @throw Only what V::operator== throws.
+         */
+        inline bool operator==(const AMRangeMap &right) const;
+
+        /**
+         *  @brief comparison operator
+         *  @param right operand
+         *  @throw Only what V::operator== throws.
+         */
+        inline bool operator!=(const AMRangeMap &right) const;
+
+    private:
+        typedef typename std::vector<Entry>::iterator mutable_iterator;
+
+        /**
+         *  @brief fixed capacity buffer of entries
+         *  Entries are constructed only when added, so value type needs no default constructor.
+         */
+        template<size_type N>
+        class Pieces
+        {
+        public:
+            Pieces() : mCount(0) {}
+            Pieces(const Pieces &) = delete;
+            Pieces &operator=(const Pieces &) = delete;
+            ~Pieces()
+            {
+                for (size_type i = 0; i < mCount; i++) {
+                    data()[i].~Entry();
+                }
+            }
+
+            /**
+             *  @brief add entry, count must be lower than N
+             *  @throw Only what V copy constructor throws.
+             */
+            void push_back(const Entry &e)
+            {
+                new (mStorage + mCount * sizeof(Entry)) Entry(e);
+                mCount++;
+            }
+
+            Entry *data() { return reinterpret_cast<Entry *>(mStorage); }
+            Entry &back() { return data()[mCount - 1]; }
+            size_type size() const { return mCount; }
+
+        private:
+            alignas(Entry) unsigned char mStorage[N * sizeof(Entry)];
+            size_type mCount;
+        };
+
+        /**
+         *  @brief replace entries [first, last) by count entries
+         *  @return iterator to first inserted entry
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        mutable_iterator splice(mutable_iterator first, mutable_iterator last, const Entry *entries, size_type count);
+
+        std::vector<Entry> mEntries;
+    };
+
+
+    template<typename T, typename V>
+    AMRangeMap<T, V>::AMRangeMap()
+        : mEntries()
+    {
+    }
+
+    template<typename T, typename V>
+    void AMRangeMap<T, V>::assign(const AMRange<T> &rng, const V &value)
+    {
+        if (!rng.nonEmpty()) {
+            return;
+        }
+        mutable_iterator first = std::partition_point(mEntries.begin(), mEntries.end(),
+                                                      [&rng](const Entry &e) { return e.range.to <= rng.from; });
+        mutable_iterator last = std::partition_point(first, mEntries.end(),
+                                                     [&rng](const Entry &e) { return e.range.from < rng.to; });
+        Pieces<3> pieces;
+        AMRange<T> merged = rng;
+        if (first != last && first->range.from < rng.from) {
+            if (first->value == value) {
+                merged.from = first->range.from;
+            } else {
+                pieces.push_back(Entry{AMRange<T>(first->range.from, rng.from), first->value});
+            }
+        } else if (first != mEntries.begin() && (first - 1)->range.to == rng.from && (first - 1)->value == value) {
+            first--;
+            merged.from = first->range.from;
+        }
+        pieces.push_back(Entry{merged, value});
+        if (first != last && (last - 1)->range.to > rng.to) {
+            if ((last - 1)->value == value) {
+                pieces.back().range.to = (last - 1)->range.to;
+            } else {
+                pieces.push_back(Entry{AMRange<T>(rng.to, (last - 1)->range.to), (last - 1)->value});
+            }
+        } else if (last != mEntries.end() && last->range.from == rng.to && last->value == value) {
+            pieces.back().range.to = last->range.to;
+            last++;
+        }
+        splice(first, last, pieces.data(), pieces.size());
+    }
+
+    template<typename T, typename V>
+    void AMRangeMap<T, V>::erase(const AMRange<T> &rng)
+    {
+        if (!rng.nonEmpty()) {
+            return;
+        }
+        mutable_iterator first = std::partition_point(mEntries.begin(), mEntries.end(),
+                                                      [&rng](const Entry &e) { return e.range.to <= rng.from; });
+        mutable_iterator last = std::partition_point(first, mEntries.end(),
+                                                     [&rng](const Entry &e) { return e.range.from < rng.to; });
+        if (first == last) {
+            return;
+        }
+        Pieces<2> pieces;
+        if (first->range.from < rng.from) {
+            pieces.push_back(Entry{AMRange<T>(first->range.from, rng.from), first->value});
+        }
+        if ((last - 1)->range.to > rng.to) {
+            pieces.push_back(Entry{AMRange<T>(rng.to, (last - 1)->range.to), (last - 1)->value});
+        }
+        splice(first, last, pieces.data(), pieces.size());
+    }
+
+    template<typename T, typename V>
+    typename AMRangeMap<T, V>::mutable_iterator
+    AMRangeMap<T, V>::splice(mutable_iterator first, mutable_iterator last, const Entry *entries, size_type count)
+    {
+        size_type index = first - mEntries.begin();
+        size_type i = 0;
+        for (; i < count && first != last; i++, first++) {
+            *first = entries[i];
+        }
+        if (first != last) {
+            mEntries.erase(first, last);
+        } else if (i < count) {
+            mEntries.insert(first, entries + i, entries + count);
+        }
+        return mEntries.begin() + index;
+    }
+
+    template<typename T, typename V>
+    typename AMRangeMap<T, V>::const_iterator AMRangeMap<T, V>::find(T num) const
+    {
+        const_iterator it = std::partition_point(mEntries.begin(), mEntries.end(),
+                                                 [num](const Entry &e) { return e.range.to <= num; });
+        if (it != mEntries.end() && it->range.from <= num) {
+            return it;
+        }
+        return mEntries.end();
+    }
+
+    template<typename T, typename V>
+    const V *AMRangeMap<T, V>::at(T num) const
+    {
+        const_iterator it = find(num);
+        return it == mEntries.end() ? nullptr : &it->value;
+    }
+
+    template<typename T, typename V>
+    std::pair<typename AMRangeMap<T, V>::const_iterator, typename AMRangeMap<T, V>::const_iterator>
+    AMRangeMap<T, V>::overlapping(const AMRange<T> &rng) const
+    {
+        const_iterator first = std::partition_point(mEntries.begin(), mEntries.end(),
+                                                    [&rng](const Entry &e) { return e.range.to <= rng.from; });
+        if (!rng.nonEmpty()) {
+            return std::make_pair(first, first);
+        }
+        const_iterator last = std::partition_point(first, mEntries.end(),
+                                                   [&rng](const Entry &e) { return e.range.from < rng.to; });
+        return std::make_pair(first, last);
+    }
+
+    template<typename T, typename V>
+    AMRangeSet<T> AMRangeMap<T, V>::ranges() const
+    {
+        AMRangeSet<T> result;
+        for (const_iterator it = mEntries.begin(); it != mEntries.end(); it++) {
+            result += it->range;
+        }
+        return result;
+    }
+
+    template<typename T, typename V>
+    inline typename AMRangeMap<T, V>::const_iterator AMRangeMap<T, V>::begin() const
+    {
+        return mEntries.begin();
+    }
+
+    template<typename T, typename V>
+    inline typename AMRangeMap<T, V>::const_iterator AMRangeMap<T, V>::end() const
+    {
+        return mEntries.end();
+    }
+
+    template<typename T, typename V>
+    inline typename AMRangeMap<T, V>::size_type AMRangeMap<T, V>::size() const
+    {
+        return mEntries.size();
+    }
+
+    template<typename T, typename V>
+    inline bool AMRangeMap<T, V>::empty() const
+    {
+        return mEntries.empty();
+    }
+
+    template<typename T, typename V>
+    inline const typename AMRangeMap<T, V>::Entry &AMRangeMap<T, V>::operator[](size_type i) const
+    {
+        return mEntries[i];
+    }
+
+    template<typename T, typename V>
+    inline void AMRangeMap<T, V>::clear()
+    {
+        mEntries.clear();
+    }
+
+    template<typename T, typename V>
+    inline bool AMRangeMap<T, V>::operator==(const AMRangeMap<T, V> &right) const
+    {
+        return mEntries == right.mEntries;
+    }
+
+    template<typename T, typename V>
+    inline bool AMRangeMap<T, V>::operator!=(const AMRangeMap<T, V> &right) const
+    {
+        return !(mEntries == right.mEntries);
+    }
+}
+
+/** @} */
+
+#endif //AMCORE_AMRANGEMAP_H
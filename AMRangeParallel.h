@@ -0,0 +1,403 @@
+/**
+ * @file: AMRangeParallel.h
+ * Parallel pack and set of range operations
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMRANGEPARALLEL_H
+#define AMCORE_AMRANGEPARALLEL_H
+
+#include "AMRangeSet.h"
+#include <exception>
+#include <thread>
+#include <vector>
+
+/**
+ *  @brief minimal number of ranges processed by one thread, smaller inputs are processed by fewer threads
+ */
+#ifndef AMRANGE_PARALLEL_MIN_CHUNK
+#define AMRANGE_PARALLEL_MIN_CHUNK 65536
+#endif
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Common
+     *  @brief Parallel pack and set of range operations
+     *
+     *  Input is partitioned at split points into windows &lt; p(i), p(i+1) ), every window is processed
+     *  by its own thread with the same single pass algorithms as AMRangeSet uses, over ranges overlapping
+     *  the window only. Result of window is clipped to the window, so results of windows do not overlap
+     *  and they are stitched by merging ranges which touch at split points. Stitched results are copied
+     *  to the output in parallel too.
+     *
+     *  Split points are left bounds of evenly spaced ranges of bigger operand, so windows have similar
+     *  number of ranges. Binary operations do not copy ranges into windows, window is a pair of binary searched
+     *  positions in every operand.
+     *
+     *  Inputs are contiguous (AMRangeSet or vector), std::set of ranges cannot be split without walking it.
+     *  Number of threads 0 means std::thread::hardware_concurrency().
+     */
+    template<typename T>
+    class AMRangeParallel
+    {
+    public:
+        /**
+         *  @brief pack sorted ranges
+         *  Ranges must be sorted in ascending order, need not to be packed. Invalid and empty ranges are skipped.
+         *  @param sorted ranges
+         *  @param threads number of threads
+         *  @throw std::bad_alloc if allocation fails, std::system_error if thread cannot be started.
+         */
+        static AMRangeSet<T> pack(const std::vector<AMRange<T> > &sorted, unsigned threads = 0);
+
+        /**
+         *  @brief sort and pack ranges in any order
+         *  Every thread sorts and packs its part of vector, parts are then united window by window.
+         *  @param ranges ranges in any order, vector is reordered
+         *  @param threads number of threads
+         *  @throw std::bad_alloc if allocation fails, std::system_error if thread cannot be started.
+         */
+        static AMRangeSet<T> fromUnsorted(std::vector<AMRange<T> > &ranges, unsigned threads = 0);
+
+        /**
+         *  @brief union of two sets of ranges
+         *  @param left set of ranges
+         *  @param right set of ranges
+         *  @param threads number of threads
+         *  @throw std::bad_alloc if allocation fails, std::system_error if thread cannot be started.
+         */
+        static AMRangeSet<T> unite(const AMRangeSet<T> &left, const AMRangeSet<T> &right, unsigned threads = 0);
+
+        /**
+         *  @brief difference of two sets of ranges
+         *  @param left set of ranges
+         *  @param right set of ranges
+         *  @param threads number of threads
+         *  @throw std::bad_alloc if allocation fails, std::system_error if thread cannot be started.
+         */
+        static AMRangeSet<T> subtract(const AMRangeSet<T> &left, const AMRangeSet<T> &right, unsigned threads = 0);
+
+        /**
+         *  @brief intersection of two sets of ranges
+         *  @param left set of ranges
+         *  @param right set of ranges
+         *  @param threads number of threads
+         *  @throw std::bad_alloc if allocation fails, std::system_error if thread cannot be started.
+         */
+        static AMRangeSet<T> intersect(const AMRangeSet<T> &left, const AMRangeSet<T> &right, unsigned threads = 0);
+
+        /**
+         *  @brief symmetric difference of two sets of ranges
+         *  @param left set of ranges
+         *  @param right set of ranges
+         *  @param threads number of threads
+         *  @throw std::bad_alloc if allocation fails, std::system_error if thread cannot be started.
+         */
+        static AMRangeSet<T> symmetricDifference(const AMRangeSet<T> &left, const AMRangeSet<T> &right,
+                                                 unsigned threads = 0);
+
+    private:
+        typedef std::vector<AMRange<T> > Part;
+
+        /**
+         *  @brief number of threads for input size
+         *  @throw This function will not throw an exception.
+         */
+        static unsigned threadCount(std::size_t size, unsigned threads);
+
+        /**
+         *  @brief run f(0) .. f(count - 1), each in its own thread
+         *  First exception thrown by f is rethrown after all threads are joined.
+         *  @throw what f throws, std::system_error if thread cannot be started.
+         */
+        template<typename F>
+        static void run(unsigned count, F f);
+
+        /**
+         *  @brief window i is &lt; points[i - 1], points[i] ), first window is unbounded below, last above
+         *  @return first range of packed ranges overlapping window and behind last one
+         *  @throw This function will not throw an exception.
+         */
+        static std::pair<const AMRange<T> *, const AMRange<T> *>
+        slice(const AMRange<T> *first, const AMRange<T> *last, const std::vector<T> &points, unsigned i);
+
+        /**
+         *  @brief remove ranges outside window and cut ranges crossing its bounds
+         *  @throw This function will not throw an exception.
+         */
+        static void clip(Part &part, const std::vector<T> &points, unsigned i);
+
+        /**
+         *  @brief stitch parts packed on their own and copy them to one packed set
+         *  Last range of part is merged with first ranges of next parts when they overlap or touch.
+         *  @throw std::bad_alloc if allocation fails, std::system_error if thread cannot be started.
+         */
+        static AMRangeSet<T> stitch(std::vector<Part> &parts);
+
+        /**
+         *  @brief binary operation window by window
+         *  @param op single pass algorithm taking two sequences and output iterator
+         *  @throw std::bad_alloc if allocation fails, std::system_error if thread cannot be started.
+         */
+        template<typename Op>
+        static AMRangeSet<T> binary(const AMRangeSet<T> &left, const AMRangeSet<T> &right, unsigned threads, Op op);
+    };
+
+
+    template<typename T>
+    unsigned AMRangeParallel<T>::threadCount(std::size_t size, unsigned threads)
+    {
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+        std::size_t limit = size / AMRANGE_PARALLEL_MIN_CHUNK;
+        if (threads > limit) {
+            threads = static_cast<unsigned>(limit);
+        }
+        return threads == 0 ? 1 : threads;
+    }
+
+    template<typename T>
+    template<typename F>
+    void AMRangeParallel<T>::run(unsigned count, F f)
+    {
+        std::vector<std::exception_ptr> errors(count);
+        auto guarded = [&f, &errors](unsigned i) {
+            try {
+                f(i);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(count);
+        try {
+            for (unsigned i = 1; i < count; i++) {
+                workers.emplace_back(guarded, i);
+            }
+        } catch (...) {
+            for (std::thread &w : workers) {
+                w.join();
+            }
+            throw;
+        }
+        guarded(0);
+        for (std::thread &w : workers) {
+            w.join();
+        }
+        for (std::exception_ptr &e : errors) {
+            if (e) {
+                std::rethrow_exception(e);
+            }
+        }
+    }
+
+    template<typename T>
+    std::pair<const AMRange<T> *, const AMRange<T> *>
+    AMRangeParallel<T>::slice(const AMRange<T> *first, const AMRange<T> *last, const std::vector<T> &points, unsigned i)
+    {
+        if (i > 0) {
+            T from = points[i - 1];
+            first = std::partition_point(first, last, [from](const AMRange<T> &r) { return r.to <= from; });
+        }
+        if (i < points.size()) {
+            T to = points[i];
+            last = std::partition_point(first, last, [to](const AMRange<T> &r) { return r.from < to; });
+        }
+        return std::make_pair(first, last);
+    }
+
+    template<typename T>
+    void AMRangeParallel<T>::clip(Part &part, const std::vector<T> &points, unsigned i)
+    {
+        typename Part::iterator out = part.begin();
+        for (typename Part::iterator it = part.begin(); it != part.end(); it++) {
+            AMRange<T> r = *it;
+            if (i > 0 && r.from < points[i - 1]) {
+                r.from = points[i - 1];
+            }
+            if (i < points.size() && r.to > points[i]) {
+                r.to = points[i];
+            }
+            if (r.nonEmpty()) {
+                *out = r;
+                out++;
+            }
+        }
+        part.erase(out, part.end());
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMRangeParallel<T>::stitch(std::vector<Part> &parts)
+    {
+        // first[i] is index of first range of part i which is not merged into previous parts
+        std::vector<std::size_t> first(parts.size(), 0);
+        std::vector<std::size_t> offsets(parts.size() + 1, 0);
+        AMRange<T> *last = nullptr;
+        for (std::size_t i = 0; i < parts.size(); i++) {
+            Part &part = parts[i];
+            std::size_t j = 0;
+            if (last) {
+                for (; j < part.size() && part[j].from <= last->to; j++) {
+                    if (part[j].to > last->to) {
+                        last->to = part[j].to;
+                    }
+                }
+            }
+            first[i] = j;
+            if (j < part.size()) {
+                last = &part.back();
+            }
+            offsets[i + 1] = offsets[i] + part.size() - j;
+        }
+        if (parts.size() == 1) {
+            return AMRangeSet<T>::fromPacked(std::move(parts[0]));
+        }
+        std::vector<AMRange<T> > result(offsets.back());
+        run(static_cast<unsigned>(parts.size()), [&](unsigned i) {
+            std::copy(parts[i].begin() + first[i], parts[i].end(), result.begin() + offsets[i]);
+            Part().swap(parts[i]);
+        });
+        return AMRangeSet<T>::fromPacked(std::move(result));
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMRangeParallel<T>::pack(const std::vector<AMRange<T> > &sorted, unsigned threads)
+    {
+        unsigned count = threadCount(sorted.size(), threads);
+        std::vector<Part> parts(count);
+        run(count, [&](unsigned i) {
+            const AMRange<T> *first = sorted.data() + sorted.size() * i / count;
+            const AMRange<T> *last = sorted.data() + sorted.size() * (i + 1) / count;
+            parts[i].reserve(last - first);
+            AMCore::unite(first, last, last, last, std::back_inserter(parts[i]));
+        });
+        return stitch(parts);
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMRangeParallel<T>::fromUnsorted(std::vector<AMRange<T> > &ranges, unsigned threads)
+    {
+        unsigned count = threadCount(ranges.size(), threads);
+        if (count == 1) {
+            return AMRangeSet<T>::fromUnsorted(ranges.begin(), ranges.end());
+        }
+        // every thread sorts and packs its chunk, chunk i is &lt; bounds[i], ends[i] )
+        std::vector<std::size_t> bounds(count + 1);
+        std::vector<std::size_t> ends(count);
+        for (unsigned i = 0; i <= count; i++) {
+            bounds[i] = ranges.size() * i / count;
+        }
+        run(count, [&](unsigned i) {
+            ends[i] = sortAndPack(ranges.begin() + bounds[i], ranges.begin() + bounds[i + 1]) - ranges.begin();
+        });
+        // split points are quantiles of left bounds sampled evenly from every chunk
+        std::vector<T> samples;
+        for (unsigned i = 0; i < count; i++) {
+            std::size_t size = ends[i] - bounds[i];
+            for (unsigned j = 1; j < count && size > 0; j++) {
+                samples.push_back(ranges[bounds[i] + size * j / count].from);
+            }
+        }
+        std::sort(samples.begin(), samples.end());
+        std::vector<T> points;
+        for (std::size_t j = count / 2; j < samples.size(); j += count) {
+            if (points.empty() || samples[j] > points.back()) {
+                points.push_back(samples[j]);
+            }
+        }
+        unsigned windows = static_cast<unsigned>(points.size() + 1);
+        std::vector<Part> parts(windows);
+        run(windows, [&](unsigned w) {
+            Part &part = parts[w];
+            for (unsigned i = 0; i < count; i++) {
+                std::pair<const AMRange<T> *, const AMRange<T> *> s =
+                    slice(ranges.data() + bounds[i], ranges.data() + ends[i], points, w);
+                part.insert(part.end(), s.first, s.second);
+            }
+            sortAndPack(part);
+            clip(part, points, w);
+        });
+        return stitch(parts);
+    }
+
+    template<typename T>
+    template<typename Op>
+    AMRangeSet<T> AMRangeParallel<T>::binary(const AMRangeSet<T> &left, const AMRangeSet<T> &right, unsigned threads,
+                                             Op op)
+    {
+        const AMRangeSet<T> &bigger = left.size() >= right.size() ? left : right;
+        unsigned count = threadCount(left.size() + right.size(), threads);
+        std::vector<T> points;
+        for (unsigned i = 1; i < count && !bigger.empty(); i++) {
+            T p = bigger[bigger.size() * i / count].from;
+            if (points.empty() || p > points.back()) {
+                points.push_back(p);
+            }
+        }
+        unsigned windows = static_cast<unsigned>(points.size() + 1);
+        std::vector<Part> parts(windows);
+        run(windows, [&](unsigned w) {
+            std::pair<const AMRange<T> *, const AMRange<T> *> l =
+                slice(left.data(), left.data() + left.size(), points, w);
+            std::pair<const AMRange<T> *, const AMRange<T> *> r =
+                slice(right.data(), right.data() + right.size(), points, w);
+            parts[w].reserve((l.second - l.first) + (r.second - r.first));
+            op(l.first, l.second, r.first, r.second, std::back_inserter(parts[w]));
+            clip(parts[w], points, w);
+        });
+        return stitch(parts);
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMRangeParallel<T>::unite(const AMRangeSet<T> &left, const AMRangeSet<T> &right, unsigned threads)
+    {
+        return binary(left, right, threads, [](const AMRange<T> *first1, const AMRange<T> *last1,
+                                               const AMRange<T> *first2, const AMRange<T> *last2,
+                                               std::back_insert_iterator<Part> out) {
+            AMCore::unite(first1, last1, first2, last2, out);
+        });
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMRangeParallel<T>::subtract(const AMRangeSet<T> &left, const AMRangeSet<T> &right, unsigned threads)
+    {
+        return binary(left, right, threads, [](const AMRange<T> *first1, const AMRange<T> *last1,
+                                               const AMRange<T> *first2, const AMRange<T> *last2,
+                                               std::back_insert_iterator<Part> out) {
+            AMCore::subtract(first1, last1, first2, last2, out);
+        });
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMRangeParallel<T>::intersect(const AMRangeSet<T> &left, const AMRangeSet<T> &right, unsigned threads)
+    {
+        return binary(left, right, threads, [](const AMRange<T> *first1, const AMRange<T> *last1,
+                                               const AMRange<T> *first2, const AMRange<T> *last2,
+                                               std::back_insert_iterator<Part> out) {
+            AMCore::intersect(first1, last1, first2, last2, out);
+        });
+    }
+
+    template<typename T>
+    AMRangeSet<T> AMRangeParallel<T>::symmetricDifference(const AMRangeSet<T> &left, const AMRangeSet<T> &right,
+                                                          unsigned threads)
+    {
+        return binary(left, right, threads, [](const AMRange<T> *first1, const AMRange<T> *last1,
+                                               const AMRange<T> *first2, const AMRange<T> *last2,
+                                               std::back_insert_iterator<Part> out) {
+            AMCore::symmetricDifference(first1, last1, first2, last2, out);
+        });
+    }
+}
+
+/** @} */
+
+#endif //AMCORE_AMRANGEPARALLEL_H
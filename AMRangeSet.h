@@ -0,0 +1,1407 @@
+/**
+ * @file: AMRangeSet.h
+ * Flat set of ranges
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMRANGESET_H
+#define AMCORE_AMRANGESET_H
+
+#include "AMRange.h"
+#include <vector>
+#include <initializer_list>
+#include <type_traits>
+#include <cstdint>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+/**
+ *  @brief minimal ratio of left to right operand size, from which set of ranges is added in place
+ */
+#ifndef AMRANGE_SPARSE_MERGE_RATIO
+#define AMRANGE_SPARSE_MERGE_RATIO 16
+#endif
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    template<typename T>
+    class AMStagedRangeSet;
+
+    /**
+     *  @ingroup Common
+     *  @brief Flat set of ranges
+     *
+     *  Set of ranges stored in sorted contiguous array. Set is always packed, e.q. ranges are nonempty,
+     *  second range starts above first range end, third range starts above second range end etc...
+     *  Semantics of operations is the same as for std::set<AMRange<T> > in AMRange.h, however there is
+     *  one allocation per set instead of one allocation per range and traversal is linear in memory.
+     *
+     *  Empty and invalid ranges are dropped on insertion.
+     *
+     *  Total length of ranges is kept by every operation, so measure() like size() takes O(1) time.
+     *
+     *  Storage is allocated by Alloc. Sets produced by operations are allocated by allocator of left operand
+     *  (or of the set operand, when other operand is range), so with pmr::AMRangeSet backed by monotonic arena
+     *  all results and temporaries of one request can be freed at once by releasing the arena.
+     */
+    template<typename T, typename Alloc = std::allocator<AMRange<T> > >
+    class AMRangeSet
+    {
+    public:
+        /**
+         *  @brief iterator type
+         *  Ranges cannot be modified thru iterator, it would break packed invariant.
+         */
+        typedef typename std::vector<AMRange<T>, Alloc>::const_iterator const_iterator;
+        /**
+         *  @brief iterator type
+         */
+        typedef const_iterator iterator;
+        /**
+         *  @brief value type
+         */
+        typedef AMRange<T> value_type;
+        /**
+         *  @brief size type
+         */
+        typedef std::size_t size_type;
+        /**
+         *  @brief allocator type
+         */
+        typedef Alloc allocator_type;
+        /**
+         *  @brief type of total length of ranges
+         */
+        typedef AMRangeMeasure<T> measure_type;
+
+        /**
+         *  @brief index of no range
+         *  Returned by batch lookup for numbers outside set.
+         */
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
+        /**
+         *  @brief empty constructor
+         *  @throw This function will not throw an exception.
+         */
+        AMRangeSet();
+
+        /**
+         *  @brief empty constructor with allocator
+         *  @param alloc allocator of storage
+         *  @throw This function will not throw an exception.
+         */
+        explicit AMRangeSet(const Alloc &alloc);
+
+        /**
+         *  @brief constructor from one range
+         *  If range is empty or invalid, set is empty.
+         *  @param r range
+         *  @param alloc allocator of storage
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet(const AMRange<T> &r, const Alloc &alloc = Alloc());
+
+        /**
+         *  @brief constructor from list of ranges
+         *  Ranges may be in any order and may overlap, result is packed.
+         *  @param l list of ranges
+         *  @param alloc allocator of storage
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet(std::initializer_list<AMRange<T> > l, const Alloc &alloc = Alloc());
+
+        /**
+         *  @brief conversion from set of ranges
+         *  Set of ranges need not to be packed, result is packed.
+         *  @param s set of ranges
+         *  @param alloc allocator of storage
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        explicit AMRangeSet(const AMRangeStdSet<T, Alloc> &s, const Alloc &alloc = Alloc());
+
+        /**
+         *  @brief bulk construction from ranges in any order
+         *  Ranges are copied to contiguous storage, sorted and packed in one linear pass.
+         *  O(n log n) time, single allocation.
+         *  @param first begin of ranges
+         *  @param last end of ranges
+         *  @param alloc allocator of storage
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename InputIt>
+        static AMRangeSet fromUnsorted(InputIt first, InputIt last, const Alloc &alloc = Alloc());
+
+        /**
+         *  @brief bulk construction from ranges in any order
+         *  Vector is sorted and packed in place and becomes storage of set, nothing is allocated.
+         *  @param ranges ranges in any order
+         *  @throw This function will not throw an exception.
+         */
+        static AMRangeSet fromUnsorted(std::vector<AMRange<T>, Alloc> &&ranges);
+
+        /**
+         *  @brief construction from packed ranges
+         *  Vector becomes storage of set as it is, nothing is sorted or allocated.
+         *  @param ranges packed ranges in ascending order, it is not checked
+         *  @throw This function will not throw an exception.
+         */
+        static AMRangeSet fromPacked(std::vector<AMRange<T>, Alloc> &&ranges);
+
+        /**
+         *  @brief conversion to set of ranges
+         *  Returned set of ranges is packed, it is allocated by allocator of this set.
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeStdSet<T, Alloc> toSet() const;
+
+        /**
+         *  @brief allocator of storage
+         *  @throw This function will not throw an exception.
+         */
+        inline allocator_type get_allocator() const;
+
+        /**
+         *  @brief first range
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator begin() const;
+
+        /**
+         *  @brief behind last range
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator end() const;
+
+        /**
+         *  @brief number of ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline size_type size() const;
+
+        /**
+         *  @brief test for empty
+         *  Set is empty when contains no range.
+         *  @throw This function will not throw an exception.
+         */
+        inline bool empty() const;
+
+        /**
+         *  @brief range at index
+         *  @param i index, must be lower than size()
+         *  @throw This function will not throw an exception.
+         */
+        inline const AMRange<T> &operator[](size_type i) const;
+
+        /**
+         *  @brief contiguous array of ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline const AMRange<T> *data() const;
+
+        /**
+         *  @brief remove all ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline void clear();
+
+        /**
+         *  @brief total length of ranges
+         *  Kept up to date by operations, e.q. O(1) time. With floating point bounds it is sum of lengths
+         *  updated by additions and subtractions, so it may differ from fresh sum by rounding.
+         *  @throw This function will not throw an exception.
+         */
+        inline measure_type measure() const;
+
+        /**
+         *  @brief length of longest gap between two ranges
+         *  Single pass, e.q. O(n) time.
+         *  @return zero when there are less than two ranges
+         *  @throw This function will not throw an exception.
+         */
+        measure_type largestGap() const;
+
+        /**
+         *  @brief number of ranges, total length and longest gap
+         *  Single pass for longest gap, e.q. O(n) time.
+         *  @throw This function will not throw an exception.
+         */
+        AMRangeStats<T> stats() const;
+
+        /**
+         *  @brief total length of intersection with range
+         *  Binary search and sum of overlapping ranges, e.q. O(log n + k) time.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        measure_type overlapMeasure(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief comparison operator
+         *  @param right operand
+         *  @throw This function will not throw an exception.
+         */
+        inline bool operator==(const AMRangeSet &right) const;
+
+        /**
+         *  @brief comparison operator
+         *  @param right operand
+         *  @throw This function will not throw an exception.
+         */
+        inline bool operator!=(const AMRangeSet &right) const;
+
+        /**
+         *  @brief find range containing number
+         *  Binary search, e.q. O(log n) time.
+         *  @param num
+         *  @return iterator to range containing num or end()
+         *  @throw This function will not throw an exception.
+         */
+        const_iterator find(T num) const;
+
+        /**
+         *  @brief test that range is fully covered
+         *  Empty range is always covered. Binary search, e.q. O(log n) time.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool covers(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief test that range has nonempty intersection with set
+         *  Binary search, e.q. O(log n) time.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool overlaps(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief ranges having nonempty intersection with range
+         *  Binary search, e.q. O(log n) time, hits are iterated by returned iterators.
+         *  @param rng range
+         *  @return first and behind last overlapping range
+         *  @throw This function will not throw an exception.
+         */
+        std::pair<const_iterator, const_iterator> overlapping(const AMRange<T> &rng) const;
+
+        /**
+         *  @brief find ranges containing numbers in batch
+         *  For every number writes index of range containing it or npos.
+         *  Sorted numbers (ascending) are looked up by galloping from previous hit, so batch costs
+         *  O(count * log(distance)). Unsorted numbers are looked up by branch free binary search,
+         *  with AVX2 eight numbers and with SSE4.1 four numbers are searched at once when T is 32 bit integer.
+         *  If numbers claimed sorted are not, result is still correct but slower.
+         *  @param nums array of numbers
+         *  @param count number of numbers
+         *  @param indices output array of count indices
+         *  @param sorted numbers are sorted in ascending order
+         *  @throw This function will not throw an exception.
+         */
+        void findBatch(const T *nums, size_type count, size_type *indices, bool sorted = false) const;
+
+        /**
+         *  @brief plus operator
+         *  Adds range in place.
+         *  Ranges overlapping or touching added range are found by binary search and merged.
+         *  @param right range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet &operator+=(const AMRange<T> &right);
+
+        /**
+         *  @brief minus operator
+         *  Subtracts range in place.
+         *  Ranges overlapping subtracted range are found by binary search and cut.
+         *  @param right range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet &operator-=(const AMRange<T> &right);
+
+        /**
+         *  @brief and operator
+         *  Intersects with range in place.
+         *  @param right range
+         *  @throw This function will not throw an exception.
+         */
+        AMRangeSet &operator&=(const AMRange<T> &right);
+
+        /**
+         *  @brief plus operator
+         *  Adds set of ranges in place.
+         *  When right set is at least AMRANGE_SPARSE_MERGE_RATIO times smaller, ranges touched by each right range
+         *  are found by binary search and only they are rewritten, other ranges are moved at most once,
+         *  e.q. O(m log n) comparisons. Otherwise both sets are merged in single pass, e.q. O(n + m) time.
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet &operator+=(const AMRangeSet &right);
+
+        /**
+         *  @brief minus operator
+         *  Subtracts set of ranges in place.
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet &operator-=(const AMRangeSet &right);
+
+        /**
+         *  @brief and operator
+         *  Intersects with set of ranges in place.
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet &operator&=(const AMRangeSet &right);
+
+        /**
+         *  @brief union of two sorted packed arrays of ranges
+         *  @param left set of ranges
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static AMRangeSet unite(const AMRangeSet &left, const AMRangeSet &right);
+
+        /**
+         *  @brief difference of two sorted packed arrays of ranges
+         *  @param left set of ranges
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static AMRangeSet subtract(const AMRangeSet &left, const AMRangeSet &right);
+
+        /**
+         *  @brief intersection of two sorted packed arrays of ranges
+         *  @param left set of ranges
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static AMRangeSet intersect(const AMRangeSet &left, const AMRangeSet &right);
+
+        /**
+         *  @brief symmetric difference of two sorted packed arrays of ranges
+         *  @param left set of ranges
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static AMRangeSet symmetricDifference(const AMRangeSet &left, const AMRangeSet &right);
+
+        /**
+         *  @brief complement of sorted packed array of ranges within universe
+         *  @param s set of ranges
+         *  @param universe bounding range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static AMRangeSet complement(const AMRangeSet &s, const AMRange<T> &universe);
+
+        /**
+         *  @brief total length of intersection
+         *  Intersection is not built. Ranges of much smaller set are looked up in the other one,
+         *  otherwise both sets are merged in one pass.
+         *  @param left set of ranges
+         *  @param right set of ranges
+         *  @throw This function will not throw an exception.
+         */
+        static measure_type overlapMeasure(const AMRangeSet &left, const AMRangeSet &right);
+
+    private:
+        //staged set merges its dirty regions by replaceWindows
+        template<typename U>
+        friend class AMStagedRangeSet;
+
+        typedef typename std::vector<AMRange<T>, Alloc>::iterator mutable_iterator;
+
+        /**
+         *  @brief ranges [first, last) replaced by count new ranges
+         */
+        struct Window
+        {
+            size_type first;
+            size_type last;
+            size_type count;
+        };
+
+        /**
+         *  @brief first range which ends at or above num
+         *  @param num
+         *  @throw This function will not throw an exception.
+         */
+        inline mutable_iterator endingFrom(T num);
+
+        /**
+         *  @brief first range which ends above num
+         *  @param num
+         *  @throw This function will not throw an exception.
+         */
+        inline mutable_iterator endingAbove(T num);
+
+        /**
+         *  @brief first range which starts at or above num
+         *  @param num
+         *  @throw This function will not throw an exception.
+         */
+        inline mutable_iterator startingFrom(T num);
+
+        /**
+         *  @brief index of first range which ends above num, branch free
+         *  @param num
+         *  @throw This function will not throw an exception.
+         */
+        inline size_type branchFreeSearch(T num) const;
+
+        /**
+         *  @brief batch lookup of sorted numbers
+         *  @throw This function will not throw an exception.
+         */
+        void findSortedBatch(const T *nums, size_type count, size_type *indices) const;
+
+        /**
+         *  @brief batch lookup of unsorted numbers
+         *  @throw This function will not throw an exception.
+         */
+        void findUnsortedBatch(const T *nums, size_type count, size_type *indices) const;
+
+        /**
+         *  @brief add few ranges in place
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails, set is unchanged then.
+         */
+        void uniteSparse(const AMRangeSet &right);
+
+        /**
+         *  @brief replace windows of ranges in one pass
+         *  Windows are sorted and disjoint, new ranges of all windows follow each other in ranges array
+         *  and they must keep set packed. Ranges between windows are moved once, e.q. O(n) time at worst
+         *  and O(new ranges) time when number of ranges does not change.
+         *  @param windows windows
+         *  @param count number of windows
+         *  @param ranges new ranges
+         *  @throw std::bad_alloc if allocation fails, set is unchanged then.
+         */
+        void replaceWindows(const Window *windows, size_type count, const AMRange<T> *ranges);
+
+        /**
+         *  @brief sort and pack ranges in place
+         *  @throw This function will not throw an exception.
+         */
+        void normalize();
+
+        /**
+         *  @brief recompute total length of ranges
+         *  @throw This function will not throw an exception.
+         */
+        void sumMeasure();
+
+        std::vector<AMRange<T>, Alloc> mRanges;
+        measure_type mMeasure;
+    };
+
+#if __has_include(<memory_resource>)
+    namespace pmr {
+        /**
+         *  @brief flat set of ranges with polymorphic allocator
+         *  Memory resource is passed to constructor, e.q. pmr::AMRangeSet&lt;int&gt;(&arena).
+         */
+        template<typename T>
+        using AMRangeSet = AMCore::AMRangeSet<T, std::pmr::polymorphic_allocator<AMRange<T> > >;
+    }
+#endif
+
+    /**
+     *  @brief plus operator
+     *  Adds two sets of ranges.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator+(const AMRangeSet<T, Alloc> &left, const AMRangeSet<T, Alloc> &right);
+    /**
+     *  @brief minus operator
+     *  Subtracts two sets of ranges.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator-(const AMRangeSet<T, Alloc> &left, const AMRangeSet<T, Alloc> &right);
+    /**
+     *  @brief plus operator
+     *  Adds range and set of ranges.
+     *  @param left range
+     *  @param right set of ranges
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator+(const AMRange<T> &left, const AMRangeSet<T, Alloc> &right);
+    /**
+     *  @brief minus operator
+     *  Subtracts set of ranges from range.
+     *  @param left range
+     *  @param right set of ranges
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator-(const AMRange<T> &left, const AMRangeSet<T, Alloc> &right);
+    /**
+     *  @brief plus operator
+     *  Adds set of ranges and range.
+     *  @param left set of ranges
+     *  @param right range
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator+(const AMRangeSet<T, Alloc> &left, const AMRange<T> &right);
+    /**
+     *  @brief minus operator
+     *  Subtracts range from set of ranges.
+     *  @param left set of ranges
+     *  @param right range
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator-(const AMRangeSet<T, Alloc> &left, const AMRange<T> &right);
+    /**
+     *  @brief and operator
+     *  Intersection of two sets of ranges.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator&(const AMRangeSet<T, Alloc> &left, const AMRangeSet<T, Alloc> &right);
+    /**
+     *  @brief and operator
+     *  Intersection of range and set of ranges.
+     *  @param left range
+     *  @param right set of ranges
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator&(const AMRange<T> &left, const AMRangeSet<T, Alloc> &right);
+    /**
+     *  @brief and operator
+     *  Intersection of set of ranges and range.
+     *  @param left set of ranges
+     *  @param right range
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator&(const AMRangeSet<T, Alloc> &left, const AMRange<T> &right);
+    /**
+     *  @brief symmetric difference
+     *  Ranges covered by exactly one of two sets of ranges.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> symmetricDifference(const AMRangeSet<T, Alloc> &left, const AMRangeSet<T, Alloc> &right);
+    /**
+     *  @brief xor operator
+     *  Symmetric difference of two sets of ranges.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator^(const AMRangeSet<T, Alloc> &left, const AMRangeSet<T, Alloc> &right);
+    /**
+     *  @brief complement
+     *  Gaps of set of ranges inside universe, e.q. universe - s
+     *  @param s set of ranges
+     *  @param universe bounding range
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> complement(const AMRangeSet<T, Alloc> &s, const AMRange<T> &universe);
+    /**
+     *  @brief total length of intersection
+     *  Same as (left & right).measure(), but intersection is not built.
+     *  @param left set of ranges
+     *  @param right set of ranges
+     *  @throw This function will not throw an exception.
+     */
+    template<typename T, typename Alloc>
+    AMRangeMeasure<T> overlapMeasure(const AMRangeSet<T, Alloc> &left, const AMRangeSet<T, Alloc> &right);
+
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc>::AMRangeSet()
+        : mRanges(),
+          mMeasure()
+    {
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc>::AMRangeSet(const Alloc &alloc)
+        : mRanges(alloc),
+          mMeasure()
+    {
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc>::AMRangeSet(const AMRange<T> &r, const Alloc &alloc)
+        : mRanges(alloc),
+          mMeasure(AMCore::measure(r))
+    {
+        if (r.nonEmpty()) {
+            mRanges.push_back(r);
+        }
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc>::AMRangeSet(std::initializer_list<AMRange<T> > l, const Alloc &alloc)
+        : mRanges(l, alloc),
+          mMeasure()
+    {
+        normalize();
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc>::AMRangeSet(const AMRangeStdSet<T, Alloc> &s, const Alloc &alloc)
+        : mRanges(s.begin(), s.end(), alloc),
+          mMeasure()
+    {
+        normalize();
+    }
+
+    template<typename T, typename Alloc>
+    template<typename InputIt>
+    AMRangeSet<T, Alloc> AMRangeSet<T, Alloc>::fromUnsorted(InputIt first, InputIt last, const Alloc &alloc)
+    {
+        AMRangeSet<T, Alloc> result(alloc);
+        result.mRanges.assign(first, last);
+        result.normalize();
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> AMRangeSet<T, Alloc>::fromUnsorted(std::vector<AMRange<T>, Alloc> &&ranges)
+    {
+        AMRangeSet<T, Alloc> result(ranges.get_allocator());
+        result.mRanges = std::move(ranges);
+        result.normalize();
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> AMRangeSet<T, Alloc>::fromPacked(std::vector<AMRange<T>, Alloc> &&ranges)
+    {
+        AMRangeSet<T, Alloc> result(ranges.get_allocator());
+        result.mRanges = std::move(ranges);
+        result.sumMeasure();
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStdSet<T, Alloc> AMRangeSet<T, Alloc>::toSet() const
+    {
+        return AMRangeStdSet<T, Alloc>(mRanges.begin(), mRanges.end(), mRanges.get_allocator());
+    }
+
+    template<typename T, typename Alloc>
+    inline typename AMRangeSet<T, Alloc>::allocator_type AMRangeSet<T, Alloc>::get_allocator() const
+    {
+        return mRanges.get_allocator();
+    }
+
+    template<typename T, typename Alloc>
+    inline typename AMRangeSet<T, Alloc>::const_iterator AMRangeSet<T, Alloc>::begin() const
+    {
+        return mRanges.begin();
+    }
+
+    template<typename T, typename Alloc>
+    inline typename AMRangeSet<T, Alloc>::const_iterator AMRangeSet<T, Alloc>::end() const
+    {
+        return mRanges.end();
+    }
+
+    template<typename T, typename Alloc>
+    inline typename AMRangeSet<T, Alloc>::size_type AMRangeSet<T, Alloc>::size() const
+    {
+        return mRanges.size();
+    }
+
+    template<typename T, typename Alloc>
+    inline bool AMRangeSet<T, Alloc>::empty() const
+    {
+        return mRanges.empty();
+    }
+
+    template<typename T, typename Alloc>
+    inline const AMRange<T> &AMRangeSet<T, Alloc>::operator[](size_type i) const
+    {
+        return mRanges[i];
+    }
+
+    template<typename T, typename Alloc>
+    inline const AMRange<T> *AMRangeSet<T, Alloc>::data() const
+    {
+        return mRanges.data();
+    }
+
+    template<typename T, typename Alloc>
+    inline void AMRangeSet<T, Alloc>::clear()
+    {
+        mRanges.clear();
+        mMeasure = measure_type();
+    }
+
+    template<typename T, typename Alloc>
+    inline typename AMRangeSet<T, Alloc>::measure_type AMRangeSet<T, Alloc>::measure() const
+    {
+        return mMeasure;
+    }
+
+    template<typename T, typename Alloc>
+    typename AMRangeSet<T, Alloc>::measure_type AMRangeSet<T, Alloc>::largestGap() const
+    {
+        return stats().largestGap;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeStats<T> AMRangeSet<T, Alloc>::stats() const
+    {
+        AMRangeStats<T> result = {mRanges.size(), mMeasure, measure_type()};
+        for (size_type i = 1; i < mRanges.size(); i++) {
+            measure_type gap = AMCore::measure(AMRange<T>(mRanges[i - 1].to, mRanges[i].from));
+            if (gap > result.largestGap) {
+                result.largestGap = gap;
+            }
+        }
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    typename AMRangeSet<T, Alloc>::measure_type AMRangeSet<T, Alloc>::overlapMeasure(const AMRange<T> &rng) const
+    {
+        std::pair<const_iterator, const_iterator> hits = overlapping(rng);
+        measure_type sum = measure_type();
+        for (const_iterator it = hits.first; it != hits.second; it++) {
+            sum += AMCore::measure(AMCore::intersect(*it, rng));
+        }
+        return sum;
+    }
+
+    template<typename T, typename Alloc>
+    inline bool AMRangeSet<T, Alloc>::operator==(const AMRangeSet<T, Alloc> &right) const
+    {
+        return mRanges == right.mRanges;
+    }
+
+    template<typename T, typename Alloc>
+    inline bool AMRangeSet<T, Alloc>::operator!=(const AMRangeSet<T, Alloc> &right) const
+    {
+        return mRanges != right.mRanges;
+    }
+
+    template<typename T, typename Alloc>
+    typename AMRangeSet<T, Alloc>::const_iterator AMRangeSet<T, Alloc>::find(T num) const
+    {
+        const_iterator it = std::partition_point(mRanges.begin(), mRanges.end(),
+                                                 [num](const AMRange<T> &r) { return r.to <= num; });
+        if (it != mRanges.end() && it->from <= num) {
+            return it;
+        }
+        return mRanges.end();
+    }
+
+    template<typename T, typename Alloc>
+    bool AMRangeSet<T, Alloc>::covers(const AMRange<T> &rng) const
+    {
+        if (!rng.nonEmpty()) {
+            return true;
+        }
+        const_iterator it = find(rng.from);
+        return it != mRanges.end() && it->to >= rng.to;
+    }
+
+    template<typename T, typename Alloc>
+    bool AMRangeSet<T, Alloc>::overlaps(const AMRange<T> &rng) const
+    {
+        const_iterator it = overlapping(rng).first;
+        return rng.nonEmpty() && it != mRanges.end() && it->from < rng.to;
+    }
+
+    template<typename T, typename Alloc>
+    std::pair<typename AMRangeSet<T, Alloc>::const_iterator, typename AMRangeSet<T, Alloc>::const_iterator>
+    AMRangeSet<T, Alloc>::overlapping(const AMRange<T> &rng) const
+    {
+        const_iterator first = std::partition_point(mRanges.begin(), mRanges.end(),
+                                                    [&rng](const AMRange<T> &r) { return r.to <= rng.from; });
+        if (!rng.nonEmpty()) {
+            return std::make_pair(first, first);
+        }
+        const_iterator last = std::partition_point(first, mRanges.end(),
+                                                   [&rng](const AMRange<T> &r) { return r.from < rng.to; });
+        return std::make_pair(first, last);
+    }
+
+    template<typename T, typename Alloc>
+    void AMRangeSet<T, Alloc>::findBatch(const T *nums, size_type count, size_type *indices, bool sorted) const
+    {
+        if (mRanges.empty()) {
+            std::fill(indices, indices + count, npos);
+        } else if (sorted) {
+            findSortedBatch(nums, count, indices);
+        } else {
+            findUnsortedBatch(nums, count, indices);
+        }
+    }
+
+    template<typename T, typename Alloc>
+    void AMRangeSet<T, Alloc>::findSortedBatch(const T *nums, size_type count, size_type *indices) const
+    {
+        const AMRange<T> *r = mRanges.data();
+        size_type n = mRanges.size();
+        size_type pos = 0;
+        for (size_type i = 0; i < count; i++) {
+            T num = nums[i];
+            if (i > 0 && num < nums[i - 1]) {
+                pos = 0;
+            }
+            // gallop to bracket first range which ends above num, then binary search inside
+            size_type lo = pos;
+            size_type step = 1;
+            while (lo + step < n && r[lo + step].to <= num) {
+                lo += step;
+                step <<= 1;
+            }
+            size_type hi = lo + step < n ? lo + step : n;
+            while (lo < hi) {
+                size_type mid = lo + (hi - lo) / 2;
+                if (r[mid].to <= num) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            pos = lo;
+            indices[i] = (lo < n && r[lo].from <= num) ? lo : npos;
+        }
+    }
+
+    template<typename T, typename Alloc>
+    inline typename AMRangeSet<T, Alloc>::size_type AMRangeSet<T, Alloc>::branchFreeSearch(T num) const
+    {
+        const AMRange<T> *base = mRanges.data();
+        size_type n = mRanges.size();
+        while (n > 1) {
+            size_type half = n / 2;
+            base = (base[half].to <= num) ? base + half : base;
+            n -= half;
+        }
+        return (base - mRanges.data()) + (base->to <= num);
+    }
+
+    template<typename T, typename Alloc>
+    void AMRangeSet<T, Alloc>::findUnsortedBatch(const T *nums, size_type count, size_type *indices) const
+    {
+        const AMRange<T> *r = mRanges.data();
+        size_type n = mRanges.size();
+        size_type i = 0;
+#ifdef __AVX2__
+        if constexpr (std::is_integral<T>::value && sizeof(T) == 4 && sizeof(size_type) == 8) {
+            static_assert(sizeof(AMRange<T>) == 2 * sizeof(T), "AMRange must not be padded");
+            const int *from = reinterpret_cast<const int *>(r);
+            const int *to = from + 1;
+            // unsigned numbers are compared as signed with flipped sign bit
+            const __m256i bias = _mm256_set1_epi32(std::is_signed<T>::value ? 0 : INT32_MIN);
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i last = _mm256_set1_epi32(static_cast<int>(n - 1));
+            for (; n > 0 && n < 0x7fffffff && i + 8 <= count; i += 8) {
+                __m256i num = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(nums + i)), bias);
+                __m256i base = _mm256_setzero_si256();
+                size_type len = n;
+                while (len > 1) {
+                    size_type half = len / 2;
+                    __m256i mid = _mm256_add_epi32(base, _mm256_set1_epi32(static_cast<int>(half)));
+                    __m256i t = _mm256_xor_si256(_mm256_i32gather_epi32(to, _mm256_add_epi32(mid, mid), 4), bias);
+                    __m256i below = _mm256_xor_si256(_mm256_cmpgt_epi32(t, num), _mm256_set1_epi32(-1));
+                    base = _mm256_blendv_epi8(base, mid, below);
+                    len -= half;
+                }
+                __m256i t = _mm256_xor_si256(_mm256_i32gather_epi32(to, _mm256_add_epi32(base, base), 4), bias);
+                base = _mm256_sub_epi32(base, _mm256_xor_si256(_mm256_cmpgt_epi32(t, num), _mm256_set1_epi32(-1)));
+                __m256i clamped = _mm256_min_epi32(base, last);
+                t = _mm256_xor_si256(_mm256_i32gather_epi32(to, _mm256_add_epi32(clamped, clamped), 4), bias);
+                __m256i f = _mm256_xor_si256(_mm256_i32gather_epi32(from, _mm256_add_epi32(clamped, clamped), 4), bias);
+                __m256i inside = _mm256_andnot_si256(_mm256_cmpgt_epi32(f, num), _mm256_cmpgt_epi32(t, num));
+                inside = _mm256_and_si256(inside, _mm256_cmpgt_epi32(_mm256_add_epi32(last, one), base));
+                // npos is all ones, it is sign extended from -1
+                __m256i idx = _mm256_blendv_epi8(_mm256_set1_epi32(-1), base, inside);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(indices + i),
+                                    _mm256_cvtepi32_epi64(_mm256_castsi256_si128(idx)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(indices + i + 4),
+                                    _mm256_cvtepi32_epi64(_mm256_extracti128_si256(idx, 1)));
+            }
+        }
+#elif defined(__SSE4_1__)
+        if constexpr (std::is_integral<T>::value && sizeof(T) == 4 && sizeof(size_type) == 8) {
+            static_assert(sizeof(AMRange<T>) == 2 * sizeof(T), "AMRange must not be padded");
+            const int *from = reinterpret_cast<const int *>(r);
+            const int *to = from + 1;
+            // there is no gather in SSE, four independent loads still overlap their cache misses
+            auto gather = [](const int *bounds, __m128i idx) {
+                return _mm_setr_epi32(bounds[2 * _mm_extract_epi32(idx, 0)], bounds[2 * _mm_extract_epi32(idx, 1)],
+                                      bounds[2 * _mm_extract_epi32(idx, 2)], bounds[2 * _mm_extract_epi32(idx, 3)]);
+            };
+            // unsigned numbers are compared as signed with flipped sign bit
+            const __m128i bias = _mm_set1_epi32(std::is_signed<T>::value ? 0 : INT32_MIN);
+            const __m128i one = _mm_set1_epi32(1);
+            const __m128i last = _mm_set1_epi32(static_cast<int>(n - 1));
+            for (; n > 0 && n < 0x7fffffff && i + 4 <= count; i += 4) {
+                __m128i num = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(nums + i)), bias);
+                __m128i base = _mm_setzero_si128();
+                size_type len = n;
+                while (len > 1) {
+                    size_type half = len / 2;
+                    __m128i mid = _mm_add_epi32(base, _mm_set1_epi32(static_cast<int>(half)));
+                    __m128i t = _mm_xor_si128(gather(to, mid), bias);
+                    __m128i below = _mm_xor_si128(_mm_cmpgt_epi32(t, num), _mm_set1_epi32(-1));
+                    base = _mm_blendv_epi8(base, mid, below);
+                    len -= half;
+                }
+                __m128i t = _mm_xor_si128(gather(to, base), bias);
+                base = _mm_sub_epi32(base, _mm_xor_si128(_mm_cmpgt_epi32(t, num), _mm_set1_epi32(-1)));
+                __m128i clamped = _mm_min_epi32(base, last);
+                t = _mm_xor_si128(gather(to, clamped), bias);
+                __m128i f = _mm_xor_si128(gather(from, clamped), bias);
+                __m128i inside = _mm_andnot_si128(_mm_cmpgt_epi32(f, num), _mm_cmpgt_epi32(t, num));
+                inside = _mm_and_si128(inside, _mm_cmpgt_epi32(_mm_add_epi32(last, one), base));
+                // npos is all ones, it is sign extended from -1
+                __m128i idx = _mm_blendv_epi8(_mm_set1_epi32(-1), base, inside);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(indices + i), _mm_cvtepi32_epi64(idx));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(indices + i + 2), _mm_cvtepi32_epi64(_mm_srli_si128(idx, 8)));
+            }
+        }
+#endif
+        for (; i < count; i++) {
+            size_type idx = branchFreeSearch(nums[i]);
+            indices[i] = (idx < n && r[idx].from <= nums[i]) ? idx : npos;
+        }
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> &AMRangeSet<T, Alloc>::operator+=(const AMRange<T> &right)
+    {
+        if (!right.nonEmpty()) {
+            return *this;
+        }
+        mutable_iterator first = endingFrom(right.from);
+        mutable_iterator last = first;
+        while (last != mRanges.end() && last->from <= right.to) {
+            last++;
+        }
+        if (first == last) {
+            mRanges.insert(first, right);
+            mMeasure += AMCore::measure(right);
+            return *this;
+        }
+        for (const_iterator it = first; it != last; it++) {
+            mMeasure -= AMCore::measure(*it);
+        }
+        if (first->from > right.from) {
+            first->from = right.from;
+        }
+        first->to = (last - 1)->to > right.to ? (last - 1)->to : right.to;
+        mMeasure += AMCore::measure(*first);
+        mRanges.erase(first + 1, last);
+        return *this;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> &AMRangeSet<T, Alloc>::operator-=(const AMRange<T> &right)
+    {
+        if (!right.nonEmpty()) {
+            return *this;
+        }
+        mutable_iterator first = endingAbove(right.from);
+        mutable_iterator last = first;
+        while (last != mRanges.end() && last->from < right.to) {
+            last++;
+        }
+        if (first == last) {
+            return *this;
+        }
+        AMRange<T> head(first->from, right.from);
+        AMRange<T> tail(right.to, (last - 1)->to);
+        for (const_iterator it = first; it != last; it++) {
+            mMeasure -= AMCore::measure(*it);
+        }
+        mMeasure += AMCore::measure(head) + AMCore::measure(tail);
+        if (head.nonEmpty() && tail.nonEmpty() && last - first == 1) {
+            *first = tail;
+            mRanges.insert(first, head);
+            return *this;
+        }
+        mutable_iterator out = first;
+        if (head.nonEmpty()) {
+            *out = head;
+            out++;
+        }
+        if (tail.nonEmpty()) {
+            *out = tail;
+            out++;
+        }
+        mRanges.erase(out, last);
+        return *this;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> &AMRangeSet<T, Alloc>::operator&=(const AMRange<T> &right)
+    {
+        if (!right.nonEmpty()) {
+            clear();
+            return *this;
+        }
+        mutable_iterator last = startingFrom(right.to);
+        for (const_iterator it = last; it != mRanges.end(); it++) {
+            mMeasure -= AMCore::measure(*it);
+        }
+        mRanges.erase(last, mRanges.end());
+        mutable_iterator first = endingAbove(right.from);
+        for (const_iterator it = mRanges.begin(); it != first; it++) {
+            mMeasure -= AMCore::measure(*it);
+        }
+        mRanges.erase(mRanges.begin(), first);
+        if (!mRanges.empty()) {
+            mMeasure -= AMCore::measure(mRanges.front());
+            if (mRanges.size() > 1) {
+                mMeasure -= AMCore::measure(mRanges.back());
+            }
+            if (mRanges.front().from < right.from) {
+                mRanges.front().from = right.from;
+            }
+            if (mRanges.back().to > right.to) {
+                mRanges.back().to = right.to;
+            }
+            mMeasure += AMCore::measure(mRanges.front());
+            if (mRanges.size() > 1) {
+                mMeasure += AMCore::measure(mRanges.back());
+            }
+        }
+        return *this;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> &AMRangeSet<T, Alloc>::operator+=(const AMRangeSet<T, Alloc> &right)
+    {
+        if (right.size() == 1) {
+            return *this += right[0];
+        }
+        if (right.empty()) {
+            return *this;
+        }
+        if (right.size() * AMRANGE_SPARSE_MERGE_RATIO <= size()) {
+            uniteSparse(right);
+            return *this;
+        }
+        *this = unite(*this, right);
+        return *this;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> &AMRangeSet<T, Alloc>::operator-=(const AMRangeSet<T, Alloc> &right)
+    {
+        if (right.size() == 1) {
+            return *this -= right[0];
+        }
+        *this = subtract(*this, right);
+        return *this;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> &AMRangeSet<T, Alloc>::operator&=(const AMRangeSet<T, Alloc> &right)
+    {
+        if (right.size() == 1) {
+            return *this &= right[0];
+        }
+        *this = intersect(*this, right);
+        return *this;
+    }
+
+    template<typename T, typename Alloc>
+    inline typename AMRangeSet<T, Alloc>::mutable_iterator AMRangeSet<T, Alloc>::endingFrom(T num)
+    {
+        return std::partition_point(mRanges.begin(), mRanges.end(),
+                                    [num](const AMRange<T> &r) { return r.to < num; });
+    }
+
+    template<typename T, typename Alloc>
+    inline typename AMRangeSet<T, Alloc>::mutable_iterator AMRangeSet<T, Alloc>::endingAbove(T num)
+    {
+        return std::partition_point(mRanges.begin(), mRanges.end(),
+                                    [num](const AMRange<T> &r) { return r.to <= num; });
+    }
+
+    template<typename T, typename Alloc>
+    inline typename AMRangeSet<T, Alloc>::mutable_iterator AMRangeSet<T, Alloc>::startingFrom(T num)
+    {
+        return std::partition_point(mRanges.begin(), mRanges.end(),
+                                    [num](const AMRange<T> &r) { return r.from < num; });
+    }
+
+    template<typename T, typename Alloc>
+    void AMRangeSet<T, Alloc>::uniteSparse(const AMRangeSet &right)
+    {
+        //ranges of each window are replaced by single joined range
+        typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Window> WindowAlloc;
+        std::vector<Window, WindowAlloc> windows{WindowAlloc(mRanges.get_allocator())};
+        std::vector<AMRange<T>, Alloc> joined(mRanges.get_allocator());
+        windows.reserve(right.size());
+        joined.reserve(right.size());
+        mutable_iterator from = mRanges.begin();
+        for (const AMRange<T> &r : right) {
+            mutable_iterator first = std::partition_point(from, mRanges.end(),
+                                                          [&r](const AMRange<T> &l) { return l.to < r.from; });
+            mutable_iterator last = std::partition_point(first, mRanges.end(),
+                                                         [&r](const AMRange<T> &l) { return l.from <= r.to; });
+            AMRange<T> j = r;
+            if (first != last) {
+                j.from = std::min(j.from, first->from);
+                j.to = std::max(j.to, (last - 1)->to);
+            }
+            size_type at = first - mRanges.begin();
+            if (!windows.empty() && at < windows.back().last) {
+                //range of left set spans two right ranges
+                windows.back().last = last - mRanges.begin();
+                joined.back().to = j.to;
+            } else {
+                windows.push_back(Window{at, size_type(last - mRanges.begin()), 1});
+                joined.push_back(j);
+            }
+            from = first;
+        }
+        replaceWindows(windows.data(), windows.size(), joined.data());
+    }
+
+    template<typename T, typename Alloc>
+    void AMRangeSet<T, Alloc>::replaceWindows(const Window *windows, size_type count, const AMRange<T> *ranges)
+    {
+        //shift of ranges following each window
+        size_type n = mRanges.size();
+        std::ptrdiff_t grow = 0;
+        size_type total = 0;
+        for (size_type i = 0; i < count; i++) {
+            grow += std::ptrdiff_t(windows[i].count) - std::ptrdiff_t(windows[i].last - windows[i].first);
+            total += windows[i].count;
+        }
+        if (grow > 0) {
+            mRanges.resize(n + grow);
+        }
+        measure_type measure = mMeasure;
+        for (size_type i = 0; i < count; i++) {
+            for (size_type j = windows[i].first; j < windows[i].last; j++) {
+                measure -= AMCore::measure(mRanges[j]);
+            }
+        }
+        for (size_type i = 0; i < total; i++) {
+            measure += AMCore::measure(ranges[i]);
+        }
+        //ranges between windows keep their order, those moved down are moved from front, those moved up from back
+        std::ptrdiff_t shift = 0;
+        for (size_type i = 0; i < count; i++) {
+            shift += std::ptrdiff_t(windows[i].count) - std::ptrdiff_t(windows[i].last - windows[i].first);
+            size_type end = i + 1 < count ? windows[i + 1].first : n;
+            if (shift < 0) {
+                std::move(mRanges.begin() + windows[i].last, mRanges.begin() + end,
+                          mRanges.begin() + windows[i].last + shift);
+            }
+        }
+        for (size_type i = count; i > 0; i--) {
+            const Window &w = windows[i - 1];
+            std::ptrdiff_t delta = std::ptrdiff_t(w.count) - std::ptrdiff_t(w.last - w.first);
+            shift -= delta;
+            size_type end = i < count ? windows[i].first : n;
+            if (shift + delta > 0) {
+                std::move_backward(mRanges.begin() + w.last, mRanges.begin() + end,
+                                   mRanges.begin() + end + shift + delta);
+            }
+            total -= w.count;
+            std::copy(ranges + total, ranges + total + w.count, mRanges.begin() + w.first + shift);
+        }
+        if (grow < 0) {
+            mRanges.erase(mRanges.end() + grow, mRanges.end());
+        }
+        mMeasure = measure;
+    }
+
+    template<typename T, typename Alloc>
+    void AMRangeSet<T, Alloc>::normalize()
+    {
+        sortAndPack(mRanges);
+        sumMeasure();
+    }
+
+    template<typename T, typename Alloc>
+    void AMRangeSet<T, Alloc>::sumMeasure()
+    {
+        mMeasure = measure_type();
+        for (const AMRange<T> &r : mRanges) {
+            mMeasure += AMCore::measure(r);
+        }
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> AMRangeSet<T, Alloc>::unite(const AMRangeSet &left, const AMRangeSet &right)
+    {
+        AMRangeSet<T, Alloc> result(left.get_allocator());
+        result.mRanges.reserve(left.size() + right.size());
+        AMCore::unite(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(result.mRanges));
+        result.sumMeasure();
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> AMRangeSet<T, Alloc>::subtract(const AMRangeSet &left, const AMRangeSet &right)
+    {
+        AMRangeSet<T, Alloc> result(left.get_allocator());
+        result.mRanges.reserve(left.size() + right.size());
+        AMCore::subtract(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(result.mRanges));
+        result.sumMeasure();
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> AMRangeSet<T, Alloc>::intersect(const AMRangeSet &left, const AMRangeSet &right)
+    {
+        AMRangeSet<T, Alloc> result(left.get_allocator());
+        result.mRanges.reserve(left.size() + right.size());
+        AMCore::intersect(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(result.mRanges));
+        result.sumMeasure();
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> AMRangeSet<T, Alloc>::symmetricDifference(const AMRangeSet &left, const AMRangeSet &right)
+    {
+        AMRangeSet<T, Alloc> result(left.get_allocator());
+        result.mRanges.reserve(left.size() + right.size());
+        AMCore::symmetricDifference(left.begin(), left.end(), right.begin(), right.end(),
+                                    std::back_inserter(result.mRanges));
+        result.sumMeasure();
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> AMRangeSet<T, Alloc>::complement(const AMRangeSet &s, const AMRange<T> &universe)
+    {
+        AMRangeSet<T, Alloc> result(s.get_allocator());
+        result.mRanges.reserve(s.size() + 1);
+        AMCore::complement(s.begin(), s.end(), universe, std::back_inserter(result.mRanges));
+        result.sumMeasure();
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    typename AMRangeSet<T, Alloc>::measure_type AMRangeSet<T, Alloc>::overlapMeasure(const AMRangeSet &left,
+                                                                                  const AMRangeSet &right)
+    {
+        const AMRangeSet &small = left.size() < right.size() ? left : right;
+        const AMRangeSet &large = left.size() < right.size() ? right : left;
+        // binary searches win when they are cheaper than walking the large set
+        if (small.size() * 32 < large.size()) {
+            measure_type sum = measure_type();
+            for (const AMRange<T> &r : small) {
+                sum += large.overlapMeasure(r);
+            }
+            return sum;
+        }
+        return AMCore::overlapMeasure(left.begin(), left.end(), right.begin(), right.end());
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator+(const AMRangeSet<T, Alloc> &left, const AMRangeSet<T, Alloc> &right)
+    {
+        return AMRangeSet<T, Alloc>::unite(left, right);
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator-(const AMRangeSet<T, Alloc> &left, const AMRangeSet<T, Alloc> &right)
+    {
+        return AMRangeSet<T, Alloc>::subtract(left, right);
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator+(const AMRange<T> &left, const AMRangeSet<T, Alloc> &right)
+    {
+        return AMRangeSet<T, Alloc>::unite(AMRangeSet<T, Alloc>(left, right.get_allocator()), right);
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator-(const AMRange<T> &left, const AMRangeSet<T, Alloc> &right)
+    {
+        return AMRangeSet<T, Alloc>::subtract(AMRangeSet<T, Alloc>(left, right.get_allocator()), right);
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator+(const AMRangeSet<T, Alloc> &left, const AMRange<T> &right)
+    {
+        return AMRangeSet<T, Alloc>::unite(left, AMRangeSet<T, Alloc>(right, left.get_allocator()));
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator-(const AMRangeSet<T, Alloc> &left, const AMRange<T> &right)
+    {
+        return AMRangeSet<T, Alloc>::subtract(left, AMRangeSet<T, Alloc>(right, left.get_allocator()));
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator&(const AMRangeSet<T, Alloc> &left, const AMRangeSet<T, Alloc> &right)
+    {
+        return AMRangeSet<T, Alloc>::intersect(left, right);
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator&(const AMRange<T> &left, const AMRangeSet<T, Alloc> &right)
+    {
+        return AMRangeSet<T, Alloc>::intersect(AMRangeSet<T, Alloc>(left, right.get_allocator()), right);
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator&(const AMRangeSet<T, Alloc> &left, const AMRange<T> &right)
+    {
+        return AMRangeSet<T, Alloc>::intersect(left, AMRangeSet<T, Alloc>(right, left.get_allocator()));
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> symmetricDifference(const AMRangeSet<T, Alloc> &left, const AMRangeSet<T, Alloc> &right)
+    {
+        return AMRangeSet<T, Alloc>::symmetricDifference(left, right);
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> operator^(const AMRangeSet<T, Alloc> &left, const AMRangeSet<T, Alloc> &right)
+    {
+        return AMRangeSet<T, Alloc>::symmetricDifference(left, right);
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeSet<T, Alloc> complement(const AMRangeSet<T, Alloc> &s, const AMRange<T> &universe)
+    {
+        return AMRangeSet<T, Alloc>::complement(s, universe);
+    }
+
+    template<typename T, typename Alloc>
+    AMRangeMeasure<T> overlapMeasure(const AMRangeSet<T, Alloc> &left, const AMRangeSet<T, Alloc> &right)
+    {
+        return AMRangeSet<T, Alloc>::overlapMeasure(left, right);
+    }
+}
+
+/** @} */
+
+#endif //AMCORE_AMRANGESET_H
@@ -0,0 +1,544 @@
+/**
+ * @file: AMRangeView.h
+ * Lazy views of set of range operations
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMRANGEVIEW_H
+#define AMCORE_AMRANGEVIEW_H
+
+#include "AMRangeSet.h"
+#include <type_traits>
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Common
+     *  @brief tag of all views, operators of views are enabled for classes derived from it
+     */
+    struct AMRangeViewTag
+    {
+    };
+
+    /**
+     *  @ingroup Common
+     *  @brief Common part of views
+     *
+     *  View is a sequence of packed ranges in ascending order, which is computed while it is iterated.
+     *  Nothing is allocated until view is materialized.
+     */
+    template<typename Derived, typename T>
+    class AMRangeViewBase : public AMRangeViewTag
+    {
+    public:
+        /**
+         *  @brief materialize view
+         *  @param alloc allocator of result
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename Alloc = std::allocator<AMRange<T> > >
+        AMRangeSet<T, Alloc> toRangeSet(const Alloc &alloc = Alloc()) const;
+
+        /**
+         *  @brief materialize view
+         *  Set is built by appending at its end.
+         *  @param alloc allocator of result
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename Alloc = std::allocator<AMRange<T> > >
+        AMRangeStdSet<T, Alloc> toSet(const Alloc &alloc = Alloc()) const;
+    };
+
+    /**
+     *  @ingroup Common
+     *  @brief View of packed container
+     *
+     *  Container is referenced by its iterators, it must outlive the view and it must not be changed.
+     */
+    template<typename It>
+    class AMRangeRefView : public AMRangeViewBase<AMRangeRefView<It>,
+                                                  typename std::iterator_traits<It>::value_type::value_type>
+    {
+    public:
+        /**
+         *  @brief iterator type
+         */
+        typedef It const_iterator;
+        /**
+         *  @brief value type
+         */
+        typedef typename std::iterator_traits<It>::value_type value_type;
+
+        /**
+         *  @brief constructor
+         *  @param first begin of packed ranges in ascending order
+         *  @param last end of packed ranges
+         *  @throw This function will not throw an exception.
+         */
+        AMRangeRefView(It first, It last);
+
+        /**
+         *  @brief first range
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator begin() const;
+
+        /**
+         *  @brief behind last range
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator end() const;
+
+    private:
+        It mFirst;
+        It mLast;
+    };
+
+    /**
+     *  @ingroup Common
+     *  @brief numbers in left or right operand
+     */
+    struct AMRangeUnionOp
+    {
+        static constexpr bool apply(bool left, bool right)
+        {
+            return left || right;
+        }
+    };
+
+    /**
+     *  @ingroup Common
+     *  @brief numbers in left and not in right operand
+     */
+    struct AMRangeDifferenceOp
+    {
+        static constexpr bool apply(bool left, bool right)
+        {
+            return left && !right;
+        }
+    };
+
+    /**
+     *  @ingroup Common
+     *  @brief numbers in both operands
+     */
+    struct AMRangeIntersectionOp
+    {
+        static constexpr bool apply(bool left, bool right)
+        {
+            return left && right;
+        }
+    };
+
+    /**
+     *  @ingroup Common
+     *  @brief numbers in exactly one operand
+     */
+    struct AMRangeSymmetricDifferenceOp
+    {
+        static constexpr bool apply(bool left, bool right)
+        {
+            return left != right;
+        }
+    };
+
+    /**
+     *  @ingroup Common
+     *  @brief Lazy combination of two views
+     *
+     *  Iterator sweeps bounds of both operands in ascending order, between two bounds every number is in
+     *  left or right operand or not, and Op decides whether it is in result. Touching pieces of result are
+     *  merged, so ranges are packed. Iterator holds only iterators of operands, so chain of operations is
+     *  evaluated in one pass with memory proportional to depth of expression, not to size of sets.
+     *  Op must not accept numbers outside both operands.
+     */
+    template<typename Left, typename Right, typename Op>
+    class AMRangeCombinedView : public AMRangeViewBase<AMRangeCombinedView<Left, Right, Op>,
+                                                       typename Left::value_type::value_type>
+    {
+    public:
+        /**
+         *  @brief value type
+         */
+        typedef typename Left::value_type value_type;
+
+        /**
+         *  @brief iterator of result ranges
+         */
+        class const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef typename Left::value_type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const value_type *pointer;
+            typedef const value_type &reference;
+
+            /**
+             *  @brief end iterator
+             *  @throw This function will not throw an exception.
+             */
+            const_iterator();
+
+            /**
+             *  @brief iterator at first range of result
+             *  @throw Only what iterators of operands throw.
+             */
+            const_iterator(const Left &left, const Right &right);
+
+            /**
+             *  @brief current range
+             *  @throw This function will not throw an exception.
+             */
+            inline reference operator*() const;
+
+            /**
+             *  @brief current range
+             *  @throw This function will not throw an exception.
+             */
+            inline pointer operator->() const;
+
+            /**
+             *  @brief next range
+             *  @throw Only what iterators of operands throw.
+             */
+            inline const_iterator &operator++();
+
+            /**
+             *  @brief next range
+             *  @throw Only what iterators of operands throw.
+             */
+            inline const_iterator operator++(int);
+
+            /**
+             *  @brief comparison operator
+             *  Ranges of result are distinct, so iterators are equal when they are at the same range.
+             *  @throw This function will not throw an exception.
+             */
+            inline bool operator==(const const_iterator &right) const;
+
+            /**
+             *  @brief comparison operator
+             *  @throw This function will not throw an exception.
+             */
+            inline bool operator!=(const const_iterator &right) const;
+
+        private:
+            typedef typename value_type::value_type T;
+
+            /**
+             *  @brief sweep to the end of next range of result
+             *  @throw Only what iterators of operands throw.
+             */
+            void advance();
+
+            typename Left::const_iterator mLeft;
+            typename Left::const_iterator mLeftEnd;
+            typename Right::const_iterator mRight;
+            typename Right::const_iterator mRightEnd;
+            bool mInLeft;
+            bool mInRight;
+            T mCursor;
+            value_type mCurrent;
+            bool mAtEnd;
+        };
+
+        /**
+         *  @brief constructor
+         *  Operands are copied, views are cheap to copy.
+         *  @param left view
+         *  @param right view
+         *  @throw This function will not throw an exception.
+         */
+        AMRangeCombinedView(const Left &left, const Right &right);
+
+        /**
+         *  @brief first range
+         *  First range is computed here.
+         *  @throw Only what iterators of operands throw.
+         */
+        inline const_iterator begin() const;
+
+        /**
+         *  @brief behind last range
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator end() const;
+
+    private:
+        Left mLeft;
+        Right mRight;
+    };
+
+    /**
+     *  @brief view of packed container
+     *  @param c packed container of ranges, as AMRangeSet or packed std::set
+     *  @throw This function will not throw an exception.
+     */
+    template<typename C>
+    AMRangeRefView<typename C::const_iterator> rangeView(const C &c);
+
+    /**
+     *  @brief plus operator
+     *  Lazy union of two views.
+     *  @param left view
+     *  @param right view
+     *  @throw This function will not throw an exception.
+     */
+    template<typename L, typename R, typename = typename std::enable_if<std::is_base_of<AMRangeViewTag, L>::value &&
+                                                                        std::is_base_of<AMRangeViewTag, R>::value>::type>
+    AMRangeCombinedView<L, R, AMRangeUnionOp> operator+(const L &left, const R &right);
+
+    /**
+     *  @brief minus operator
+     *  Lazy difference of two views.
+     *  @param left view
+     *  @param right view
+     *  @throw This function will not throw an exception.
+     */
+    template<typename L, typename R, typename = typename std::enable_if<std::is_base_of<AMRangeViewTag, L>::value &&
+                                                                        std::is_base_of<AMRangeViewTag, R>::value>::type>
+    AMRangeCombinedView<L, R, AMRangeDifferenceOp> operator-(const L &left, const R &right);
+
+    /**
+     *  @brief and operator
+     *  Lazy intersection of two views.
+     *  @param left view
+     *  @param right view
+     *  @throw This function will not throw an exception.
+     */
+    template<typename L, typename R, typename = typename std::enable_if<std::is_base_of<AMRangeViewTag, L>::value &&
+                                                                        std::is_base_of<AMRangeViewTag, R>::value>::type>
+    AMRangeCombinedView<L, R, AMRangeIntersectionOp> operator&(const L &left, const R &right);
+
+    /**
+     *  @brief xor operator
+     *  Lazy symmetric difference of two views.
+     *  @param left view
+     *  @param right view
+     *  @throw This function will not throw an exception.
+     */
+    template<typename L, typename R, typename = typename std::enable_if<std::is_base_of<AMRangeViewTag, L>::value &&
+                                                                        std::is_base_of<AMRangeViewTag, R>::value>::type>
+    AMRangeCombinedView<L, R, AMRangeSymmetricDifferenceOp> operator^(const L &left, const R &right);
+
+
+    template<typename Derived, typename T>
+    template<typename Alloc>
+    AMRangeSet<T, Alloc> AMRangeViewBase<Derived, T>::toRangeSet(const Alloc &alloc) const
+    {
+        const Derived &view = static_cast<const Derived &>(*this);
+        // vector constructor would walk forward iterators twice to count ranges first
+        std::vector<AMRange<T>, Alloc> ranges(alloc);
+        std::copy(view.begin(), view.end(), std::back_inserter(ranges));
+        return AMRangeSet<T, Alloc>::fromPacked(std::move(ranges));
+    }
+
+    template<typename Derived, typename T>
+    template<typename Alloc>
+    AMRangeStdSet<T, Alloc> AMRangeViewBase<Derived, T>::toSet(const Alloc &alloc) const
+    {
+        const Derived &view = static_cast<const Derived &>(*this);
+        AMRangeStdSet<T, Alloc> result(alloc);
+        std::copy(view.begin(), view.end(), std::inserter(result, result.end()));
+        return result;
+    }
+
+    template<typename It>
+    AMRangeRefView<It>::AMRangeRefView(It first, It last)
+        : mFirst(first),
+          mLast(last)
+    {
+    }
+
+    template<typename It>
+    inline typename AMRangeRefView<It>::const_iterator AMRangeRefView<It>::begin() const
+    {
+        return mFirst;
+    }
+
+    template<typename It>
+    inline typename AMRangeRefView<It>::const_iterator AMRangeRefView<It>::end() const
+    {
+        return mLast;
+    }
+
+    template<typename Left, typename Right, typename Op>
+    AMRangeCombinedView<Left, Right, Op>::const_iterator::const_iterator()
+        : mLeft(),
+          mLeftEnd(),
+          mRight(),
+          mRightEnd(),
+          mInLeft(false),
+          mInRight(false),
+          mCursor(),
+          mCurrent(),
+          mAtEnd(true)
+    {
+    }
+
+    template<typename Left, typename Right, typename Op>
+    AMRangeCombinedView<Left, Right, Op>::const_iterator::const_iterator(const Left &left, const Right &right)
+        : mLeft(left.begin()),
+          mLeftEnd(left.end()),
+          mRight(right.begin()),
+          mRightEnd(right.end()),
+          mInLeft(false),
+          mInRight(false),
+          mCursor(),
+          mCurrent(),
+          mAtEnd(false)
+    {
+        if (mLeft != mLeftEnd) {
+            mCursor = mLeft->from;
+        }
+        if (mRight != mRightEnd && (mLeft == mLeftEnd || mRight->from < mCursor)) {
+            mCursor = mRight->from;
+        }
+        advance();
+    }
+
+    template<typename Left, typename Right, typename Op>
+    void AMRangeCombinedView<Left, Right, Op>::const_iterator::advance()
+    {
+        bool found = false;
+        while (true) {
+            bool hasLeft = mLeft != mLeftEnd;
+            bool hasRight = mRight != mRightEnd;
+            // operand is exhausted when it is behind its last range, stop when the other one cannot add anything
+            if (!hasLeft ? !hasRight || !Op::apply(false, true) : !hasRight && !Op::apply(true, false)) {
+                break;
+            }
+            T left = hasLeft ? (mInLeft ? mLeft->to : mLeft->from) : T();
+            T right = hasRight ? (mInRight ? mRight->to : mRight->from) : T();
+            T next = !hasLeft || (hasRight && right < left) ? right : left;
+            if (mCursor < next) {
+                if (Op::apply(mInLeft, mInRight)) {
+                    if (!found) {
+                        mCurrent.from = mCursor;
+                        found = true;
+                    }
+                    mCurrent.to = next;
+                } else if (found) {
+                    return;
+                }
+            }
+            if (hasLeft && left == next) {
+                if (mInLeft) {
+                    ++mLeft;
+                }
+                mInLeft = !mInLeft;
+            }
+            if (hasRight && right == next) {
+                if (mInRight) {
+                    ++mRight;
+                }
+                mInRight = !mInRight;
+            }
+            mCursor = next;
+        }
+        mAtEnd = !found;
+    }
+
+    template<typename Left, typename Right, typename Op>
+    inline typename AMRangeCombinedView<Left, Right, Op>::const_iterator::reference
+    AMRangeCombinedView<Left, Right, Op>::const_iterator::operator*() const
+    {
+        return mCurrent;
+    }
+
+    template<typename Left, typename Right, typename Op>
+    inline typename AMRangeCombinedView<Left, Right, Op>::const_iterator::pointer
+    AMRangeCombinedView<Left, Right, Op>::const_iterator::operator->() const
+    {
+        return &mCurrent;
+    }
+
+    template<typename Left, typename Right, typename Op>
+    inline typename AMRangeCombinedView<Left, Right, Op>::const_iterator &
+    AMRangeCombinedView<Left, Right, Op>::const_iterator::operator++()
+    {
+        advance();
+        return *this;
+    }
+
+    template<typename Left, typename Right, typename Op>
+    inline typename AMRangeCombinedView<Left, Right, Op>::const_iterator
+    AMRangeCombinedView<Left, Right, Op>::const_iterator::operator++(int)
+    {
+        const_iterator result = *this;
+        advance();
+        return result;
+    }
+
+    template<typename Left, typename Right, typename Op>
+    inline bool AMRangeCombinedView<Left, Right, Op>::const_iterator::operator==(const const_iterator &right) const
+    {
+        return mAtEnd == right.mAtEnd && (mAtEnd || mCurrent == right.mCurrent);
+    }
+
+    template<typename Left, typename Right, typename Op>
+    inline bool AMRangeCombinedView<Left, Right, Op>::const_iterator::operator!=(const const_iterator &right) const
+    {
+        return !(*this == right);
+    }
+
+    template<typename Left, typename Right, typename Op>
+    AMRangeCombinedView<Left, Right, Op>::AMRangeCombinedView(const Left &left, const Right &right)
+        : mLeft(left),
+          mRight(right)
+    {
+    }
+
+    template<typename Left, typename Right, typename Op>
+    inline typename AMRangeCombinedView<Left, Right, Op>::const_iterator AMRangeCombinedView<Left, Right, Op>::begin() const
+    {
+        return const_iterator(mLeft, mRight);
+    }
+
+    template<typename Left, typename Right, typename Op>
+    inline typename AMRangeCombinedView<Left, Right, Op>::const_iterator AMRangeCombinedView<Left, Right, Op>::end() const
+    {
+        return const_iterator();
+    }
+
+    template<typename C>
+    AMRangeRefView<typename C::const_iterator> rangeView(const C &c)
+    {
+        return AMRangeRefView<typename C::const_iterator>(c.begin(), c.end());
+    }
+
+    template<typename L, typename R, typename>
+    AMRangeCombinedView<L, R, AMRangeUnionOp> operator+(const L &left, const R &right)
+    {
+        return AMRangeCombinedView<L, R, AMRangeUnionOp>(left, right);
+    }
+
+    template<typename L, typename R, typename>
+    AMRangeCombinedView<L, R, AMRangeDifferenceOp> operator-(const L &left, const R &right)
+    {
+        return AMRangeCombinedView<L, R, AMRangeDifferenceOp>(left, right);
+    }
+
+    template<typename L, typename R, typename>
+    AMRangeCombinedView<L, R, AMRangeIntersectionOp> operator&(const L &left, const R &right)
+    {
+        return AMRangeCombinedView<L, R, AMRangeIntersectionOp>(left, right);
+    }
+
+    template<typename L, typename R, typename>
+    AMRangeCombinedView<L, R, AMRangeSymmetricDifferenceOp> operator^(const L &left, const R &right)
+    {
+        return AMRangeCombinedView<L, R, AMRangeSymmetricDifferenceOp>(left, right);
+    }
+}
+
+/** @} */
+
+#endif //AMCORE_AMRANGEVIEW_H
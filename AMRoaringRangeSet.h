@@ -0,0 +1,1187 @@
+/**
+ * @file: AMRoaringRangeSet.h
+ * Set of 32 bit unsigned ranges with run and bitmap chunks
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMROARINGRANGESET_H
+#define AMCORE_AMROARINGRANGESET_H
+
+#include "AMRangeSet.h"
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <iterator>
+#include <initializer_list>
+
+/**
+ *  @brief maximal number of runs in run chunk, chunk with more runs is stored as bitmap
+ *  Run takes 4 bytes, so 2048 runs take the same memory as bitmap of chunk (8 KiB).
+ */
+#ifndef AMRANGE_ROARING_MAX_RUNS
+#define AMRANGE_ROARING_MAX_RUNS 2048
+#endif
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Common
+     *  @brief Set of 32 bit unsigned ranges with run and bitmap chunks
+     *
+     *  Number space is split into chunks of 65536 numbers by upper 16 bits, only nonempty chunks are stored
+     *  in array sorted by key. Chunk is run chunk, sorted array of packed runs with 16 bit bounds, or bitmap
+     *  chunk with one bit per number. Chunk is bitmap when it has more than AMRANGE_ROARING_MAX_RUNS runs,
+     *  so sets fragmented into many tiny ranges take at most 8 KiB per chunk and set algebra on them is done
+     *  by word operations. Representation of chunk is chosen after every change, so equal sets have equal
+     *  chunks.
+     *
+     *  Set behaves as packed set of ranges: iteration yields packed ranges, runs touching at chunk boundary
+     *  are joined. Number UINT32_MAX is out of every range, because it is not below right bound of any range.
+     */
+    class AMRoaringRangeSet
+    {
+    public:
+        /**
+         *  @brief value type
+         */
+        typedef AMRange<std::uint32_t> value_type;
+        /**
+         *  @brief size type
+         */
+        typedef std::size_t size_type;
+
+    private:
+        /**
+         *  @brief run of chunk, bounds are inclusive
+         */
+        struct Run
+        {
+            std::uint16_t first;
+            std::uint16_t last;
+
+            inline bool operator==(const Run &right) const
+            {
+                return first == right.first && last == right.last;
+            }
+        };
+
+        /**
+         *  @brief chunk of 65536 numbers, bitmap is empty in run chunk
+         */
+        struct Chunk
+        {
+            std::uint32_t key;
+            std::uint32_t cardinality;
+            std::uint32_t runCount;
+            std::vector<Run> runs;
+            std::vector<std::uint64_t> bitmap;
+        };
+
+        /**
+         *  @brief number of numbers in chunk
+         */
+        static constexpr std::uint32_t chunkSize = 65536;
+
+        /**
+         *  @brief number of words in bitmap
+         */
+        static constexpr std::uint32_t bitmapWords = chunkSize / 64;
+
+    public:
+        /**
+         *  @brief iterator of packed ranges
+         */
+        class const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef AMRange<std::uint32_t> value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const value_type *pointer;
+            typedef const value_type &reference;
+
+            /**
+             *  @brief end iterator of empty set
+             *  @throw This function will not throw an exception.
+             */
+            const_iterator();
+
+            /**
+             *  @brief current range
+             *  @throw This function will not throw an exception.
+             */
+            inline reference operator*() const;
+
+            /**
+             *  @brief current range
+             *  @throw This function will not throw an exception.
+             */
+            inline pointer operator->() const;
+
+            /**
+             *  @brief next range
+             *  @throw This function will not throw an exception.
+             */
+            inline const_iterator &operator++();
+
+            /**
+             *  @brief next range
+             *  @throw This function will not throw an exception.
+             */
+            inline const_iterator operator++(int);
+
+            /**
+             *  @brief comparison operator
+             *  Iterators of the same set are equal when they are at the same chunk and position.
+             *  @throw This function will not throw an exception.
+             */
+            inline bool operator==(const const_iterator &right) const;
+
+            /**
+             *  @brief comparison operator
+             *  @throw This function will not throw an exception.
+             */
+            inline bool operator!=(const const_iterator &right) const;
+
+        private:
+            friend class AMRoaringRangeSet;
+
+            /**
+             *  @brief iterator at first range starting in chunk
+             *  @throw This function will not throw an exception.
+             */
+            const_iterator(const std::vector<Chunk> &chunks, size_type chunk);
+
+            /**
+             *  @brief read range at or above current position, joined with runs of following chunks
+             *  @throw This function will not throw an exception.
+             */
+            void load();
+
+            const Chunk *mChunks;
+            size_type mCount;
+            size_type mChunk;
+            std::uint32_t mPos;
+            AMRange<std::uint32_t> mCurrent;
+        };
+
+        /**
+         *  @brief iterator type
+         */
+        typedef const_iterator iterator;
+
+        /**
+         *  @brief empty constructor
+         *  @throw This function will not throw an exception.
+         */
+        AMRoaringRangeSet();
+
+        /**
+         *  @brief constructor
+         *  Set of one range.
+         *  @param r range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRoaringRangeSet(const AMRange<std::uint32_t> &r);
+
+        /**
+         *  @brief constructor
+         *  Ranges need not to be sorted or packed.
+         *  @param l list of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRoaringRangeSet(std::initializer_list<AMRange<std::uint32_t> > l);
+
+        /**
+         *  @brief constructor
+         *  Ranges need not to be sorted or packed.
+         *  @param first first range
+         *  @param last behind last range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename InputIt>
+        AMRoaringRangeSet(InputIt first, InputIt last);
+
+        /**
+         *  @brief constructor
+         *  @param s set of ranges, packed before when it is not
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename Alloc>
+        explicit AMRoaringRangeSet(const AMRangeStdSet<std::uint32_t, Alloc> &s);
+
+        /**
+         *  @brief constructor
+         *  @param s flat set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename Alloc>
+        explicit AMRoaringRangeSet(const AMRangeSet<std::uint32_t, Alloc> &s);
+
+        /**
+         *  @brief conversion to flat set
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet<std::uint32_t> toRangeSet() const;
+
+        /**
+         *  @brief conversion to std::set
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeStdSet<std::uint32_t> toSet() const;
+
+        /**
+         *  @brief first range
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator begin() const;
+
+        /**
+         *  @brief behind last range
+         *  @throw This function will not throw an exception.
+         */
+        inline const_iterator end() const;
+
+        /**
+         *  @brief number of packed ranges
+         *  O(number of chunks) time.
+         *  @throw This function will not throw an exception.
+         */
+        size_type size() const;
+
+        /**
+         *  @brief test for empty
+         *  @throw This function will not throw an exception.
+         */
+        inline bool empty() const;
+
+        /**
+         *  @brief number of numbers in set
+         *  O(number of chunks) time, cardinality of chunks is kept up to date.
+         *  @throw This function will not throw an exception.
+         */
+        std::uint64_t measure() const;
+
+        /**
+         *  @brief number of bitmap chunks
+         *  @throw This function will not throw an exception.
+         */
+        size_type bitmapChunks() const;
+
+        /**
+         *  @brief allocated bytes
+         *  @throw This function will not throw an exception.
+         */
+        std::size_t memoryUsage() const;
+
+        /**
+         *  @brief remove all ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline void clear();
+
+        /**
+         *  @brief comparison operator
+         *  @throw This function will not throw an exception.
+         */
+        bool operator==(const AMRoaringRangeSet &right) const;
+
+        /**
+         *  @brief comparison operator
+         *  @throw This function will not throw an exception.
+         */
+        inline bool operator!=(const AMRoaringRangeSet &right) const;
+
+        /**
+         *  @brief test that number is in set
+         *  Binary search of chunk, e.q. O(log n) time.
+         *  @param num
+         *  @throw This function will not throw an exception.
+         */
+        bool contains(std::uint32_t num) const;
+
+        /**
+         *  @brief test that range is fully covered
+         *  Empty range is always covered.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool covers(const AMRange<std::uint32_t> &rng) const;
+
+        /**
+         *  @brief test that range has nonempty intersection with set
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        bool overlaps(const AMRange<std::uint32_t> &rng) const;
+
+        /**
+         *  @brief plus operator
+         *  Only chunks overlapped by range are changed.
+         *  @param right range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRoaringRangeSet &operator+=(const AMRange<std::uint32_t> &right);
+
+        /**
+         *  @brief minus operator
+         *  Only chunks overlapped by range are changed.
+         *  @param right range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRoaringRangeSet &operator-=(const AMRange<std::uint32_t> &right);
+
+        /**
+         *  @brief and operator
+         *  @param right range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRoaringRangeSet &operator&=(const AMRange<std::uint32_t> &right);
+
+        /**
+         *  @brief plus operator
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRoaringRangeSet &operator+=(const AMRoaringRangeSet &right);
+
+        /**
+         *  @brief minus operator
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRoaringRangeSet &operator-=(const AMRoaringRangeSet &right);
+
+        /**
+         *  @brief and operator
+         *  @param right set of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRoaringRangeSet &operator&=(const AMRoaringRangeSet &right);
+
+        /**
+         *  @brief union
+         *  Chunks present in both sets are merged, run chunks by merge of runs, others word by word.
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static AMRoaringRangeSet unite(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right);
+
+        /**
+         *  @brief difference
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static AMRoaringRangeSet subtract(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right);
+
+        /**
+         *  @brief intersection
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static AMRoaringRangeSet intersect(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right);
+
+        /**
+         *  @brief symmetric difference
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        static AMRoaringRangeSet symmetricDifference(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right);
+
+    private:
+        /**
+         *  @brief add range above all chunks
+         *  Runs are appended without limit, finishAppend() converts long run chunks to bitmaps.
+         */
+        void append(const AMRange<std::uint32_t> &r);
+
+        /**
+         *  @brief choose representation of appended chunks
+         */
+        void finishAppend();
+
+        /**
+         *  @brief index of first chunk with key not below key
+         */
+        inline size_type lowerChunk(std::uint32_t key) const;
+
+        /**
+         *  @brief apply chunk operation to chunks overlapped by range
+         *  Missing chunks are created when create is set. Operation gets local bounds of range in chunk
+         *  and returns false when chunk becomes empty.
+         */
+        template<typename Op>
+        void applyRange(const AMRange<std::uint32_t> &r, bool create, Op op);
+
+        /**
+         *  @brief merge of chunk arrays
+         *  Chunks of only one set are copied when keepLeft or keepRight is set.
+         */
+        template<typename RunOp, typename WordOp>
+        static AMRoaringRangeSet combine(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right,
+                                         bool keepLeft, bool keepRight, RunOp runOp, WordOp wordOp);
+
+        /**
+         *  @brief first local run ending above pos
+         *  @return false when there is no such run
+         */
+        static bool nextLocal(const Chunk &c, std::uint32_t pos, std::uint32_t &lo, std::uint32_t &hi);
+
+        /**
+         *  @brief local runs of chunk as ranges
+         */
+        static void toLocal(const Chunk &c, std::vector<AMRange<std::uint32_t> > &local);
+
+        /**
+         *  @brief bitmap of chunk
+         */
+        static std::vector<std::uint64_t> toWords(const Chunk &c);
+
+        /**
+         *  @brief set chunk from packed local ranges
+         *  @return false when chunk is empty
+         */
+        static bool fromLocal(Chunk &c, const std::vector<AMRange<std::uint32_t> > &local);
+
+        /**
+         *  @brief set chunk from bitmap
+         *  @return false when chunk is empty
+         */
+        static bool fromWords(Chunk &c, std::vector<std::uint64_t> &&words);
+
+        /**
+         *  @brief test that all numbers of local range are in chunk
+         */
+        static bool localCovers(const Chunk &c, std::uint32_t lo, std::uint32_t hi);
+
+        /**
+         *  @brief position of first set (or clear) bit at or above pos, chunkSize when there is none
+         */
+        static inline std::uint32_t nextBit(const std::uint64_t *words, std::uint32_t pos, bool set);
+
+        /**
+         *  @brief set or clear bits of local range
+         */
+        static void fillBits(std::uint64_t *words, std::uint32_t lo, std::uint32_t hi, bool set);
+
+        static inline unsigned popcount(std::uint64_t w);
+        static inline unsigned ctz(std::uint64_t w);
+
+        std::vector<Chunk> mChunks;
+    };
+
+    /**
+     *  @brief plus operator
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    inline AMRoaringRangeSet operator+(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right);
+    /**
+     *  @brief minus operator
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    inline AMRoaringRangeSet operator-(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right);
+    /**
+     *  @brief and operator
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    inline AMRoaringRangeSet operator&(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right);
+    /**
+     *  @brief xor operator
+     *  @throw std::bad_alloc if allocation fails.
+     */
+    inline AMRoaringRangeSet operator^(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right);
+
+
+    inline AMRoaringRangeSet::const_iterator::const_iterator()
+        : mChunks(nullptr),
+          mCount(0),
+          mChunk(0),
+          mPos(0),
+          mCurrent()
+    {
+    }
+
+    inline AMRoaringRangeSet::const_iterator::const_iterator(const std::vector<Chunk> &chunks, size_type chunk)
+        : mChunks(chunks.data()),
+          mCount(chunks.size()),
+          mChunk(chunk),
+          mPos(0),
+          mCurrent()
+    {
+        load();
+    }
+
+    inline void AMRoaringRangeSet::const_iterator::load()
+    {
+        std::uint32_t lo, hi;
+        while (mChunk < mCount) {
+            if (nextLocal(mChunks[mChunk], mPos, lo, hi)) {
+                std::uint32_t from = (mChunks[mChunk].key << 16) + lo;
+                std::uint32_t nextLo, nextHi;
+                //run reaching chunk end continues by run starting at zero in next chunk
+                while (hi == chunkSize && mChunk + 1 < mCount && mChunks[mChunk + 1].key == mChunks[mChunk].key + 1 &&
+                       nextLocal(mChunks[mChunk + 1], 0, nextLo, nextHi) && nextLo == 0) {
+                    mChunk++;
+                    hi = nextHi;
+                }
+                mCurrent = AMRange<std::uint32_t>(from, (mChunks[mChunk].key << 16) + hi);
+                mPos = hi;
+                return;
+            }
+            mChunk++;
+            mPos = 0;
+        }
+        mPos = 0;
+    }
+
+    inline AMRoaringRangeSet::const_iterator::reference AMRoaringRangeSet::const_iterator::operator*() const
+    {
+        return mCurrent;
+    }
+
+    inline AMRoaringRangeSet::const_iterator::pointer AMRoaringRangeSet::const_iterator::operator->() const
+    {
+        return &mCurrent;
+    }
+
+    inline AMRoaringRangeSet::const_iterator &AMRoaringRangeSet::const_iterator::operator++()
+    {
+        if (mPos == chunkSize) {
+            mChunk++;
+            mPos = 0;
+        }
+        load();
+        return *this;
+    }
+
+    inline AMRoaringRangeSet::const_iterator AMRoaringRangeSet::const_iterator::operator++(int)
+    {
+        const_iterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    inline bool AMRoaringRangeSet::const_iterator::operator==(const const_iterator &right) const
+    {
+        return mChunk == right.mChunk && mPos == right.mPos;
+    }
+
+    inline bool AMRoaringRangeSet::const_iterator::operator!=(const const_iterator &right) const
+    {
+        return !(*this == right);
+    }
+
+    inline AMRoaringRangeSet::AMRoaringRangeSet()
+    {
+    }
+
+    inline AMRoaringRangeSet::AMRoaringRangeSet(const AMRange<std::uint32_t> &r)
+    {
+        if (r.nonEmpty()) {
+            append(r);
+        }
+        finishAppend();
+    }
+
+    inline AMRoaringRangeSet::AMRoaringRangeSet(std::initializer_list<AMRange<std::uint32_t> > l)
+        : AMRoaringRangeSet(l.begin(), l.end())
+    {
+    }
+
+    template<typename InputIt>
+    AMRoaringRangeSet::AMRoaringRangeSet(InputIt first, InputIt last)
+    {
+        std::vector<AMRange<std::uint32_t> > v(first, last);
+        sortAndPack(v);
+        for (const AMRange<std::uint32_t> &r : v) {
+            append(r);
+        }
+        finishAppend();
+    }
+
+    template<typename Alloc>
+    AMRoaringRangeSet::AMRoaringRangeSet(const AMRangeStdSet<std::uint32_t, Alloc> &s)
+    {
+        if (isPacked(s)) {
+            for (const AMRange<std::uint32_t> &r : s) {
+                append(r);
+            }
+        } else {
+            for (const AMRange<std::uint32_t> &r : pack(s)) {
+                append(r);
+            }
+        }
+        finishAppend();
+    }
+
+    template<typename Alloc>
+    AMRoaringRangeSet::AMRoaringRangeSet(const AMRangeSet<std::uint32_t, Alloc> &s)
+    {
+        for (const AMRange<std::uint32_t> &r : s) {
+            append(r);
+        }
+        finishAppend();
+    }
+
+    inline AMRangeSet<std::uint32_t> AMRoaringRangeSet::toRangeSet() const
+    {
+        std::vector<AMRange<std::uint32_t> > v;
+        v.reserve(size());
+        v.assign(begin(), end());
+        return AMRangeSet<std::uint32_t>::fromPacked(std::move(v));
+    }
+
+    inline AMRangeStdSet<std::uint32_t> AMRoaringRangeSet::toSet() const
+    {
+        AMRangeStdSet<std::uint32_t> s;
+        for (const AMRange<std::uint32_t> &r : *this) {
+            s.insert(s.end(), r);
+        }
+        return s;
+    }
+
+    inline AMRoaringRangeSet::const_iterator AMRoaringRangeSet::begin() const
+    {
+        return const_iterator(mChunks, 0);
+    }
+
+    inline AMRoaringRangeSet::const_iterator AMRoaringRangeSet::end() const
+    {
+        return const_iterator(mChunks, mChunks.size());
+    }
+
+    inline AMRoaringRangeSet::size_type AMRoaringRangeSet::size() const
+    {
+        size_type count = 0;
+        std::uint32_t lo, hi;
+        for (size_type i = 0; i < mChunks.size(); i++) {
+            count += mChunks[i].runCount;
+            //runs joined at chunk boundary are one range
+            if (i > 0 && mChunks[i].key == mChunks[i - 1].key + 1 && nextLocal(mChunks[i], 0, lo, hi) && lo == 0 &&
+                localCovers(mChunks[i - 1], chunkSize - 1, chunkSize)) {
+                count--;
+            }
+        }
+        return count;
+    }
+
+    inline bool AMRoaringRangeSet::empty() const
+    {
+        return mChunks.empty();
+    }
+
+    inline std::uint64_t AMRoaringRangeSet::measure() const
+    {
+        std::uint64_t sum = 0;
+        for (const Chunk &c : mChunks) {
+            sum += c.cardinality;
+        }
+        return sum;
+    }
+
+    inline AMRoaringRangeSet::size_type AMRoaringRangeSet::bitmapChunks() const
+    {
+        size_type count = 0;
+        for (const Chunk &c : mChunks) {
+            count += !c.bitmap.empty();
+        }
+        return count;
+    }
+
+    inline std::size_t AMRoaringRangeSet::memoryUsage() const
+    {
+        std::size_t bytes = sizeof(*this) + mChunks.capacity() * sizeof(Chunk);
+        for (const Chunk &c : mChunks) {
+            bytes += c.runs.capacity() * sizeof(Run) + c.bitmap.capacity() * sizeof(std::uint64_t);
+        }
+        return bytes;
+    }
+
+    inline void AMRoaringRangeSet::clear()
+    {
+        mChunks.clear();
+    }
+
+    inline bool AMRoaringRangeSet::operator==(const AMRoaringRangeSet &right) const
+    {
+        if (mChunks.size() != right.mChunks.size()) {
+            return false;
+        }
+        for (size_type i = 0; i < mChunks.size(); i++) {
+            const Chunk &a = mChunks[i];
+            const Chunk &b = right.mChunks[i];
+            if (a.key != b.key || a.cardinality != b.cardinality || a.runs != b.runs || a.bitmap != b.bitmap) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline bool AMRoaringRangeSet::operator!=(const AMRoaringRangeSet &right) const
+    {
+        return !(*this == right);
+    }
+
+    inline bool AMRoaringRangeSet::contains(std::uint32_t num) const
+    {
+        size_type i = lowerChunk(num >> 16);
+        return i < mChunks.size() && mChunks[i].key == num >> 16 && localCovers(mChunks[i], num & 0xffff, (num & 0xffff) + 1);
+    }
+
+    inline bool AMRoaringRangeSet::covers(const AMRange<std::uint32_t> &rng) const
+    {
+        if (!rng.nonEmpty()) {
+            return true;
+        }
+        std::uint32_t first = rng.from >> 16;
+        std::uint32_t last = (rng.to - 1) >> 16;
+        size_type i = lowerChunk(first);
+        for (std::uint32_t key = first; key <= last; key++, i++) {
+            std::uint32_t lo = key == first ? rng.from & 0xffff : 0;
+            std::uint32_t hi = key == last ? ((rng.to - 1) & 0xffff) + 1 : chunkSize;
+            if (i >= mChunks.size() || mChunks[i].key != key || !localCovers(mChunks[i], lo, hi)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline bool AMRoaringRangeSet::overlaps(const AMRange<std::uint32_t> &rng) const
+    {
+        if (!rng.nonEmpty()) {
+            return false;
+        }
+        std::uint32_t first = rng.from >> 16;
+        std::uint32_t last = (rng.to - 1) >> 16;
+        std::uint32_t lo, hi;
+        for (size_type i = lowerChunk(first); i < mChunks.size() && mChunks[i].key <= last; i++) {
+            std::uint32_t from = mChunks[i].key == first ? rng.from & 0xffff : 0;
+            std::uint32_t to = mChunks[i].key == last ? ((rng.to - 1) & 0xffff) + 1 : chunkSize;
+            if (nextLocal(mChunks[i], from, lo, hi) && lo < to) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline AMRoaringRangeSet &AMRoaringRangeSet::operator+=(const AMRange<std::uint32_t> &right)
+    {
+        applyRange(right, true, [](Chunk &c, std::uint32_t lo, std::uint32_t hi) {
+            if (!c.bitmap.empty()) {
+                std::vector<std::uint64_t> words = std::move(c.bitmap);
+                fillBits(words.data(), lo, hi, true);
+                return fromWords(c, std::move(words));
+            }
+            std::vector<AMRange<std::uint32_t> > local, result;
+            toLocal(c, local);
+            AMRange<std::uint32_t> r(lo, hi);
+            AMCore::unite(local.begin(), local.end(), &r, &r + 1, std::back_inserter(result));
+            return fromLocal(c, result);
+        });
+        return *this;
+    }
+
+    inline AMRoaringRangeSet &AMRoaringRangeSet::operator-=(const AMRange<std::uint32_t> &right)
+    {
+        applyRange(right, false, [](Chunk &c, std::uint32_t lo, std::uint32_t hi) {
+            if (!c.bitmap.empty()) {
+                std::vector<std::uint64_t> words = std::move(c.bitmap);
+                fillBits(words.data(), lo, hi, false);
+                return fromWords(c, std::move(words));
+            }
+            std::vector<AMRange<std::uint32_t> > local, result;
+            toLocal(c, local);
+            AMRange<std::uint32_t> r(lo, hi);
+            AMCore::subtract(local.begin(), local.end(), &r, &r + 1, std::back_inserter(result));
+            return fromLocal(c, result);
+        });
+        return *this;
+    }
+
+    inline AMRoaringRangeSet &AMRoaringRangeSet::operator&=(const AMRange<std::uint32_t> &right)
+    {
+        if (!right.nonEmpty()) {
+            clear();
+            return *this;
+        }
+        *this -= AMRange<std::uint32_t>(0, right.from);
+        *this -= AMRange<std::uint32_t>(right.to, UINT32_MAX);
+        return *this;
+    }
+
+    inline AMRoaringRangeSet &AMRoaringRangeSet::operator+=(const AMRoaringRangeSet &right)
+    {
+        *this = unite(*this, right);
+        return *this;
+    }
+
+    inline AMRoaringRangeSet &AMRoaringRangeSet::operator-=(const AMRoaringRangeSet &right)
+    {
+        *this = subtract(*this, right);
+        return *this;
+    }
+
+    inline AMRoaringRangeSet &AMRoaringRangeSet::operator&=(const AMRoaringRangeSet &right)
+    {
+        *this = intersect(*this, right);
+        return *this;
+    }
+
+    inline AMRoaringRangeSet AMRoaringRangeSet::unite(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right)
+    {
+        return combine(left, right, true, true,
+                       [](const std::vector<AMRange<std::uint32_t> > &a, const std::vector<AMRange<std::uint32_t> > &b,
+                          std::vector<AMRange<std::uint32_t> > &out) {
+                           AMCore::unite(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+                       },
+                       [](std::uint64_t a, std::uint64_t b) { return a | b; });
+    }
+
+    inline AMRoaringRangeSet AMRoaringRangeSet::subtract(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right)
+    {
+        return combine(left, right, true, false,
+                       [](const std::vector<AMRange<std::uint32_t> > &a, const std::vector<AMRange<std::uint32_t> > &b,
+                          std::vector<AMRange<std::uint32_t> > &out) {
+                           AMCore::subtract(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+                       },
+                       [](std::uint64_t a, std::uint64_t b) { return a & ~b; });
+    }
+
+    inline AMRoaringRangeSet AMRoaringRangeSet::intersect(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right)
+    {
+        return combine(left, right, false, false,
+                       [](const std::vector<AMRange<std::uint32_t> > &a, const std::vector<AMRange<std::uint32_t> > &b,
+                          std::vector<AMRange<std::uint32_t> > &out) {
+                           AMCore::intersect(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+                       },
+                       [](std::uint64_t a, std::uint64_t b) { return a & b; });
+    }
+
+    inline AMRoaringRangeSet AMRoaringRangeSet::symmetricDifference(const AMRoaringRangeSet &left,
+                                                                    const AMRoaringRangeSet &right)
+    {
+        return combine(left, right, true, true,
+                       [](const std::vector<AMRange<std::uint32_t> > &a, const std::vector<AMRange<std::uint32_t> > &b,
+                          std::vector<AMRange<std::uint32_t> > &out) {
+                           AMCore::symmetricDifference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+                       },
+                       [](std::uint64_t a, std::uint64_t b) { return a ^ b; });
+    }
+
+    inline void AMRoaringRangeSet::append(const AMRange<std::uint32_t> &r)
+    {
+        std::uint32_t from = r.from;
+        while (from < r.to) {
+            std::uint32_t key = from >> 16;
+            std::uint32_t hi = (r.to - 1) >> 16 == key ? ((r.to - 1) & 0xffff) + 1 : chunkSize;
+            if (mChunks.empty() || mChunks.back().key != key) {
+                mChunks.push_back(Chunk{key, 0, 0, std::vector<Run>(), std::vector<std::uint64_t>()});
+            }
+            Chunk &c = mChunks.back();
+            c.runs.push_back(Run{std::uint16_t(from & 0xffff), std::uint16_t(hi - 1)});
+            c.cardinality += hi - (from & 0xffff);
+            c.runCount++;
+            if (hi != chunkSize) {
+                break;
+            }
+            from = (key + 1) << 16;
+            if (from == 0) {
+                break;
+            }
+        }
+    }
+
+    inline void AMRoaringRangeSet::finishAppend()
+    {
+        for (Chunk &c : mChunks) {
+            if (c.runs.size() > AMRANGE_ROARING_MAX_RUNS) {
+                std::vector<std::uint64_t> words = toWords(c);
+                fromWords(c, std::move(words));
+            }
+        }
+    }
+
+    inline AMRoaringRangeSet::size_type AMRoaringRangeSet::lowerChunk(std::uint32_t key) const
+    {
+        return size_type(std::partition_point(mChunks.begin(), mChunks.end(),
+                                              [key](const Chunk &c) { return c.key < key; }) - mChunks.begin());
+    }
+
+    template<typename Op>
+    void AMRoaringRangeSet::applyRange(const AMRange<std::uint32_t> &r, bool create, Op op)
+    {
+        if (!r.nonEmpty()) {
+            return;
+        }
+        std::uint32_t first = r.from >> 16;
+        std::uint32_t last = (r.to - 1) >> 16;
+        size_type i = lowerChunk(first);
+        std::vector<Chunk> result;
+        result.reserve(mChunks.size() + (create ? last - first + 1 : 0));
+        std::move(mChunks.begin(), mChunks.begin() + i, std::back_inserter(result));
+        std::uint32_t key = first;
+        while (key <= last) {
+            Chunk c;
+            if (i < mChunks.size() && mChunks[i].key == key) {
+                c = std::move(mChunks[i++]);
+            } else if (create) {
+                c = Chunk{key, 0, 0, std::vector<Run>(), std::vector<std::uint64_t>()};
+            } else if (i < mChunks.size() && mChunks[i].key <= last) {
+                key = mChunks[i].key;
+                continue;
+            } else {
+                break;
+            }
+            std::uint32_t lo = key == first ? r.from & 0xffff : 0;
+            std::uint32_t hi = key == last ? ((r.to - 1) & 0xffff) + 1 : chunkSize;
+            if (op(c, lo, hi)) {
+                result.push_back(std::move(c));
+            }
+            key++;
+        }
+        std::move(mChunks.begin() + i, mChunks.end(), std::back_inserter(result));
+        mChunks = std::move(result);
+    }
+
+    template<typename RunOp, typename WordOp>
+    AMRoaringRangeSet AMRoaringRangeSet::combine(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right,
+                                                 bool keepLeft, bool keepRight, RunOp runOp, WordOp wordOp)
+    {
+        AMRoaringRangeSet result;
+        result.mChunks.reserve(left.mChunks.size() + right.mChunks.size());
+        std::vector<AMRange<std::uint32_t> > a, b, out;
+        size_type i = 0, j = 0;
+        while (i < left.mChunks.size() || j < right.mChunks.size()) {
+            if (j == right.mChunks.size() || (i < left.mChunks.size() && left.mChunks[i].key < right.mChunks[j].key)) {
+                if (keepLeft) {
+                    result.mChunks.push_back(left.mChunks[i]);
+                }
+                i++;
+                continue;
+            }
+            if (i == left.mChunks.size() || right.mChunks[j].key < left.mChunks[i].key) {
+                if (keepRight) {
+                    result.mChunks.push_back(right.mChunks[j]);
+                }
+                j++;
+                continue;
+            }
+            const Chunk &l = left.mChunks[i++];
+            const Chunk &r = right.mChunks[j++];
+            Chunk c{l.key, 0, 0, std::vector<Run>(), std::vector<std::uint64_t>()};
+            bool nonEmpty;
+            if (l.bitmap.empty() && r.bitmap.empty()) {
+                a.clear();
+                b.clear();
+                out.clear();
+                toLocal(l, a);
+                toLocal(r, b);
+                runOp(a, b, out);
+                nonEmpty = fromLocal(c, out);
+            } else {
+                //word by word, the loop is vectorized by compiler
+                std::vector<std::uint64_t> words = toWords(l);
+                std::vector<std::uint64_t> rw = r.bitmap.empty() ? toWords(r) : std::vector<std::uint64_t>();
+                const std::uint64_t *w = r.bitmap.empty() ? rw.data() : r.bitmap.data();
+                for (std::uint32_t k = 0; k < bitmapWords; k++) {
+                    words[k] = wordOp(words[k], w[k]);
+                }
+                nonEmpty = fromWords(c, std::move(words));
+            }
+            if (nonEmpty) {
+                result.mChunks.push_back(std::move(c));
+            }
+        }
+        return result;
+    }
+
+    inline bool AMRoaringRangeSet::nextLocal(const Chunk &c, std::uint32_t pos, std::uint32_t &lo, std::uint32_t &hi)
+    {
+        if (pos >= chunkSize) {
+            return false;
+        }
+        if (!c.bitmap.empty()) {
+            lo = nextBit(c.bitmap.data(), pos, true);
+            if (lo == chunkSize) {
+                return false;
+            }
+            hi = nextBit(c.bitmap.data(), lo, false);
+            return true;
+        }
+        std::vector<Run>::const_iterator it = std::partition_point(c.runs.begin(), c.runs.end(),
+                                                                   [pos](const Run &r) { return r.last < pos; });
+        if (it == c.runs.end()) {
+            return false;
+        }
+        lo = it->first < pos ? pos : it->first;
+        hi = std::uint32_t(it->last) + 1;
+        return true;
+    }
+
+    inline void AMRoaringRangeSet::toLocal(const Chunk &c, std::vector<AMRange<std::uint32_t> > &local)
+    {
+        if (c.bitmap.empty()) {
+            local.reserve(local.size() + c.runs.size());
+            for (const Run &r : c.runs) {
+                local.push_back(AMRange<std::uint32_t>(r.first, std::uint32_t(r.last) + 1));
+            }
+            return;
+        }
+        std::uint32_t lo, hi = 0;
+        while (nextLocal(c, hi, lo, hi)) {
+            local.push_back(AMRange<std::uint32_t>(lo, hi));
+        }
+    }
+
+    inline std::vector<std::uint64_t> AMRoaringRangeSet::toWords(const Chunk &c)
+    {
+        if (!c.bitmap.empty()) {
+            return c.bitmap;
+        }
+        std::vector<std::uint64_t> words(bitmapWords, 0);
+        for (const Run &r : c.runs) {
+            fillBits(words.data(), r.first, std::uint32_t(r.last) + 1, true);
+        }
+        return words;
+    }
+
+    inline bool AMRoaringRangeSet::fromLocal(Chunk &c, const std::vector<AMRange<std::uint32_t> > &local)
+    {
+        if (local.size() > AMRANGE_ROARING_MAX_RUNS) {
+            std::vector<std::uint64_t> words(bitmapWords, 0);
+            for (const AMRange<std::uint32_t> &r : local) {
+                fillBits(words.data(), r.from, r.to, true);
+            }
+            return fromWords(c, std::move(words));
+        }
+        c.bitmap = std::vector<std::uint64_t>();
+        c.runs.clear();
+        c.runs.reserve(local.size());
+        c.cardinality = 0;
+        for (const AMRange<std::uint32_t> &r : local) {
+            c.runs.push_back(Run{std::uint16_t(r.from), std::uint16_t(r.to - 1)});
+            c.cardinality += r.to - r.from;
+        }
+        c.runCount = std::uint32_t(local.size());
+        return !local.empty();
+    }
+
+    inline bool AMRoaringRangeSet::fromWords(Chunk &c, std::vector<std::uint64_t> &&words)
+    {
+        //run starts are set bits with clear bit below, counted by popcount
+        std::uint32_t cardinality = 0, runCount = 0;
+        std::uint64_t carry = 0;
+        for (std::uint32_t k = 0; k < bitmapWords; k++) {
+            std::uint64_t w = words[k];
+            cardinality += popcount(w);
+            runCount += popcount(w & ~((w << 1) | carry));
+            carry = w >> 63;
+        }
+        c.cardinality = cardinality;
+        c.runCount = runCount;
+        c.runs.clear();
+        if (runCount > AMRANGE_ROARING_MAX_RUNS) {
+            c.bitmap = std::move(words);
+            return true;
+        }
+        c.runs.reserve(runCount);
+        std::uint32_t lo, hi = 0;
+        while ((lo = nextBit(words.data(), hi, true)) != chunkSize) {
+            hi = nextBit(words.data(), lo, false);
+            c.runs.push_back(Run{std::uint16_t(lo), std::uint16_t(hi - 1)});
+        }
+        c.bitmap = std::vector<std::uint64_t>();
+        return runCount != 0;
+    }
+
+    inline bool AMRoaringRangeSet::localCovers(const Chunk &c, std::uint32_t lo, std::uint32_t hi)
+    {
+        std::uint32_t from, to;
+        return nextLocal(c, lo, from, to) && from == lo && to >= hi;
+    }
+
+    inline std::uint32_t AMRoaringRangeSet::nextBit(const std::uint64_t *words, std::uint32_t pos, bool set)
+    {
+        if (pos >= chunkSize) {
+            return chunkSize;
+        }
+        std::uint64_t flip = set ? 0 : ~std::uint64_t(0);
+        std::uint32_t k = pos >> 6;
+        std::uint64_t w = (words[k] ^ flip) & (~std::uint64_t(0) << (pos & 63));
+        while (w == 0) {
+            if (++k == bitmapWords) {
+                return chunkSize;
+            }
+            w = words[k] ^ flip;
+        }
+        return (k << 6) + ctz(w);
+    }
+
+    inline void AMRoaringRangeSet::fillBits(std::uint64_t *words, std::uint32_t lo, std::uint32_t hi, bool set)
+    {
+        if (lo >= hi) {
+            return;
+        }
+        std::uint32_t first = lo >> 6;
+        std::uint32_t last = (hi - 1) >> 6;
+        std::uint64_t firstMask = ~std::uint64_t(0) << (lo & 63);
+        std::uint64_t lastMask = ~std::uint64_t(0) >> (63 - ((hi - 1) & 63));
+        for (std::uint32_t k = first; k <= last; k++) {
+            std::uint64_t mask = ~std::uint64_t(0);
+            if (k == first) {
+                mask &= firstMask;
+            }
+            if (k == last) {
+                mask &= lastMask;
+            }
+            words[k] = set ? words[k] | mask : words[k] & ~mask;
+        }
+    }
+
+    inline unsigned AMRoaringRangeSet::popcount(std::uint64_t w)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return unsigned(__builtin_popcountll(w));
+#else
+        w = w - ((w >> 1) & 0x5555555555555555ULL);
+        w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+        w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return unsigned((w * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    inline unsigned AMRoaringRangeSet::ctz(std::uint64_t w)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return unsigned(__builtin_ctzll(w));
+#else
+        return popcount((w & (0 - w)) - 1);
+#endif
+    }
+
+    inline AMRoaringRangeSet operator+(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right)
+    {
+        return AMRoaringRangeSet::unite(left, right);
+    }
+
+    inline AMRoaringRangeSet operator-(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right)
+    {
+        return AMRoaringRangeSet::subtract(left, right);
+    }
+
+    inline AMRoaringRangeSet operator&(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right)
+    {
+        return AMRoaringRangeSet::intersect(left, right);
+    }
+
+    inline AMRoaringRangeSet operator^(const AMRoaringRangeSet &left, const AMRoaringRangeSet &right)
+    {
+        return AMRoaringRangeSet::symmetricDifference(left, right);
+    }
+}
+
+/** @} */
+
+#endif //AMCORE_AMROARINGRANGESET_H
@@ -0,0 +1,365 @@
+/**
+ * @file: AMStagedRangeSet.h
+ * Set of ranges with staging buffer for cheap unpacked inserts
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMSTAGEDRANGESET_H
+#define AMCORE_AMSTAGEDRANGESET_H
+
+#include "AMRangeSet.h"
+#include <algorithm>
+#include <vector>
+
+/**
+ *  @brief number of staged ranges, which are packed automatically
+ */
+#ifndef AMRANGE_STAGED_LIMIT
+#define AMRANGE_STAGED_LIMIT 65536
+#endif
+
+/**
+ *  @brief maximal number of dirty regions, nearest regions are joined above it
+ */
+#ifndef AMRANGE_STAGED_DIRTY_REGIONS
+#define AMRANGE_STAGED_DIRTY_REGIONS 64
+#endif
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Common
+     *  @brief Set of ranges with staging buffer for cheap unpacked inserts
+     *
+     *  Inserted ranges are appended to staging buffer in any order, e.q. O(1) time, and they are tracked
+     *  as sorted list of disjoint dirty regions, regions are joined only when they overlap or touch.
+     *  Packed part outside of dirty regions is final. pack() sorts and packs staged ranges and merges them
+     *  in place only with packed ranges of dirty regions, ranges between regions are not rewritten, so
+     *  packing k ranges inserted into few small regions takes O(k log k + k log n) time plus move of
+     *  following ranges, not O(n) rebuild of whole set, even when regions are far from each other.
+     *
+     *  Staging buffer is packed automatically when it reaches AMRANGE_STAGED_LIMIT ranges. Number of dirty
+     *  regions is kept below AMRANGE_STAGED_DIRTY_REGIONS by joining two regions with smallest gap.
+     */
+    template<typename T>
+    class AMStagedRangeSet
+    {
+    public:
+        /**
+         *  @brief value type
+         */
+        typedef AMRange<T> value_type;
+        /**
+         *  @brief size type
+         */
+        typedef std::size_t size_type;
+
+        /**
+         *  @brief empty constructor
+         *  @throw This function will not throw an exception.
+         */
+        AMStagedRangeSet();
+
+        /**
+         *  @brief constructor
+         *  @param s packed ranges
+         *  @throw This function will not throw an exception.
+         */
+        explicit AMStagedRangeSet(AMRangeSet<T> s);
+
+        /**
+         *  @brief add range to staging buffer
+         *  Empty and invalid ranges are skipped. Amortized O(1) time plus update of dirty regions,
+         *  O(log d + d) time for d regions, unless buffer reaches limit.
+         *  @param r range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        void insert(const AMRange<T> &r);
+
+        /**
+         *  @brief add ranges to staging buffer
+         *  @param first first range in any order
+         *  @param last end of ranges
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last);
+
+        /**
+         *  @brief remove range
+         *  Staged ranges are packed first.
+         *  @param r range
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        void erase(const AMRange<T> &r);
+
+        /**
+         *  @brief number of staged ranges
+         *  @throw This function will not throw an exception.
+         */
+        inline size_type staged() const;
+
+        /**
+         *  @brief dirty regions, sorted and disjoint, empty when nothing is staged
+         *  Every staged range is inside one of them.
+         *  @throw This function will not throw an exception.
+         */
+        inline const std::vector<AMRange<T> > &dirty() const;
+
+        /**
+         *  @brief test that nothing is staged
+         *  @throw This function will not throw an exception.
+         */
+        inline bool isPacked() const;
+
+        /**
+         *  @brief merge staged ranges into packed ones
+         *  Staged ranges are sorted and packed, then they are merged region by region only with packed ranges
+         *  they touch, and all regions are written into packed array in one pass.
+         *  @throw std::bad_alloc if allocation fails, staged ranges are kept then (packed among themselves).
+         */
+        void pack();
+
+        /**
+         *  @brief all ranges packed
+         *  Staged ranges are packed first.
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        const AMRangeSet<T> &packed();
+
+        /**
+         *  @brief ranges packed so far, without staged ones
+         *  Ranges outside of dirty regions are final.
+         *  @throw This function will not throw an exception.
+         */
+        inline const AMRangeSet<T> &clean() const;
+
+        /**
+         *  @brief test that number is in set
+         *  Packed ranges are searched in O(log n) time, staged ones in O(k) time, only when number is
+         *  in one of dirty regions.
+         *  @param num
+         *  @throw This function will not throw an exception.
+         */
+        bool contains(T num) const;
+
+        /**
+         *  @brief remove all ranges
+         *  @throw This function will not throw an exception.
+         */
+        void clear();
+
+    private:
+        /**
+         *  @brief add range to dirty regions
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        void markDirty(const AMRange<T> &r);
+
+        AMRangeSet<T> mPacked;
+        std::vector<AMRange<T> > mStaged;
+        std::vector<AMRange<T> > mDirty;
+    };
+
+
+    template<typename T>
+    AMStagedRangeSet<T>::AMStagedRangeSet()
+    {
+    }
+
+    template<typename T>
+    AMStagedRangeSet<T>::AMStagedRangeSet(AMRangeSet<T> s)
+        : mPacked(std::move(s))
+    {
+    }
+
+    template<typename T>
+    void AMStagedRangeSet<T>::insert(const AMRange<T> &r)
+    {
+        if (!r.nonEmpty()) {
+            return;
+        }
+        //extra dirty region left by failed push_back is harmless
+        markDirty(r);
+        mStaged.push_back(r);
+        if (mStaged.size() >= AMRANGE_STAGED_LIMIT) {
+            pack();
+        }
+    }
+
+    template<typename T>
+    template<typename InputIt>
+    void AMStagedRangeSet<T>::insert(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    template<typename T>
+    void AMStagedRangeSet<T>::erase(const AMRange<T> &r)
+    {
+        pack();
+        mPacked -= r;
+    }
+
+    template<typename T>
+    inline typename AMStagedRangeSet<T>::size_type AMStagedRangeSet<T>::staged() const
+    {
+        return mStaged.size();
+    }
+
+    template<typename T>
+    inline const std::vector<AMRange<T> > &AMStagedRangeSet<T>::dirty() const
+    {
+        return mDirty;
+    }
+
+    template<typename T>
+    inline bool AMStagedRangeSet<T>::isPacked() const
+    {
+        return mStaged.empty();
+    }
+
+    template<typename T>
+    void AMStagedRangeSet<T>::pack()
+    {
+        if (mStaged.empty()) {
+            return;
+        }
+        typedef typename AMRangeSet<T>::Window Window;
+        typedef typename std::vector<AMRange<T> >::const_iterator const_iterator;
+        sortAndPack(mStaged);
+        //window of packed ranges touched by staged ranges of each region, staged ranges of window end at runs[i]
+        const std::vector<AMRange<T> > &packed = mPacked.mRanges;
+        std::vector<Window> windows;
+        std::vector<size_type> runs;
+        windows.reserve(mDirty.size());
+        runs.reserve(mDirty.size());
+        const_iterator staged = mStaged.begin();
+        const_iterator from = packed.begin();
+        for (const AMRange<T> &region : mDirty) {
+            const_iterator end = std::partition_point(staged, mStaged.cend(),
+                                                      [&region](const AMRange<T> &r) { return r.to <= region.to; });
+            if (staged == end) {
+                continue;
+            }
+            T lo = staged->from;
+            T hi = (end - 1)->to;
+            const_iterator first = std::partition_point(from, packed.end(),
+                                                        [lo](const AMRange<T> &r) { return r.to < lo; });
+            const_iterator last = std::partition_point(first, packed.end(),
+                                                       [hi](const AMRange<T> &r) { return r.from <= hi; });
+            size_type at = first - packed.begin();
+            if (!windows.empty() && at < windows.back().last) {
+                //packed range spans two regions
+                windows.back().last = last - packed.begin();
+                runs.back() = end - mStaged.begin();
+            } else {
+                windows.push_back(Window{at, size_type(last - packed.begin()), 0});
+                runs.push_back(end - mStaged.begin());
+            }
+            staged = end;
+            from = first;
+        }
+        //staged and packed ranges of each window are merged, nothing outside of windows is read
+        std::vector<AMRange<T> > merged;
+        merged.reserve(mStaged.size() + windows.size());
+        size_type s = 0;
+        for (size_type i = 0; i < windows.size(); i++) {
+            size_type before = merged.size();
+            const_iterator p = packed.begin() + windows[i].first;
+            const_iterator pe = packed.begin() + windows[i].last;
+            const_iterator q = mStaged.begin() + s;
+            const_iterator qe = mStaged.begin() + runs[i];
+            while (p != pe || q != qe) {
+                const AMRange<T> &r = q == qe || (p != pe && p->from < q->from) ? *p++ : *q++;
+                if (merged.size() > before && r.from <= merged.back().to) {
+                    merged.back().to = std::max(merged.back().to, r.to);
+                } else {
+                    merged.push_back(r);
+                }
+            }
+            windows[i].count = merged.size() - before;
+            s = runs[i];
+        }
+        mPacked.replaceWindows(windows.data(), windows.size(), merged.data());
+        //buffer keeps its capacity for next inserts
+        mStaged.clear();
+        mDirty.clear();
+    }
+
+    template<typename T>
+    const AMRangeSet<T> &AMStagedRangeSet<T>::packed()
+    {
+        pack();
+        return mPacked;
+    }
+
+    template<typename T>
+    inline const AMRangeSet<T> &AMStagedRangeSet<T>::clean() const
+    {
+        return mPacked;
+    }
+
+    template<typename T>
+    bool AMStagedRangeSet<T>::contains(T num) const
+    {
+        if (mPacked.find(num) != mPacked.end()) {
+            return true;
+        }
+        typename std::vector<AMRange<T> >::const_iterator region =
+            std::partition_point(mDirty.begin(), mDirty.end(), [num](const AMRange<T> &r) { return r.to <= num; });
+        if (region == mDirty.end() || region->from > num) {
+            return false;
+        }
+        return std::any_of(mStaged.begin(), mStaged.end(), [num](const AMRange<T> &r) { return r.in(num); });
+    }
+
+    template<typename T>
+    void AMStagedRangeSet<T>::clear()
+    {
+        mPacked.clear();
+        mStaged.clear();
+        mDirty.clear();
+    }
+
+    template<typename T>
+    void AMStagedRangeSet<T>::markDirty(const AMRange<T> &r)
+    {
+        typename std::vector<AMRange<T> >::iterator first =
+            std::partition_point(mDirty.begin(), mDirty.end(), [&r](const AMRange<T> &d) { return d.to < r.from; });
+        typename std::vector<AMRange<T> >::iterator last =
+            std::partition_point(first, mDirty.end(), [&r](const AMRange<T> &d) { return d.from <= r.to; });
+        if (first == last) {
+            mDirty.insert(first, r);
+        } else {
+            first->from = std::min(first->from, r.from);
+            first->to = std::max((last - 1)->to, r.to);
+            mDirty.erase(first + 1, last);
+        }
+        if (mDirty.size() <= AMRANGE_STAGED_DIRTY_REGIONS) {
+            return;
+        }
+        //too many regions, the two nearest ones are joined
+        std::size_t nearest = 0;
+        for (std::size_t i = 1; i + 1 < mDirty.size(); i++) {
+            if (AMCore::measure(AMRange<T>(mDirty[i].to, mDirty[i + 1].from)) <
+                AMCore::measure(AMRange<T>(mDirty[nearest].to, mDirty[nearest + 1].from))) {
+                nearest = i;
+            }
+        }
+        mDirty[nearest].to = mDirty[nearest + 1].to;
+        mDirty.erase(mDirty.begin() + nearest + 1);
+    }
+}
+
+/** @} */
+
+#endif //AMCORE_AMSTAGEDRANGESET_H
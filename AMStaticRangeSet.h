@@ -0,0 +1,660 @@
+/**
+ * @file: AMStaticRangeSet.h
+ * Fixed capacity set of ranges usable in constant expressions
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMSTATICRANGESET_H
+#define AMCORE_AMSTATICRANGESET_H
+
+#include "AMRangeSet.h"
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+/**
+ *  @ingroup Common
+ *  @{
+ */
+
+namespace AMCore {
+
+    /**
+     *  @ingroup Common
+     *  @brief Fixed capacity set of ranges usable in constant expressions
+     *
+     *  Set of at most N ranges stored inline in sorted array, packed as AMRangeSet. Whole API except
+     *  toRangeSet() is constexpr, so table of fixed ranges declared as constexpr variable is built by compiler
+     *  and placed into read only data, nothing is sorted, packed or allocated at startup:
+     *
+     *      static constexpr AMStaticRangeSet<int, 4> opcodes = {AMRange(0x10, 0x20), AMRange(0x40, 0x48)};
+     *      static_assert(opcodes.contains(0x41));
+     *
+     *  Lookups are binary searches, e.q. O(log N) time. Modifications move following ranges, e.q. O(N) time.
+     *  Operation which would need more than N ranges throws std::length_error, in constant expression it is
+     *  compile error.
+     */
+    template<typename T, std::size_t N>
+    class AMStaticRangeSet
+    {
+        static_assert(N > 0, "capacity of AMStaticRangeSet must be positive");
+
+    public:
+        /**
+         *  @brief const iterator
+         */
+        typedef const AMRange<T> *const_iterator;
+        /**
+         *  @brief iterator, ranges are read only
+         */
+        typedef const_iterator iterator;
+        /**
+         *  @brief value type
+         */
+        typedef AMRange<T> value_type;
+        /**
+         *  @brief size type
+         */
+        typedef std::size_t size_type;
+        /**
+         *  @brief type of measure
+         */
+        typedef AMRangeMeasure<T> measure_type;
+
+        /**
+         *  @brief empty constructor
+         *  @throw This function will not throw an exception.
+         */
+        constexpr AMStaticRangeSet() noexcept;
+
+        /**
+         *  @brief constructor
+         *  @param r range, empty and invalid range makes empty set
+         *  @throw This function will not throw an exception.
+         */
+        constexpr AMStaticRangeSet(const AMRange<T> &r) noexcept;
+
+        /**
+         *  @brief constructor
+         *  Ranges in any order are inserted one by one, every intermediate set must fit into capacity.
+         *  @param l ranges
+         *  @throw std::length_error if ranges do not fit into capacity.
+         */
+        constexpr AMStaticRangeSet(std::initializer_list<AMRange<T> > l);
+
+        /**
+         *  @brief copy to flat set
+         *  @throw std::bad_alloc if allocation fails.
+         */
+        AMRangeSet<T> toRangeSet() const;
+
+        /**
+         *  @brief first range
+         *  @throw This function will not throw an exception.
+         */
+        constexpr const_iterator begin() const noexcept;
+
+        /**
+         *  @brief end of ranges
+         *  @throw This function will not throw an exception.
+         */
+        constexpr const_iterator end() const noexcept;
+
+        /**
+         *  @brief number of ranges
+         *  @throw This function will not throw an exception.
+         */
+        constexpr size_type size() const noexcept;
+
+        /**
+         *  @brief maximal number of ranges
+         *  @throw This function will not throw an exception.
+         */
+        static constexpr size_type capacity() noexcept;
+
+        /**
+         *  @brief test for empty
+         *  @throw This function will not throw an exception.
+         */
+        constexpr bool empty() const noexcept;
+
+        /**
+         *  @brief range at index
+         *  @param i index
+         *  @throw This function will not throw an exception.
+         */
+        constexpr const AMRange<T> &operator[](size_type i) const noexcept;
+
+        /**
+         *  @brief total length of ranges
+         *  O(n) time.
+         *  @throw This function will not throw an exception.
+         */
+        constexpr measure_type measure() const noexcept;
+
+        /**
+         *  @brief comparison operator
+         *  @param right operand
+         *  @throw This function will not throw an exception.
+         */
+        constexpr bool operator==(const AMStaticRangeSet &right) const noexcept;
+
+        /**
+         *  @brief comparison operator
+         *  @param right operand
+         *  @throw This function will not throw an exception.
+         */
+        constexpr bool operator!=(const AMStaticRangeSet &right) const noexcept;
+
+        /**
+         *  @brief find range containing number
+         *  O(log n) time.
+         *  @param num
+         *  @return range or end()
+         *  @throw This function will not throw an exception.
+         */
+        constexpr const_iterator find(T num) const noexcept;
+
+        /**
+         *  @brief test that number is in set
+         *  @param num
+         *  @throw This function will not throw an exception.
+         */
+        constexpr bool contains(T num) const noexcept;
+
+        /**
+         *  @brief test that whole range is in set
+         *  Empty range is always covered.
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        constexpr bool covers(const AMRange<T> &rng) const noexcept;
+
+        /**
+         *  @brief test that range has common part with set
+         *  @param rng range
+         *  @throw This function will not throw an exception.
+         */
+        constexpr bool overlaps(const AMRange<T> &rng) const noexcept;
+
+        /**
+         *  @brief plus operator
+         *  @param right operand
+         *  @throw std::length_error if result does not fit into capacity, set is unchanged then.
+         */
+        constexpr AMStaticRangeSet &operator+=(const AMRange<T> &right);
+
+        /**
+         *  @brief minus operator
+         *  @param right operand
+         *  @throw std::length_error if result does not fit into capacity, set is unchanged then.
+         */
+        constexpr AMStaticRangeSet &operator-=(const AMRange<T> &right);
+
+        /**
+         *  @brief intersection operator
+         *  @param right operand
+         *  @throw This function will not throw an exception.
+         */
+        constexpr AMStaticRangeSet &operator&=(const AMRange<T> &right) noexcept;
+
+        /**
+         *  @brief plus operator
+         *  @param right operand
+         *  @throw std::length_error if result does not fit into capacity, set is unchanged then.
+         */
+        constexpr AMStaticRangeSet &operator+=(const AMStaticRangeSet &right);
+
+        /**
+         *  @brief minus operator
+         *  @param right operand
+         *  @throw std::length_error if result does not fit into capacity, set is unchanged then.
+         */
+        constexpr AMStaticRangeSet &operator-=(const AMStaticRangeSet &right);
+
+        /**
+         *  @brief intersection operator
+         *  @param right operand
+         *  @throw std::length_error if result does not fit into capacity, set is unchanged then.
+         */
+        constexpr AMStaticRangeSet &operator&=(const AMStaticRangeSet &right);
+
+        /**
+         *  @brief union of sets
+         *  Single merge pass, e.q. O(n + m) time.
+         *  @param left operand
+         *  @param right operand
+         *  @throw std::length_error if result does not fit into capacity.
+         */
+        static constexpr AMStaticRangeSet unite(const AMStaticRangeSet &left, const AMStaticRangeSet &right);
+
+        /**
+         *  @brief difference of sets
+         *  Single merge pass, e.q. O(n + m) time.
+         *  @param left operand
+         *  @param right operand
+         *  @throw std::length_error if result does not fit into capacity.
+         */
+        static constexpr AMStaticRangeSet subtract(const AMStaticRangeSet &left, const AMStaticRangeSet &right);
+
+        /**
+         *  @brief intersection of sets
+         *  Single merge pass, e.q. O(n + m) time.
+         *  @param left operand
+         *  @param right operand
+         *  @throw std::length_error if result does not fit into capacity.
+         */
+        static constexpr AMStaticRangeSet intersect(const AMStaticRangeSet &left, const AMStaticRangeSet &right);
+
+    private:
+        /**
+         *  @brief index of first range for which pred is false
+         *  Ranges must be partitioned by pred (std::partition_point is not constexpr in C++17).
+         */
+        template<typename Pred>
+        constexpr size_type partitionPoint(Pred pred) const noexcept;
+
+        /**
+         *  @brief replace ranges [first, last) by count ranges
+         *  @throw std::length_error if result does not fit into capacity, set is unchanged then.
+         */
+        constexpr void replace(size_type first, size_type last, const AMRange<T> *ranges, size_type count);
+
+        /**
+         *  @brief append range above all ranges, or join it with last one
+         *  @throw std::length_error if result does not fit into capacity.
+         */
+        constexpr void append(const AMRange<T> &r);
+
+        AMRange<T> mRanges[N];
+        size_type mSize;
+    };
+
+    /**
+     *  @brief plus operator
+     *  @param left operand
+     *  @param right operand
+     *  @throw std::length_error if result does not fit into capacity.
+     */
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> operator+(const AMStaticRangeSet<T, N> &left, const AMStaticRangeSet<T, N> &right);
+    /**
+     *  @brief minus operator
+     *  @param left operand
+     *  @param right operand
+     *  @throw std::length_error if result does not fit into capacity.
+     */
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> operator-(const AMStaticRangeSet<T, N> &left, const AMStaticRangeSet<T, N> &right);
+    /**
+     *  @brief intersection operator
+     *  @param left operand
+     *  @param right operand
+     *  @throw std::length_error if result does not fit into capacity.
+     */
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> operator&(const AMStaticRangeSet<T, N> &left, const AMStaticRangeSet<T, N> &right);
+
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N>::AMStaticRangeSet() noexcept
+        : mRanges(),
+          mSize(0)
+    {
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N>::AMStaticRangeSet(const AMRange<T> &r) noexcept
+        : mRanges(),
+          mSize(0)
+    {
+        if (r.nonEmpty()) {
+            mRanges[0] = r;
+            mSize = 1;
+        }
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N>::AMStaticRangeSet(std::initializer_list<AMRange<T> > l)
+        : mRanges(),
+          mSize(0)
+    {
+        for (const AMRange<T> &r : l) {
+            *this += r;
+        }
+    }
+
+    template<typename T, std::size_t N>
+    AMRangeSet<T> AMStaticRangeSet<T, N>::toRangeSet() const
+    {
+        return AMRangeSet<T>::fromPacked(std::vector<AMRange<T> >(begin(), end()));
+    }
+
+    template<typename T, std::size_t N>
+    constexpr typename AMStaticRangeSet<T, N>::const_iterator AMStaticRangeSet<T, N>::begin() const noexcept
+    {
+        return mRanges;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr typename AMStaticRangeSet<T, N>::const_iterator AMStaticRangeSet<T, N>::end() const noexcept
+    {
+        return mRanges + mSize;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr typename AMStaticRangeSet<T, N>::size_type AMStaticRangeSet<T, N>::size() const noexcept
+    {
+        return mSize;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr typename AMStaticRangeSet<T, N>::size_type AMStaticRangeSet<T, N>::capacity() noexcept
+    {
+        return N;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr bool AMStaticRangeSet<T, N>::empty() const noexcept
+    {
+        return mSize == 0;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr const AMRange<T> &AMStaticRangeSet<T, N>::operator[](size_type i) const noexcept
+    {
+        return mRanges[i];
+    }
+
+    template<typename T, std::size_t N>
+    constexpr typename AMStaticRangeSet<T, N>::measure_type AMStaticRangeSet<T, N>::measure() const noexcept
+    {
+        measure_type result = measure_type();
+        for (size_type i = 0; i < mSize; i++) {
+            result += AMCore::measure(mRanges[i]);
+        }
+        return result;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr bool AMStaticRangeSet<T, N>::operator==(const AMStaticRangeSet &right) const noexcept
+    {
+        if (mSize != right.mSize) {
+            return false;
+        }
+        for (size_type i = 0; i < mSize; i++) {
+            if (mRanges[i] != right.mRanges[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr bool AMStaticRangeSet<T, N>::operator!=(const AMStaticRangeSet &right) const noexcept
+    {
+        return !(*this == right);
+    }
+
+    template<typename T, std::size_t N>
+    constexpr typename AMStaticRangeSet<T, N>::const_iterator AMStaticRangeSet<T, N>::find(T num) const noexcept
+    {
+        size_type i = partitionPoint([num](const AMRange<T> &r) { return r.to <= num; });
+        if (i < mSize && mRanges[i].from <= num) {
+            return mRanges + i;
+        }
+        return end();
+    }
+
+    template<typename T, std::size_t N>
+    constexpr bool AMStaticRangeSet<T, N>::contains(T num) const noexcept
+    {
+        return find(num) != end();
+    }
+
+    template<typename T, std::size_t N>
+    constexpr bool AMStaticRangeSet<T, N>::covers(const AMRange<T> &rng) const noexcept
+    {
+        if (!rng.nonEmpty()) {
+            return true;
+        }
+        const_iterator it = find(rng.from);
+        return it != end() && it->to >= rng.to;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr bool AMStaticRangeSet<T, N>::overlaps(const AMRange<T> &rng) const noexcept
+    {
+        T from = rng.from;
+        size_type i = partitionPoint([from](const AMRange<T> &r) { return r.to <= from; });
+        return rng.nonEmpty() && i < mSize && mRanges[i].from < rng.to;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> &AMStaticRangeSet<T, N>::operator+=(const AMRange<T> &right)
+    {
+        if (!right.nonEmpty()) {
+            return *this;
+        }
+        //adjacent ranges are joined
+        T from = right.from;
+        T to = right.to;
+        size_type first = partitionPoint([from](const AMRange<T> &r) { return r.to < from; });
+        size_type last = partitionPoint([to](const AMRange<T> &r) { return r.from <= to; });
+        AMRange<T> joined = right;
+        if (first < last) {
+            joined.from = std::min(joined.from, mRanges[first].from);
+            joined.to = std::max(joined.to, mRanges[last - 1].to);
+        }
+        replace(first, last, &joined, 1);
+        return *this;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> &AMStaticRangeSet<T, N>::operator-=(const AMRange<T> &right)
+    {
+        if (!right.nonEmpty()) {
+            return *this;
+        }
+        T from = right.from;
+        T to = right.to;
+        size_type first = partitionPoint([from](const AMRange<T> &r) { return r.to <= from; });
+        size_type last = partitionPoint([to](const AMRange<T> &r) { return r.from < to; });
+        if (first == last) {
+            return *this;
+        }
+        AMRange<T> rest[2] = {};
+        size_type count = 0;
+        if (mRanges[first].from < from) {
+            rest[count++] = AMRange<T>(mRanges[first].from, from);
+        }
+        if (mRanges[last - 1].to > to) {
+            rest[count++] = AMRange<T>(to, mRanges[last - 1].to);
+        }
+        replace(first, last, rest, count);
+        return *this;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> &AMStaticRangeSet<T, N>::operator&=(const AMRange<T> &right) noexcept
+    {
+        if (!right.nonEmpty()) {
+            mSize = 0;
+            return *this;
+        }
+        T from = right.from;
+        T to = right.to;
+        size_type first = partitionPoint([from](const AMRange<T> &r) { return r.to <= from; });
+        size_type last = partitionPoint([to](const AMRange<T> &r) { return r.from < to; });
+        for (size_type i = first; i < last; i++) {
+            mRanges[i - first] = mRanges[i];
+        }
+        mSize = last > first ? last - first : 0;
+        if (mSize > 0) {
+            mRanges[0].from = std::max(mRanges[0].from, from);
+            mRanges[mSize - 1].to = std::min(mRanges[mSize - 1].to, to);
+        }
+        return *this;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> &AMStaticRangeSet<T, N>::operator+=(const AMStaticRangeSet &right)
+    {
+        *this = unite(*this, right);
+        return *this;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> &AMStaticRangeSet<T, N>::operator-=(const AMStaticRangeSet &right)
+    {
+        *this = subtract(*this, right);
+        return *this;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> &AMStaticRangeSet<T, N>::operator&=(const AMStaticRangeSet &right)
+    {
+        *this = intersect(*this, right);
+        return *this;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> AMStaticRangeSet<T, N>::unite(const AMStaticRangeSet &left,
+                                                                   const AMStaticRangeSet &right)
+    {
+        AMStaticRangeSet<T, N> result;
+        size_type i = 0;
+        size_type j = 0;
+        while (i < left.mSize || j < right.mSize) {
+            if (j == right.mSize || (i < left.mSize && left.mRanges[i].from < right.mRanges[j].from)) {
+                result.append(left.mRanges[i++]);
+            } else {
+                result.append(right.mRanges[j++]);
+            }
+        }
+        return result;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> AMStaticRangeSet<T, N>::subtract(const AMStaticRangeSet &left,
+                                                                      const AMStaticRangeSet &right)
+    {
+        AMStaticRangeSet<T, N> result;
+        size_type j = 0;
+        for (size_type i = 0; i < left.mSize; i++) {
+            const AMRange<T> &l = left.mRanges[i];
+            while (j < right.mSize && right.mRanges[j].to <= l.from) {
+                j++;
+            }
+            T from = l.from;
+            for (size_type k = j; k < right.mSize && right.mRanges[k].from < l.to; k++) {
+                if (right.mRanges[k].from > from) {
+                    result.append(AMRange<T>(from, right.mRanges[k].from));
+                }
+                from = right.mRanges[k].to;
+            }
+            if (from < l.to) {
+                result.append(AMRange<T>(from, l.to));
+            }
+        }
+        return result;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> AMStaticRangeSet<T, N>::intersect(const AMStaticRangeSet &left,
+                                                                       const AMStaticRangeSet &right)
+    {
+        AMStaticRangeSet<T, N> result;
+        size_type i = 0;
+        size_type j = 0;
+        while (i < left.mSize && j < right.mSize) {
+            AMRange<T> common = AMCore::intersect(left.mRanges[i], right.mRanges[j]);
+            if (common.nonEmpty()) {
+                result.append(common);
+            }
+            if (left.mRanges[i].to < right.mRanges[j].to) {
+                i++;
+            } else {
+                j++;
+            }
+        }
+        return result;
+    }
+
+    template<typename T, std::size_t N>
+    template<typename Pred>
+    constexpr typename AMStaticRangeSet<T, N>::size_type AMStaticRangeSet<T, N>::partitionPoint(Pred pred) const noexcept
+    {
+        size_type first = 0;
+        size_type count = mSize;
+        while (count > 0) {
+            size_type half = count / 2;
+            if (pred(mRanges[first + half])) {
+                first += half + 1;
+                count -= half + 1;
+            } else {
+                count = half;
+            }
+        }
+        return first;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr void AMStaticRangeSet<T, N>::replace(size_type first, size_type last, const AMRange<T> *ranges,
+                                                   size_type count)
+    {
+        size_type size = mSize - (last - first) + count;
+        if (size > N) {
+            throw std::length_error("AMStaticRangeSet capacity exceeded");
+        }
+        if (count > last - first) {
+            for (size_type i = mSize; i > last; i--) {
+                mRanges[i - 1 + count - (last - first)] = mRanges[i - 1];
+            }
+        } else {
+            for (size_type i = last; i < mSize; i++) {
+                mRanges[i + count - (last - first)] = mRanges[i];
+            }
+        }
+        for (size_type i = 0; i < count; i++) {
+            mRanges[first + i] = ranges[i];
+        }
+        mSize = size;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr void AMStaticRangeSet<T, N>::append(const AMRange<T> &r)
+    {
+        if (mSize > 0 && mRanges[mSize - 1].to >= r.from) {
+            mRanges[mSize - 1].to = std::max(mRanges[mSize - 1].to, r.to);
+            return;
+        }
+        if (mSize == N) {
+            throw std::length_error("AMStaticRangeSet capacity exceeded");
+        }
+        mRanges[mSize++] = r;
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> operator+(const AMStaticRangeSet<T, N> &left, const AMStaticRangeSet<T, N> &right)
+    {
+        return AMStaticRangeSet<T, N>::unite(left, right);
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> operator-(const AMStaticRangeSet<T, N> &left, const AMStaticRangeSet<T, N> &right)
+    {
+        return AMStaticRangeSet<T, N>::subtract(left, right);
+    }
+
+    template<typename T, std::size_t N>
+    constexpr AMStaticRangeSet<T, N> operator&(const AMStaticRangeSet<T, N> &left, const AMStaticRangeSet<T, N> &right)
+    {
+        return AMStaticRangeSet<T, N>::intersect(left, right);
+    }
+}
+
+/** @} */
+
+#endif //AMCORE_AMSTATICRANGESET_H
@@ -0,0 +1,144 @@
+#include "AMRangeBench.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/*
+ * Every allocation of benchmark binary is counted. All replaceable forms of operator new and delete are
+ * replaced together, so every pointer is released by the function matching the one which allocated it.
+ */
+static std::atomic<std::size_t> gAllocatedBytes(0);
+static std::atomic<std::size_t> gAllocationCount(0);
+
+std::size_t allocatedBytes()
+{
+    return gAllocatedBytes.load(std::memory_order_relaxed);
+}
+
+std::size_t allocationCount()
+{
+    return gAllocationCount.load(std::memory_order_relaxed);
+}
+
+static void *countedAlloc(std::size_t size, std::size_t alignment) noexcept
+{
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+    //aligned_alloc needs size multiple of alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+static void *countedNew(std::size_t size, std::size_t alignment)
+{
+    void *p = countedAlloc(size, alignment);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new(std::size_t size)
+{
+    return countedNew(size, alignof(std::max_align_t));
+}
+
+void *operator new[](std::size_t size)
+{
+    return countedNew(size, alignof(std::max_align_t));
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size, alignof(std::max_align_t));
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size, alignof(std::max_align_t));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return countedNew(size, std::size_t(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return countedNew(size, std::size_t(alignment));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size, std::size_t(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size, std::size_t(alignment));
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    std::free(p);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file: AMRangeBench.h
+ * Helpers shared by benchmarks
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMRANGEBENCH_H
+#define AMCORE_AMRANGEBENCH_H
+
+#include "../../AMRange.h"
+#include "benchmark/benchmark.h"
+#include <cstddef>
+#include <cstdint>
+#include <set>
+
+/*
+ * Bytes and count of all allocations of benchmark binary so far. Global operator new and delete are replaced
+ * in AMRangeBench.cpp, in separate translation unit, so they are never inlined into callers.
+ */
+std::size_t allocatedBytes();
+std::size_t allocationCount();
+
+/*
+ * Reports items/s and allocations of timed loop.
+ */
+class AllocationCounter
+{
+public:
+    AllocationCounter()
+        : mBytes(allocatedBytes()),
+          mCount(allocationCount())
+    {
+    }
+
+    void report(benchmark::State &state, int64_t itemsPerIteration) const
+    {
+        state.SetItemsProcessed(state.iterations() * itemsPerIteration);
+        state.counters["bytes_alloc"] = benchmark::Counter(double(allocatedBytes() - mBytes),
+                                                           benchmark::Counter::kAvgIterations);
+        state.counters["allocs"] = benchmark::Counter(double(allocationCount() - mCount),
+                                                      benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    std::size_t mBytes;
+    std::size_t mCount;
+};
+
+/*
+ * Overlap density of generated ranges. Range i starts at 4 * i + offset, disjoint ranges are 2 long,
+ * adjacent ranges are 4 long and touch the next one, overlapping ranges are 12 long and overlap next two ones.
+ */
+enum Density
+{
+    Disjoint,
+    Adjacent,
+    Overlapping
+};
+
+template<typename T>
+inline std::set<AMCore::AMRange<T> > makeRanges(int64_t count, int64_t density, int offset)
+{
+    static const int lengths[] = {2, 4, 12};
+    std::set<AMCore::AMRange<T> > s;
+    for (int64_t i = 0; i < count; i++) {
+        T from = T(i * 4 + offset);
+        s.insert(s.end(), AMCore::AMRange<T>(from, from + T(lengths[density])));
+    }
+    return s;
+}
+
+/*
+ * Sizes 10 .. 10^7 for every density.
+ */
+inline void sizesAndDensities(benchmark::internal::Benchmark *b)
+{
+    b->ArgsProduct({{10, 1000, 100000, 10000000}, {Disjoint, Adjacent, Overlapping}})->ArgNames({"n", "density"});
+}
+
+/*
+ * Benchmark template instantiated for int, int64_t and double.
+ */
+#define AMRANGE_BENCHMARK(name, args) \
+    BENCHMARK_TEMPLATE(name, int)->Apply(args); \
+    BENCHMARK_TEMPLATE(name, int64_t)->Apply(args); \
+    BENCHMARK_TEMPLATE(name, double)->Apply(args)
+
+#endif //AMCORE_AMRANGEBENCH_H
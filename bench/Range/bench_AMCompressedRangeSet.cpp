@@ -0,0 +1,103 @@
+#include "../../AMCompressedRangeSet.h"
+#include "benchmark/benchmark.h"
+#include <random>
+
+using namespace AMCore;
+
+/*
+ * Packed set of n ranges with random lengths and gaps below maxDelta.
+ */
+template<typename T>
+static AMRangeSet<T> makePacked(int64_t count, int64_t maxDelta)
+{
+    std::mt19937 random(count);
+    std::vector<AMRange<T> > v(count);
+    T from = 0;
+    for (int64_t i = 0; i < count; i++) {
+        T to = T(from + 1 + T(random() % maxDelta));
+        v[i] = AMRange<T>(from, to);
+        from = T(to + 1 + T(random() % maxDelta));
+    }
+    return AMRangeSet<T>::fromPacked(std::move(v));
+}
+
+static void countsAndDeltas(benchmark::internal::Benchmark *b)
+{
+    b->ArgsProduct({{1000, 1000000}, {16, 1000, 1000000}})->ArgNames({"n", "delta"});
+}
+
+template<typename T>
+static void BM_compressedMemory(benchmark::State &state)
+{
+    AMRangeSet<T> s = makePacked<T>(state.range(0), state.range(1));
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        AMCompressedRangeSet<T> c(s);
+        bytes = c.memoryUsage();
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes_per_range"] = double(bytes) / double(state.range(0));
+    state.counters["ratio"] = double(bytes) / double(s.size() * sizeof(AMRange<T>));
+}
+BENCHMARK_TEMPLATE(BM_compressedMemory, int)->Apply(countsAndDeltas);
+BENCHMARK_TEMPLATE(BM_compressedMemory, int64_t)->Apply(countsAndDeltas);
+
+template<typename T, typename Set>
+static void runFind(benchmark::State &state, const Set &s, T hi)
+{
+    std::mt19937 random(7);
+    std::vector<T> nums(4096);
+    for (T &num : nums) {
+        num = T(random() % uint64_t(hi));
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s.find(nums[i++ & 4095]) != s.end());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+static void BM_flatFind(benchmark::State &state)
+{
+    AMRangeSet<T> s = makePacked<T>(state.range(0), state.range(1));
+    runFind<T>(state, s, s[s.size() - 1].to);
+}
+BENCHMARK_TEMPLATE(BM_flatFind, int64_t)->Apply(countsAndDeltas);
+
+template<typename T>
+static void BM_compressedFind(benchmark::State &state)
+{
+    AMRangeSet<T> s = makePacked<T>(state.range(0), state.range(1));
+    AMCompressedRangeSet<T> c(s);
+    runFind<T>(state, c, s[s.size() - 1].to);
+}
+BENCHMARK_TEMPLATE(BM_compressedFind, int64_t)->Apply(countsAndDeltas);
+
+template<typename T, typename Set>
+static void runScan(benchmark::State &state, const Set &s)
+{
+    for (auto _ : state) {
+        T sum = 0;
+        for (const AMRange<T> &r : s) {
+            sum += r.to - r.from;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename T>
+static void BM_flatScan(benchmark::State &state)
+{
+    runScan<T>(state, makePacked<T>(state.range(0), state.range(1)));
+}
+BENCHMARK_TEMPLATE(BM_flatScan, int64_t)->Apply(countsAndDeltas);
+
+template<typename T>
+static void BM_compressedScan(benchmark::State &state)
+{
+    runScan<T>(state, AMCompressedRangeSet<T>(makePacked<T>(state.range(0), state.range(1))));
+}
+BENCHMARK_TEMPLATE(BM_compressedScan, int64_t)->Apply(countsAndDeltas);
@@ -0,0 +1,83 @@
+#include "../../AMConcurrentRangeSet.h"
+#include "benchmark/benchmark.h"
+#include <mutex>
+#include <random>
+#include <thread>
+
+using namespace AMCore;
+
+/*
+ * Reserved windows like set, n ranges of length 10 with step 16.
+ */
+static AMRangeSet<int64_t> makeWindows(int64_t count)
+{
+    std::vector<AMRange<int64_t> > v(count);
+    for (int64_t i = 0; i < count; i++) {
+        v[i] = AMRange<int64_t>(i * 16, i * 16 + 10);
+    }
+    return AMRangeSet<int64_t>::fromPacked(std::move(v));
+}
+
+static void countsAndWriters(benchmark::internal::Benchmark *b)
+{
+    b->ArgsProduct({{1000, 100000}, {0, 1}})->ArgNames({"n", "writer"});
+}
+
+/*
+ * Lookups of one reader, with writer adding and removing window in background when writer is 1.
+ */
+template<typename Lookup, typename Write>
+static void runReader(benchmark::State &state, Lookup lookup, Write write)
+{
+    std::atomic<bool> stop(false);
+    std::atomic<int64_t> writes(0);
+    std::thread writer;
+    if (state.range(1)) {
+        writer = std::thread([&]() {
+            for (int64_t i = 0; !stop.load(); i++) {
+                write(i % state.range(0));
+                writes++;
+                std::this_thread::yield();
+            }
+        });
+    }
+    std::mt19937_64 random(1);
+    int64_t limit = state.range(0) * 16;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lookup(int64_t(random() % limit)));
+    }
+    stop = true;
+    if (writer.joinable()) {
+        writer.join();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["writes"] = double(writes.load());
+}
+
+static void BM_concurrentContains(benchmark::State &state)
+{
+    AMConcurrentRangeSet<int64_t> c(makeWindows(state.range(0)));
+    runReader(state, [&](int64_t num) { return c.contains(num); },
+              [&](int64_t i) {
+                  c.update({AMRange<int64_t>(i * 16 + 10, i * 16 + 12)}, {AMRange<int64_t>(i * 16 + 10, i * 16 + 12)});
+              });
+}
+BENCHMARK(BM_concurrentContains)->Apply(countsAndWriters)->UseRealTime();
+
+static void BM_mutexStdSetContains(benchmark::State &state)
+{
+    AMRangeStdSet<int64_t> s = makeWindows(state.range(0)).toSet();
+    std::mutex m;
+    runReader(state, [&](int64_t num) {
+                  std::lock_guard<std::mutex> lock(m);
+                  auto it = s.upper_bound(AMRange<int64_t>(num, std::numeric_limits<int64_t>::max()));
+                  return it != s.begin() && (--it)->in(num);
+              },
+              [&](int64_t i) {
+                  std::lock_guard<std::mutex> lock(m);
+                  AMRange<int64_t> r(i * 16 + 10, i * 16 + 12);
+                  s = s + AMRangeStdSet<int64_t>{r};
+                  s = s - AMRangeStdSet<int64_t>{r};
+              });
+}
+BENCHMARK(BM_mutexStdSetContains)->Apply(countsAndWriters)->UseRealTime();
@@ -0,0 +1,96 @@
+#include "../../AMFreeSpaceMap.h"
+#include "benchmark/benchmark.h"
+#include <random>
+
+using namespace AMCore;
+
+/*
+ * Fragmented disk like space, n used ranges with free gaps of 1 .. 64 blocks between them,
+ * every 1000th gap is 4096 blocks long.
+ */
+static AMRangeSet<int64_t> makeUsed(int64_t count)
+{
+    std::mt19937 random(1);
+    std::vector<AMRange<int64_t> > v(count);
+    int64_t from = 0;
+    for (int64_t i = 0; i < count; i++) {
+        v[i] = AMRange<int64_t>(from, from + 1 + random() % 64);
+        from = v[i].to + (i % 1000 == 999 ? 4096 : 1 + random() % 64);
+    }
+    return AMRangeSet<int64_t>::fromPacked(std::move(v));
+}
+
+static void countsAndLengths(benchmark::internal::Benchmark *b)
+{
+    b->ArgsProduct({{1000, 100000, 1000000}, {16, 1000}})->ArgNames({"n", "len"});
+}
+
+/*
+ * First gap of required length inside bound by linear scan of packed std::set.
+ */
+static void BM_stdSetFirstFit(benchmark::State &state)
+{
+    AMRangeStdSet<int64_t> used = makeUsed(state.range(0)).toSet();
+    int64_t end = used.rbegin()->to;
+    int64_t len = state.range(1);
+    int64_t i = 0;
+    for (auto _ : state) {
+        AMRange<int64_t> bound(i * 7919 % end, end);
+        AMRange<int64_t> found;
+        int64_t from = bound.from;
+        for (auto it = used.upper_bound(AMRange<int64_t>(from, from)); it != used.end(); ++it) {
+            if (it->from - from >= len) {
+                found = AMRange<int64_t>(from, from + len);
+                break;
+            }
+            from = std::max(from, it->to);
+        }
+        benchmark::DoNotOptimize(found);
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_stdSetFirstFit)->Apply(countsAndLengths);
+
+static void BM_freeSpaceFirstFit(benchmark::State &state)
+{
+    AMRangeSet<int64_t> used = makeUsed(state.range(0));
+    int64_t end = (used.end() - 1)->to;
+    AMFreeSpaceMap<int64_t> m(AMRange<int64_t>(0, end), used);
+    int64_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m.firstFit(state.range(1), AMRange<int64_t>(i * 7919 % end, end)));
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_freeSpaceFirstFit)->Apply(countsAndLengths);
+
+static void BM_freeSpaceBestFit(benchmark::State &state)
+{
+    AMRangeSet<int64_t> used = makeUsed(state.range(0));
+    AMFreeSpaceMap<int64_t> m(AMRange<int64_t>(0, (used.end() - 1)->to), used);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m.bestFit(state.range(1)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_freeSpaceBestFit)->Apply(countsAndLengths);
+
+/*
+ * Allocation and free of the same length, the way storage engine allocates blocks.
+ */
+static void BM_freeSpaceReserveRelease(benchmark::State &state)
+{
+    AMRangeSet<int64_t> used = makeUsed(state.range(0));
+    int64_t end = (used.end() - 1)->to;
+    AMFreeSpaceMap<int64_t> m(AMRange<int64_t>(0, end), used);
+    int64_t i = 0;
+    for (auto _ : state) {
+        AMRange<int64_t> r = m.reserveNextFit(state.range(1), i * 7919 % end);
+        m.release(r);
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_freeSpaceReserveRelease)->Apply(countsAndLengths);
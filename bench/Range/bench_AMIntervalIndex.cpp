@@ -0,0 +1,79 @@
+#include "../../AMIntervalIndex.h"
+#include "benchmark/benchmark.h"
+
+using namespace AMCore;
+
+/*
+ * Overlapping ranges of mixed lengths, most short, some long.
+ */
+static std::vector<AMIntervalIndex<int, int>::Entry> makeEntries(int count)
+{
+    std::vector<AMIntervalIndex<int, int>::Entry> entries;
+    unsigned seed = 1;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1103515245 + 12345;
+        int from = (seed >> 4) % (count * 8);
+        int len = i % 50 == 0 ? 2000 : 1 + i % 30;
+        entries.push_back({AMRange<int>(from, from + len), i});
+    }
+    return entries;
+}
+
+static void BM_setStabLinear(benchmark::State &state)
+{
+    std::vector<AMIntervalIndex<int, int>::Entry> entries = makeEntries(state.range(0));
+    std::set<AMRange<int> > s;
+    for (const auto &e : entries) {
+        s.insert(e.range);
+    }
+    int x = 0;
+    for (auto _ : state) {
+        int hits = 0;
+        for (const AMRange<int> &r : s) {
+            hits += r.in(x);
+        }
+        benchmark::DoNotOptimize(hits);
+        x = (x + 7919) % (state.range(0) * 8);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_setStabLinear)->Arg(1000)->Arg(100000);
+
+static void BM_intervalIndexStab(benchmark::State &state)
+{
+    AMIntervalIndex<int, int> idx(makeEntries(state.range(0)));
+    int x = 0;
+    for (auto _ : state) {
+        int hits = 0;
+        idx.forEachContaining(x, [&hits](const AMIntervalIndex<int, int>::Entry &) { hits++; });
+        benchmark::DoNotOptimize(hits);
+        x = (x + 7919) % (state.range(0) * 8);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_intervalIndexStab)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+static void BM_intervalIndexOverlap(benchmark::State &state)
+{
+    AMIntervalIndex<int, int> idx(makeEntries(state.range(0)));
+    int x = 0;
+    for (auto _ : state) {
+        int hits = 0;
+        idx.forEachOverlapping(AMRange<int>(x, x + 100), [&hits](const AMIntervalIndex<int, int>::Entry &) { hits++; });
+        benchmark::DoNotOptimize(hits);
+        x = (x + 7919) % (state.range(0) * 8);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_intervalIndexOverlap)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+static void BM_intervalIndexBuild(benchmark::State &state)
+{
+    std::vector<AMIntervalIndex<int, int>::Entry> entries = makeEntries(state.range(0));
+    for (auto _ : state) {
+        AMIntervalIndex<int, int> idx(entries);
+        benchmark::DoNotOptimize(idx.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_intervalIndexBuild)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
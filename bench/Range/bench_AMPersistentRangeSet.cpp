@@ -0,0 +1,72 @@
+#include "../../AMPersistentRangeSet.h"
+#include "../../AMRangeSet.h"
+#include "AMRangeBench.h"
+
+using namespace AMCore;
+
+/*
+ * New version with one short range added at wandering position, while previous version is kept,
+ * the way allocation log does. std::set and AMRangeSet copy whole set, persistent set shares untouched nodes.
+ */
+template<typename T>
+static AMRange<T> versionRange(int64_t i, int64_t count)
+{
+    T from = T(i * 7919 % (count * 4));
+    return AMRange<T>(from, from + T(3));
+}
+
+template<typename T>
+static void BM_setVersionPlusRange(benchmark::State &state)
+{
+    std::set<AMRange<T> > s = pack(makeRanges<T>(state.range(0), state.range(1), 0));
+    int64_t i = 0;
+    AllocationCounter counter;
+    for (auto _ : state) {
+        std::set<AMRange<T> > v = s + std::set<AMRange<T> >{versionRange<T>(i++, state.range(0))};
+        benchmark::DoNotOptimize(v);
+    }
+    counter.report(state, 1);
+}
+AMRANGE_BENCHMARK(BM_setVersionPlusRange, sizesAndDensities);
+
+template<typename T>
+static void BM_rangeSetVersionPlusRange(benchmark::State &state)
+{
+    AMRangeSet<T> s(makeRanges<T>(state.range(0), state.range(1), 0));
+    int64_t i = 0;
+    AllocationCounter counter;
+    for (auto _ : state) {
+        AMRangeSet<T> v = s + versionRange<T>(i++, state.range(0));
+        benchmark::DoNotOptimize(v);
+    }
+    counter.report(state, 1);
+}
+AMRANGE_BENCHMARK(BM_rangeSetVersionPlusRange, sizesAndDensities);
+
+template<typename T>
+static void BM_persistentVersionPlusRange(benchmark::State &state)
+{
+    AMPersistentRangeSet<T> s(makeRanges<T>(state.range(0), state.range(1), 0));
+    int64_t i = 0;
+    AllocationCounter counter;
+    for (auto _ : state) {
+        AMPersistentRangeSet<T> v = s + versionRange<T>(i++, state.range(0));
+        benchmark::DoNotOptimize(v);
+    }
+    counter.report(state, 1);
+}
+AMRANGE_BENCHMARK(BM_persistentVersionPlusRange, sizesAndDensities);
+
+template<typename T>
+static void BM_persistentVersionMinusRange(benchmark::State &state)
+{
+    AMPersistentRangeSet<T> s(makeRanges<T>(state.range(0), state.range(1), 0));
+    int64_t i = 0;
+    AllocationCounter counter;
+    for (auto _ : state) {
+        AMPersistentRangeSet<T> v = s - versionRange<T>(i++, state.range(0));
+        benchmark::DoNotOptimize(v);
+    }
+    counter.report(state, 1);
+}
+AMRANGE_BENCHMARK(BM_persistentVersionMinusRange, sizesAndDensities);
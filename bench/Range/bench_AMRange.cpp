@@ -0,0 +1,264 @@
+#include "../../AMRange.h"
+#include "../../AMRangeSet.h"
+#include "benchmark/benchmark.h"
+
+using namespace AMCore;
+
+/*
+ * Interleaved sets of ranges, every range of one set overlaps one range of another set.
+ */
+static std::set<AMRange<int> > makeSet(int count, int offset)
+{
+    std::set<AMRange<int> > s;
+    for (int i = 0; i < count; i++) {
+        s.insert(s.end(), AMRange<int>(i * 8 + offset, i * 8 + offset + 3));
+    }
+    return s;
+}
+
+/*
+ * Union as it was implemented before linear sweep, copy + std::merge + pack.
+ */
+static std::set<AMRange<int> > legacyUnion(const std::set<AMRange<int> > &left, const std::set<AMRange<int> > &right)
+{
+    std::set<AMRange<int> > result = left;
+    std::merge(left.begin(), left.end(),
+        right.begin(), right.end(),
+        std::inserter(result, result.begin()));
+    result = pack(result);
+    return result;
+}
+
+static void BM_setUnionLegacy(benchmark::State &state)
+{
+    std::set<AMRange<int> > left = makeSet(state.range(0), 0);
+    std::set<AMRange<int> > right = makeSet(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacyUnion(left, right));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_setUnionLegacy)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_setUnion(benchmark::State &state)
+{
+    std::set<AMRange<int> > left = makeSet(state.range(0), 0);
+    std::set<AMRange<int> > right = makeSet(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(left + right);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_setUnion)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_rangeSetUnion(benchmark::State &state)
+{
+    AMRangeSet<int> left(makeSet(state.range(0), 0));
+    AMRangeSet<int> right(makeSet(state.range(0), 2));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(left + right);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_rangeSetUnion)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_setIntersectionLegacy(benchmark::State &state)
+{
+    std::set<AMRange<int> > left = makeSet(state.range(0), 0);
+    std::set<AMRange<int> > right = makeSet(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(left - (left - right));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_setIntersectionLegacy)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_setIntersection(benchmark::State &state)
+{
+    std::set<AMRange<int> > left = makeSet(state.range(0), 0);
+    std::set<AMRange<int> > right = makeSet(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(left & right);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_setIntersection)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_rangeSetIntersection(benchmark::State &state)
+{
+    AMRangeSet<int> left(makeSet(state.range(0), 0));
+    AMRangeSet<int> right(makeSet(state.range(0), 2));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(left & right);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_rangeSetIntersection)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_setSymmetricDifferenceLegacy(benchmark::State &state)
+{
+    std::set<AMRange<int> > left = makeSet(state.range(0), 0);
+    std::set<AMRange<int> > right = makeSet(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize((left - right) + (right - left));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_setSymmetricDifferenceLegacy)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_setSymmetricDifference(benchmark::State &state)
+{
+    std::set<AMRange<int> > left = makeSet(state.range(0), 0);
+    std::set<AMRange<int> > right = makeSet(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(left ^ right);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_setSymmetricDifference)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_setComplementLegacy(benchmark::State &state)
+{
+    std::set<AMRange<int> > s = makeSet(state.range(0), 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(AMRange<int>(0, state.range(0) * 8) - s);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_setComplementLegacy)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_setComplement(benchmark::State &state)
+{
+    std::set<AMRange<int> > s = makeSet(state.range(0), 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(complement(s, AMRange<int>(0, state.range(0) * 8)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_setComplement)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_setAddRange(benchmark::State &state)
+{
+    std::set<AMRange<int> > s = makeSet(state.range(0), 0);
+    int i = 0;
+    for (auto _ : state) {
+        s = s + AMRange<int>(i * 8 + 3, i * 8 + 5);
+        i = (i + 7919) % state.range(0);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_setAddRange)->Arg(1000)->Arg(500000)->Unit(benchmark::kMicrosecond);
+
+static void BM_setAddRangeInPlace(benchmark::State &state)
+{
+    std::set<AMRange<int> > s = makeSet(state.range(0), 0);
+    int i = 0;
+    for (auto _ : state) {
+        s += AMRange<int>(i * 8 + 3, i * 8 + 5);
+        i = (i + 7919) % state.range(0);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_setAddRangeInPlace)->Arg(1000)->Arg(500000)->Unit(benchmark::kMicrosecond);
+
+static void BM_rangeSetAddRangeInPlace(benchmark::State &state)
+{
+    AMRangeSet<int> s(makeSet(state.range(0), 0));
+    int i = 0;
+    for (auto _ : state) {
+        s += AMRange<int>(i * 8 + 3, i * 8 + 5);
+        i = (i + 7919) % state.range(0);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_rangeSetAddRangeInPlace)->Arg(1000)->Arg(500000)->Unit(benchmark::kMicrosecond);
+
+static void BM_setFindLinear(benchmark::State &state)
+{
+    std::set<AMRange<int> > s = makeSet(state.range(0), 0);
+    int i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::find_if(s.begin(), s.end(), [i](const AMRange<int> &r) { return r.in(i); }));
+        i = (i + 7919) % (state.range(0) * 8);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_setFindLinear)->Arg(1000)->Arg(100000);
+
+static void BM_setFind(benchmark::State &state)
+{
+    std::set<AMRange<int> > s = makeSet(state.range(0), 0);
+    int i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(find(s, i));
+        i = (i + 7919) % (state.range(0) * 8);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_setFind)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+static void BM_rangeSetFind(benchmark::State &state)
+{
+    AMRangeSet<int> s(makeSet(state.range(0), 0));
+    int i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s.find(i));
+        i = (i + 7919) % (state.range(0) * 8);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_rangeSetFind)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+static std::vector<int> makeNums(int count, int limit)
+{
+    std::vector<int> nums(count);
+    for (int i = 0; i < count; i++) {
+        nums[i] = static_cast<int>((i * 2654435761u) % limit);
+    }
+    return nums;
+}
+
+static void BM_rangeSetFindLoop(benchmark::State &state)
+{
+    AMRangeSet<int> s(makeSet(state.range(0), 0));
+    std::vector<int> nums = makeNums(1 << 16, state.range(0) * 8);
+    std::vector<std::size_t> indices(nums.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < nums.size(); i++) {
+            AMRangeSet<int>::const_iterator it = s.find(nums[i]);
+            indices[i] = it == s.end() ? AMRangeSet<int>::npos : it - s.begin();
+        }
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * nums.size());
+}
+BENCHMARK(BM_rangeSetFindLoop)->Arg(1000)->Arg(1000000);
+
+static void BM_rangeSetFindBatch(benchmark::State &state)
+{
+    AMRangeSet<int> s(makeSet(state.range(0), 0));
+    std::vector<int> nums = makeNums(1 << 16, state.range(0) * 8);
+    std::vector<std::size_t> indices(nums.size());
+    for (auto _ : state) {
+        s.findBatch(nums.data(), nums.size(), indices.data());
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * nums.size());
+}
+BENCHMARK(BM_rangeSetFindBatch)->Arg(1000)->Arg(1000000);
+
+static void BM_rangeSetFindBatchSorted(benchmark::State &state)
+{
+    AMRangeSet<int> s(makeSet(state.range(0), 0));
+    std::vector<int> nums = makeNums(1 << 16, state.range(0) * 8);
+    std::sort(nums.begin(), nums.end());
+    std::vector<std::size_t> indices(nums.size());
+    for (auto _ : state) {
+        s.findBatch(nums.data(), nums.size(), indices.data(), true);
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * nums.size());
+}
+BENCHMARK(BM_rangeSetFindBatchSorted)->Arg(1000)->Arg(1000000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+#include "../../AMRangeFile.h"
+#include "benchmark/benchmark.h"
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace AMCore;
+
+/*
+ * File with n packed ranges, created once per size and left in temporary directory.
+ */
+static std::string makeFile(int64_t count)
+{
+    std::string path = (std::filesystem::temp_directory_path() /
+                        ("bench_AMRangeFile_" + std::to_string(count) + ".amrs")).string();
+    if (std::filesystem::exists(path)) {
+        return path;
+    }
+    std::mt19937 random(count);
+    std::vector<AMRange<int64_t> > v(count);
+    int64_t from = 0;
+    for (AMRange<int64_t> &r : v) {
+        int64_t to = from + 1 + random() % 1000;
+        r = AMRange<int64_t>(from, to);
+        from = to + 1 + random() % 1000;
+    }
+    std::ofstream out(path, std::ios::binary);
+    AMRangeFile<int64_t>::write(out, AMRangeSet<int64_t>::fromPacked(std::move(v)));
+    return path;
+}
+
+static void counts(benchmark::internal::Benchmark *b)
+{
+    b->ArgsProduct({{1000, 100000, 10000000}})->ArgNames({"n"})->Unit(benchmark::kMillisecond);
+}
+
+/*
+ * Former way, ranges are read one by one and inserted into tree.
+ */
+static void BM_loadStdSet(benchmark::State &state)
+{
+    std::string path = makeFile(state.range(0));
+    for (auto _ : state) {
+        std::ifstream in(path, std::ios::binary);
+        in.seekg(AMRangeFile<int64_t>::headerSize);
+        std::set<AMRange<int64_t> > s;
+        AMRange<int64_t> r;
+        while (in.read(reinterpret_cast<char *>(&r), sizeof(r))) {
+            s.insert(s.end(), r);
+        }
+        benchmark::DoNotOptimize(s.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_loadStdSet)->Apply(counts);
+
+static void BM_loadRead(benchmark::State &state)
+{
+    std::string path = makeFile(state.range(0));
+    for (auto _ : state) {
+        std::ifstream in(path, std::ios::binary);
+        AMRangeSet<int64_t> s;
+        AMRangeFile<int64_t>::read(in, s);
+        benchmark::DoNotOptimize(s.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_loadRead)->Apply(counts);
+
+/*
+ * Open and first lookup, pages are faulted in by lookup only.
+ */
+static void BM_loadMapped(benchmark::State &state)
+{
+    std::string path = makeFile(state.range(0));
+    for (auto _ : state) {
+        AMMappedRangeSet<int64_t> m;
+        m.open(path.c_str());
+        benchmark::DoNotOptimize(m.find(12345) != m.end());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_loadMapped)->Apply(counts);
+
+static void BM_mappedFind(benchmark::State &state)
+{
+    std::string path = makeFile(state.range(0));
+    AMMappedRangeSet<int64_t> m;
+    m.open(path.c_str());
+    std::mt19937 random(7);
+    std::vector<int64_t> nums(4096);
+    for (int64_t &num : nums) {
+        num = int64_t(random() % uint64_t(m[m.size() - 1].to));
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m.find(nums[i++ & 4095]) != m.end());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_mappedFind)->ArgsProduct({{1000, 100000, 10000000}})->ArgNames({"n"});
@@ -0,0 +1,80 @@
+#include "../../AMRangeMap.h"
+#include "benchmark/benchmark.h"
+#include <map>
+
+using namespace AMCore;
+
+/*
+ * Range map as std::set of ranges with parallel std::map of values.
+ */
+struct SetAndMap
+{
+    std::set<AMRange<int> > ranges;
+    std::map<int, int> values;
+
+    void assign(const AMRange<int> &rng, int value)
+    {
+        auto ov = overlapping(ranges, rng);
+        std::vector<AMRange<int> > hits(ov.first, ov.second);
+        for (const AMRange<int> &r : hits) {
+            int v = values[r.from];
+            ranges.erase(r);
+            values.erase(r.from);
+            if (r.from < rng.from) {
+                ranges.insert(AMRange<int>(r.from, rng.from));
+                values[r.from] = v;
+            }
+            if (r.to > rng.to) {
+                ranges.insert(AMRange<int>(rng.to, r.to));
+                values[rng.to] = v;
+            }
+        }
+        ranges.insert(rng);
+        values[rng.from] = value;
+    }
+};
+
+static void BM_setAndMapAssign(benchmark::State &state)
+{
+    SetAndMap m;
+    int i = 0;
+    for (int j = 0; j < state.range(0); j++) {
+        m.assign(AMRange<int>(j * 8, j * 8 + 6), j % 3);
+    }
+    for (auto _ : state) {
+        m.assign(AMRange<int>(i * 8 + 3, i * 8 + 10), i % 3);
+        i = (i + 7919) % state.range(0);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_setAndMapAssign)->Arg(1000)->Arg(100000);
+
+static void BM_rangeMapAssign(benchmark::State &state)
+{
+    AMRangeMap<int, int> m;
+    int i = 0;
+    for (int j = 0; j < state.range(0); j++) {
+        m.assign(AMRange<int>(j * 8, j * 8 + 6), j % 3);
+    }
+    for (auto _ : state) {
+        m.assign(AMRange<int>(i * 8 + 3, i * 8 + 10), i % 3);
+        i = (i + 7919) % state.range(0);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_rangeMapAssign)->Arg(1000)->Arg(100000);
+
+static void BM_rangeMapFind(benchmark::State &state)
+{
+    AMRangeMap<int, int> m;
+    for (int j = 0; j < state.range(0); j++) {
+        m.assign(AMRange<int>(j * 8, j * 8 + 6), j % 3);
+    }
+    int i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m.at(i));
+        i = (i + 7919) % (state.range(0) * 8);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_rangeMapFind)->Arg(1000)->Arg(100000);
@@ -0,0 +1,503 @@
+#include "../../AMRange.h"
+#include "../../AMRangeSet.h"
+#include "AMRangeBench.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+using namespace AMCore;
+
+/*
+ * Range over middle half of generated ranges.
+ */
+template<typename T>
+static AMRange<T> middleRange(int64_t count)
+{
+    return AMRange<T>(T(count), T(count * 3));
+}
+
+/*
+ * Sizes of ingest batches for every density.
+ */
+static void batchesAndDensities(benchmark::internal::Benchmark *b)
+{
+    b->ArgsProduct({{1000, 100000, 1000000}, {Disjoint, Adjacent, Overlapping}})->ArgNames({"n", "density"});
+}
+
+/*
+ * Sizes of single range benchmarks, number of range pairs.
+ */
+static void pairCounts(benchmark::internal::Benchmark *b)
+{
+    b->Arg(1024)->ArgNames({"n"});
+}
+
+/*
+ * Single range operations over array of range pairs with all kinds of mutual position.
+ */
+template<typename T, typename Op>
+static void runRangeOp(benchmark::State &state, Op op)
+{
+    std::vector<AMRange<T> > left, right;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        int a = int(i * 7919 % 64), b = int(i * 104729 % 64);
+        left.push_back(AMRange<T>(T(a), T(a + 8 + i % 8)));
+        right.push_back(AMRange<T>(T(b), T(b + 8 + i % 5)));
+    }
+    AllocationCounter counter;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < left.size(); i++) {
+            benchmark::DoNotOptimize(op(left[i], right[i]));
+        }
+    }
+    counter.report(state, state.range(0));
+}
+
+template<typename T>
+static void BM_rangePlus(benchmark::State &state)
+{
+    runRangeOp<T>(state, [](const AMRange<T> &l, const AMRange<T> &r) { return l + r; });
+}
+AMRANGE_BENCHMARK(BM_rangePlus, pairCounts);
+
+template<typename T>
+static void BM_rangeMinus(benchmark::State &state)
+{
+    runRangeOp<T>(state, [](const AMRange<T> &l, const AMRange<T> &r) { return l - r; });
+}
+AMRANGE_BENCHMARK(BM_rangeMinus, pairCounts);
+
+template<typename T>
+static void BM_rangeIntersect(benchmark::State &state)
+{
+    runRangeOp<T>(state, [](const AMRange<T> &l, const AMRange<T> &r) { return intersect(l, r); });
+}
+AMRANGE_BENCHMARK(BM_rangeIntersect, pairCounts);
+
+template<typename T>
+static void BM_rangeIn(benchmark::State &state)
+{
+    runRangeOp<T>(state, [](const AMRange<T> &l, const AMRange<T> &r) { return l.in(r); });
+}
+AMRANGE_BENCHMARK(BM_rangeIn, pairCounts);
+
+template<typename T>
+static void BM_pack(benchmark::State &state)
+{
+    std::set<AMRange<T> > s = makeRanges<T>(state.range(0), state.range(1), 0);
+    AllocationCounter counter;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pack(s));
+    }
+    counter.report(state, state.range(0));
+}
+AMRANGE_BENCHMARK(BM_pack, sizesAndDensities);
+
+/*
+ * Binary operation of two interleaved sets, or of set and range over its middle half.
+ */
+template<typename T, typename Op>
+static void runSetOp(benchmark::State &state, Op op)
+{
+    std::set<AMRange<T> > left = makeRanges<T>(state.range(0), state.range(1), 0);
+    std::set<AMRange<T> > right = makeRanges<T>(state.range(0), state.range(1), 1);
+    AMRange<T> rng = middleRange<T>(state.range(0));
+    AllocationCounter counter;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(op(left, right, rng));
+    }
+    counter.report(state, state.range(0) * 2);
+}
+
+template<typename T>
+static void BM_setPlusSet(benchmark::State &state)
+{
+    runSetOp<T>(state, [](const std::set<AMRange<T> > &l, const std::set<AMRange<T> > &r, const AMRange<T> &) {
+        return l + r;
+    });
+}
+AMRANGE_BENCHMARK(BM_setPlusSet, sizesAndDensities);
+
+template<typename T>
+static void BM_rangePlusSet(benchmark::State &state)
+{
+    runSetOp<T>(state, [](const std::set<AMRange<T> > &, const std::set<AMRange<T> > &r, const AMRange<T> &rng) {
+        return rng + r;
+    });
+}
+AMRANGE_BENCHMARK(BM_rangePlusSet, sizesAndDensities);
+
+template<typename T>
+static void BM_setPlusRange(benchmark::State &state)
+{
+    runSetOp<T>(state, [](const std::set<AMRange<T> > &l, const std::set<AMRange<T> > &, const AMRange<T> &rng) {
+        return l + rng;
+    });
+}
+AMRANGE_BENCHMARK(BM_setPlusRange, sizesAndDensities);
+
+template<typename T>
+static void BM_setMinusSet(benchmark::State &state)
+{
+    runSetOp<T>(state, [](const std::set<AMRange<T> > &l, const std::set<AMRange<T> > &r, const AMRange<T> &) {
+        return l - r;
+    });
+}
+AMRANGE_BENCHMARK(BM_setMinusSet, sizesAndDensities);
+BENCHMARK_TEMPLATE(BM_setMinusSet, uint64_t)->Apply(sizesAndDensities);
+
+template<typename T>
+static void BM_rangeMinusSet(benchmark::State &state)
+{
+    runSetOp<T>(state, [](const std::set<AMRange<T> > &, const std::set<AMRange<T> > &r, const AMRange<T> &rng) {
+        return rng - r;
+    });
+}
+AMRANGE_BENCHMARK(BM_rangeMinusSet, sizesAndDensities);
+BENCHMARK_TEMPLATE(BM_rangeMinusSet, uint64_t)->Apply(sizesAndDensities);
+
+template<typename T>
+static void BM_setMinusRange(benchmark::State &state)
+{
+    runSetOp<T>(state, [](const std::set<AMRange<T> > &l, const std::set<AMRange<T> > &, const AMRange<T> &rng) {
+        return l - rng;
+    });
+}
+AMRANGE_BENCHMARK(BM_setMinusRange, sizesAndDensities);
+BENCHMARK_TEMPLATE(BM_setMinusRange, uint64_t)->Apply(sizesAndDensities);
+
+template<typename T>
+static void BM_setAndSet(benchmark::State &state)
+{
+    runSetOp<T>(state, [](const std::set<AMRange<T> > &l, const std::set<AMRange<T> > &r, const AMRange<T> &) {
+        return l & r;
+    });
+}
+AMRANGE_BENCHMARK(BM_setAndSet, sizesAndDensities);
+
+template<typename T>
+static void BM_setXorSet(benchmark::State &state)
+{
+    runSetOp<T>(state, [](const std::set<AMRange<T> > &l, const std::set<AMRange<T> > &r, const AMRange<T> &) {
+        return l ^ r;
+    });
+}
+AMRANGE_BENCHMARK(BM_setXorSet, sizesAndDensities);
+
+/*
+ * In-place ops on packed set, every iteration cuts covered range out and puts it back.
+ */
+template<typename T>
+static void BM_setMinusPlusRangeInPlace(benchmark::State &state)
+{
+    std::set<AMRange<T> > s = pack(makeRanges<T>(state.range(0), state.range(1), 0));
+    int64_t i = 0;
+    AllocationCounter counter;
+    for (auto _ : state) {
+        AMRange<T> rng(T(i * 4), T(i * 4 + 1));
+        s -= rng;
+        s += rng;
+        i = (i + 7919) % state.range(0);
+    }
+    benchmark::DoNotOptimize(s);
+    counter.report(state, 2);
+}
+AMRANGE_BENCHMARK(BM_setMinusPlusRangeInPlace, sizesAndDensities);
+
+template<typename T>
+static void BM_setFindNum(benchmark::State &state)
+{
+    std::set<AMRange<T> > s = pack(makeRanges<T>(state.range(0), state.range(1), 0));
+    int64_t i = 0;
+    AllocationCounter counter;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(find(s, T(i)));
+        i = (i + 7919) % (state.range(0) * 4);
+    }
+    counter.report(state, 1);
+}
+AMRANGE_BENCHMARK(BM_setFindNum, sizesAndDensities);
+
+/*
+ * Same binary operations on AMRangeSet.
+ */
+template<typename T, typename Op>
+static void runRangeSetOp(benchmark::State &state, Op op)
+{
+    AMRangeSet<T> left(makeRanges<T>(state.range(0), state.range(1), 0));
+    AMRangeSet<T> right(makeRanges<T>(state.range(0), state.range(1), 1));
+    AMRange<T> rng = middleRange<T>(state.range(0));
+    AllocationCounter counter;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(op(left, right, rng));
+    }
+    counter.report(state, state.range(0) * 2);
+}
+
+template<typename T>
+static void BM_rangeSetPlusSet(benchmark::State &state)
+{
+    runRangeSetOp<T>(state, [](const AMRangeSet<T> &l, const AMRangeSet<T> &r, const AMRange<T> &) {
+        return l + r;
+    });
+}
+AMRANGE_BENCHMARK(BM_rangeSetPlusSet, sizesAndDensities);
+
+template<typename T>
+static void BM_rangeSetPlusRange(benchmark::State &state)
+{
+    runRangeSetOp<T>(state, [](const AMRangeSet<T> &l, const AMRangeSet<T> &, const AMRange<T> &rng) {
+        return l + rng;
+    });
+}
+AMRANGE_BENCHMARK(BM_rangeSetPlusRange, sizesAndDensities);
+
+template<typename T>
+static void BM_rangeSetMinusSet(benchmark::State &state)
+{
+    runRangeSetOp<T>(state, [](const AMRangeSet<T> &l, const AMRangeSet<T> &r, const AMRange<T> &) {
+        return l - r;
+    });
+}
+AMRANGE_BENCHMARK(BM_rangeSetMinusSet, sizesAndDensities);
+
+template<typename T>
+static void BM_rangeSetMinusRange(benchmark::State &state)
+{
+    runRangeSetOp<T>(state, [](const AMRangeSet<T> &l, const AMRangeSet<T> &, const AMRange<T> &rng) {
+        return l - rng;
+    });
+}
+AMRANGE_BENCHMARK(BM_rangeSetMinusRange, sizesAndDensities);
+
+template<typename T>
+static void BM_rangeSetAndSet(benchmark::State &state)
+{
+    runRangeSetOp<T>(state, [](const AMRangeSet<T> &l, const AMRangeSet<T> &r, const AMRange<T> &) {
+        return l & r;
+    });
+}
+AMRANGE_BENCHMARK(BM_rangeSetAndSet, sizesAndDensities);
+
+/*
+ * Total length, summed over std::set, kept by AMRangeSet, and total length of intersection.
+ */
+template<typename T>
+static void BM_setMeasure(benchmark::State &state)
+{
+    runSetOp<T>(state, [](const std::set<AMRange<T> > &l, const std::set<AMRange<T> > &, const AMRange<T> &) {
+        return measure(l);
+    });
+}
+AMRANGE_BENCHMARK(BM_setMeasure, sizesAndDensities);
+
+template<typename T>
+static void BM_rangeSetMeasure(benchmark::State &state)
+{
+    runRangeSetOp<T>(state, [](const AMRangeSet<T> &l, const AMRangeSet<T> &, const AMRange<T> &) {
+        return l.measure();
+    });
+}
+AMRANGE_BENCHMARK(BM_rangeSetMeasure, sizesAndDensities);
+
+template<typename T>
+static void BM_rangeSetAndSetMeasure(benchmark::State &state)
+{
+    runRangeSetOp<T>(state, [](const AMRangeSet<T> &l, const AMRangeSet<T> &r, const AMRange<T> &) {
+        return (l & r).measure();
+    });
+}
+AMRANGE_BENCHMARK(BM_rangeSetAndSetMeasure, sizesAndDensities);
+
+template<typename T>
+static void BM_rangeSetOverlapMeasure(benchmark::State &state)
+{
+    runRangeSetOp<T>(state, [](const AMRangeSet<T> &l, const AMRangeSet<T> &r, const AMRange<T> &) {
+        return overlapMeasure(l, r);
+    });
+}
+AMRANGE_BENCHMARK(BM_rangeSetOverlapMeasure, sizesAndDensities);
+
+/*
+ * Binary operations with results allocated in monotonic arena, which is released after every iteration
+ * the way per request arena is. Arena buffer is allocated once, so only overflows reach the heap.
+ */
+static void arenaSizesAndDensities(benchmark::internal::Benchmark *b)
+{
+    b->ArgsProduct({{10, 1000, 100000}, {Disjoint, Adjacent, Overlapping}})->ArgNames({"n", "density"});
+}
+
+template<typename T>
+static void fill(std::pmr::set<AMRange<T> > &dst, const std::set<AMRange<T> > &src)
+{
+    dst.insert(src.begin(), src.end());
+}
+
+template<typename T>
+static void fill(pmr::AMRangeSet<T> &dst, const std::set<AMRange<T> > &src)
+{
+    for (const AMRange<T> &rng : src) {
+        dst += rng;
+    }
+}
+
+template<typename T, typename Set, typename Op>
+static void runArenaOp(benchmark::State &state, Op op)
+{
+    std::pmr::monotonic_buffer_resource operands;
+    Set left(&operands), right(&operands);
+    fill(left, makeRanges<T>(state.range(0), state.range(1), 0));
+    fill(right, makeRanges<T>(state.range(0), state.range(1), 1));
+    std::vector<char> buffer(std::size_t(state.range(0)) * 256);
+    AllocationCounter counter;
+    for (auto _ : state) {
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+        benchmark::DoNotOptimize(op(left, right, &arena));
+    }
+    counter.report(state, state.range(0) * 2);
+}
+
+template<typename T>
+static void BM_arenaSetPlusSet(benchmark::State &state)
+{
+    typedef std::pmr::set<AMRange<T> > Set;
+    runArenaOp<T, Set>(state, [](const Set &l, const Set &r, std::pmr::memory_resource *arena) {
+        Set left(l, arena);
+        return left + r;
+    });
+}
+AMRANGE_BENCHMARK(BM_arenaSetPlusSet, arenaSizesAndDensities);
+
+template<typename T>
+static void BM_arenaSetMinusSet(benchmark::State &state)
+{
+    typedef std::pmr::set<AMRange<T> > Set;
+    runArenaOp<T, Set>(state, [](const Set &l, const Set &r, std::pmr::memory_resource *arena) {
+        Set left(l, arena);
+        return left - r;
+    });
+}
+AMRANGE_BENCHMARK(BM_arenaSetMinusSet, arenaSizesAndDensities);
+
+template<typename T>
+static void BM_arenaRangeSetPlusSet(benchmark::State &state)
+{
+    typedef pmr::AMRangeSet<T> Set;
+    runArenaOp<T, Set>(state, [](const Set &l, const Set &r, std::pmr::memory_resource *arena) {
+        Set left(arena);
+        left += l;
+        return left + r;
+    });
+}
+AMRANGE_BENCHMARK(BM_arenaRangeSetPlusSet, arenaSizesAndDensities);
+
+/*
+ * Ingest of batch of ranges in random order.
+ */
+template<typename T>
+static std::vector<AMRange<T> > makeUnsorted(int64_t count, int64_t density)
+{
+    std::set<AMRange<T> > s = makeRanges<T>(count, density, 0);
+    std::vector<AMRange<T> > v(s.begin(), s.end());
+    std::shuffle(v.begin(), v.end(), std::mt19937(count));
+    return v;
+}
+
+template<typename T>
+static void BM_ingestSetInsertPack(benchmark::State &state)
+{
+    std::vector<AMRange<T> > v = makeUnsorted<T>(state.range(0), state.range(1));
+    AllocationCounter counter;
+    for (auto _ : state) {
+        std::set<AMRange<T> > s(v.begin(), v.end());
+        benchmark::DoNotOptimize(pack(s));
+    }
+    counter.report(state, state.range(0));
+}
+AMRANGE_BENCHMARK(BM_ingestSetInsertPack, batchesAndDensities);
+
+template<typename T>
+static void BM_ingestPackUnsorted(benchmark::State &state)
+{
+    std::vector<AMRange<T> > v = makeUnsorted<T>(state.range(0), state.range(1));
+    AllocationCounter counter;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(packUnsorted(v.begin(), v.end()));
+    }
+    counter.report(state, state.range(0));
+}
+AMRANGE_BENCHMARK(BM_ingestPackUnsorted, batchesAndDensities);
+
+template<typename T>
+static void BM_ingestRangeSetFromUnsorted(benchmark::State &state)
+{
+    std::vector<AMRange<T> > v = makeUnsorted<T>(state.range(0), state.range(1));
+    AllocationCounter counter;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(AMRangeSet<T>::fromUnsorted(v.begin(), v.end()));
+    }
+    counter.report(state, state.range(0));
+}
+AMRANGE_BENCHMARK(BM_ingestRangeSetFromUnsorted, batchesAndDensities);
+
+/*
+ * Sorting of ranges in random order, comparison sort against radix sort, by both bounds and by left bound only.
+ */
+static void sortSizes(benchmark::internal::Benchmark *b)
+{
+    b->RangeMultiplier(4)->Range(16, 1 << 20)->ArgNames({"n"});
+}
+
+template<typename T>
+static std::vector<AMRange<T> > makeRandom(int64_t count)
+{
+    std::mt19937_64 random(count);
+    std::vector<AMRange<T> > v(count);
+    for (AMRange<T> &r : v) {
+        T from = T(random() % (count * 4));
+        r = AMRange<T>(from, from + T(random() % 16));
+    }
+    return v;
+}
+
+template<typename T, typename Sort>
+static void runSort(benchmark::State &state, Sort sort)
+{
+    std::vector<AMRange<T> > v = makeRandom<T>(state.range(0));
+    std::vector<AMRange<T> > w(v.size());
+    AllocationCounter counter;
+    for (auto _ : state) {
+        state.PauseTiming();
+        w = v;
+        state.ResumeTiming();
+        sort(w);
+        benchmark::DoNotOptimize(w.data());
+    }
+    counter.report(state, state.range(0));
+}
+
+template<typename T>
+static void BM_sortStd(benchmark::State &state)
+{
+    runSort<T>(state, [](std::vector<AMRange<T> > &w) { std::sort(w.begin(), w.end()); });
+}
+BENCHMARK_TEMPLATE(BM_sortStd, uint32_t)->Apply(sortSizes);
+BENCHMARK_TEMPLATE(BM_sortStd, int64_t)->Apply(sortSizes);
+
+template<typename T>
+static void BM_sortRadix(benchmark::State &state)
+{
+    runSort<T>(state, [](std::vector<AMRange<T> > &w) { radixSortRanges(w.begin(), w.end()); });
+}
+BENCHMARK_TEMPLATE(BM_sortRadix, uint32_t)->Apply(sortSizes);
+BENCHMARK_TEMPLATE(BM_sortRadix, int64_t)->Apply(sortSizes);
+
+template<typename T>
+static void BM_sortRadixFromOnly(benchmark::State &state)
+{
+    runSort<T>(state, [](std::vector<AMRange<T> > &w) { radixSortRanges(w.begin(), w.end(), true); });
+}
+BENCHMARK_TEMPLATE(BM_sortRadixFromOnly, uint32_t)->Apply(sortSizes);
+BENCHMARK_TEMPLATE(BM_sortRadixFromOnly, int64_t)->Apply(sortSizes);
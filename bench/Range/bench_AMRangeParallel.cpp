@@ -0,0 +1,100 @@
+#include "../../AMRangeParallel.h"
+#include "benchmark/benchmark.h"
+#include <algorithm>
+#include <random>
+#include <thread>
+
+using namespace AMCore;
+
+/*
+ * Interleaved sets of n ranges, every range of one set overlaps one range of another set.
+ */
+static AMRangeSet<int64_t> makeSet(int64_t count, int64_t offset)
+{
+    std::vector<AMRange<int64_t> > v(count);
+    for (int64_t i = 0; i < count; i++) {
+        v[i] = AMRange<int64_t>(i * 8 + offset, i * 8 + offset + 3);
+    }
+    return AMRangeSet<int64_t>::fromPacked(std::move(v));
+}
+
+/*
+ * Threads 1, 2, 4 .. std::thread::hardware_concurrency() over 10^7 ranges per operand, wall time.
+ * Speedup is time of threads:1 divided by time of the same benchmark with more threads.
+ */
+static void threadCounts(benchmark::internal::Benchmark *b)
+{
+    int64_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int64_t> threads;
+    for (int64_t t = 1; t < hardware; t *= 2) {
+        threads.push_back(t);
+    }
+    threads.push_back(hardware);
+    b->ArgsProduct({{10000000}, threads})->ArgNames({"n", "threads"})
+     ->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+static void BM_parallelUnite(benchmark::State &state)
+{
+    AMRangeSet<int64_t> left = makeSet(state.range(0), 0);
+    AMRangeSet<int64_t> right = makeSet(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(AMRangeParallel<int64_t>::unite(left, right, state.range(1)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_parallelUnite)->Apply(threadCounts);
+
+static void BM_parallelSubtract(benchmark::State &state)
+{
+    AMRangeSet<int64_t> left = makeSet(state.range(0), 0);
+    AMRangeSet<int64_t> right = makeSet(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(AMRangeParallel<int64_t>::subtract(left, right, state.range(1)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_parallelSubtract)->Apply(threadCounts);
+
+static void BM_parallelIntersect(benchmark::State &state)
+{
+    AMRangeSet<int64_t> left = makeSet(state.range(0), 0);
+    AMRangeSet<int64_t> right = makeSet(state.range(0), 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(AMRangeParallel<int64_t>::intersect(left, right, state.range(1)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_parallelIntersect)->Apply(threadCounts);
+
+static void BM_parallelPack(benchmark::State &state)
+{
+    std::vector<AMRange<int64_t> > v(state.range(0));
+    for (int64_t i = 0; i < state.range(0); i++) {
+        v[i] = AMRange<int64_t>(i * 4, i * 4 + 2 + (i % 5) * 2);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(AMRangeParallel<int64_t>::pack(v, state.range(1)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_parallelPack)->Apply(threadCounts);
+
+static void BM_parallelFromUnsorted(benchmark::State &state)
+{
+    std::mt19937_64 random(1);
+    std::vector<AMRange<int64_t> > v(state.range(0));
+    for (AMRange<int64_t> &r : v) {
+        int64_t from = random() % (state.range(0) * 8);
+        r = AMRange<int64_t>(from, from + 3);
+    }
+    std::vector<AMRange<int64_t> > w;
+    for (auto _ : state) {
+        state.PauseTiming();
+        w = v;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(AMRangeParallel<int64_t>::fromUnsorted(w, state.range(1)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_parallelFromUnsorted)->Apply(threadCounts);
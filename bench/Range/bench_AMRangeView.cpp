@@ -0,0 +1,72 @@
+#include "../../AMRangeView.h"
+#include "benchmark/benchmark.h"
+
+using namespace AMCore;
+
+/*
+ * Sets of n ranges, shifted by offset, each two overlap.
+ */
+static std::vector<AMRange<int64_t> > makeRanges(int64_t count, int64_t offset)
+{
+    std::vector<AMRange<int64_t> > v(count);
+    for (int64_t i = 0; i < count; i++) {
+        v[i] = AMRange<int64_t>(i * 16 + offset, i * 16 + offset + 5);
+    }
+    return v;
+}
+
+static void BM_chainSet(benchmark::State &state)
+{
+    std::vector<AMRange<int64_t> > va = makeRanges(state.range(0), 0), vb = makeRanges(state.range(0), 4);
+    std::vector<AMRange<int64_t> > vc = makeRanges(state.range(0), 2), vd = makeRanges(state.range(0), 11);
+    std::set<AMRange<int64_t> > a(va.begin(), va.end()), b(vb.begin(), vb.end());
+    std::set<AMRange<int64_t> > c(vc.begin(), vc.end()), d(vd.begin(), vd.end());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize((a + b) - (c + d));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 4);
+}
+BENCHMARK(BM_chainSet)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+static void BM_chainRangeSet(benchmark::State &state)
+{
+    AMRangeSet<int64_t> a = AMRangeSet<int64_t>::fromPacked(makeRanges(state.range(0), 0));
+    AMRangeSet<int64_t> b = AMRangeSet<int64_t>::fromPacked(makeRanges(state.range(0), 4));
+    AMRangeSet<int64_t> c = AMRangeSet<int64_t>::fromPacked(makeRanges(state.range(0), 2));
+    AMRangeSet<int64_t> d = AMRangeSet<int64_t>::fromPacked(makeRanges(state.range(0), 11));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize((a + b) - (c + d));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 4);
+}
+BENCHMARK(BM_chainRangeSet)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+static void BM_chainViewMaterialize(benchmark::State &state)
+{
+    AMRangeSet<int64_t> a = AMRangeSet<int64_t>::fromPacked(makeRanges(state.range(0), 0));
+    AMRangeSet<int64_t> b = AMRangeSet<int64_t>::fromPacked(makeRanges(state.range(0), 4));
+    AMRangeSet<int64_t> c = AMRangeSet<int64_t>::fromPacked(makeRanges(state.range(0), 2));
+    AMRangeSet<int64_t> d = AMRangeSet<int64_t>::fromPacked(makeRanges(state.range(0), 11));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(((rangeView(a) + rangeView(b)) - (rangeView(c) + rangeView(d))).toRangeSet());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 4);
+}
+BENCHMARK(BM_chainViewMaterialize)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+static void BM_chainViewScan(benchmark::State &state)
+{
+    AMRangeSet<int64_t> a = AMRangeSet<int64_t>::fromPacked(makeRanges(state.range(0), 0));
+    AMRangeSet<int64_t> b = AMRangeSet<int64_t>::fromPacked(makeRanges(state.range(0), 4));
+    AMRangeSet<int64_t> c = AMRangeSet<int64_t>::fromPacked(makeRanges(state.range(0), 2));
+    AMRangeSet<int64_t> d = AMRangeSet<int64_t>::fromPacked(makeRanges(state.range(0), 11));
+    for (auto _ : state) {
+        int64_t length = 0;
+        for (const AMRange<int64_t> &r : (rangeView(a) + rangeView(b)) - (rangeView(c) + rangeView(d))) {
+            length += r.to - r.from;
+        }
+        benchmark::DoNotOptimize(length);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 4);
+}
+BENCHMARK(BM_chainViewScan)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
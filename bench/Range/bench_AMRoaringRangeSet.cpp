@@ -0,0 +1,100 @@
+#include "../../AMRoaringRangeSet.h"
+#include "benchmark/benchmark.h"
+#include <random>
+
+using namespace AMCore;
+
+/*
+ * Free block map like set, n tiny ranges with lengths and gaps below maxDelta.
+ */
+static AMRangeSet<uint32_t> makeFragmented(int64_t count, uint32_t maxDelta, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<AMRange<uint32_t> > v(count);
+    uint32_t from = 0;
+    for (AMRange<uint32_t> &r : v) {
+        uint32_t to = from + 1 + random() % maxDelta;
+        r = AMRange<uint32_t>(from, to);
+        from = to + 1 + random() % maxDelta;
+    }
+    return AMRangeSet<uint32_t>::fromPacked(std::move(v));
+}
+
+static void countsAndDeltas(benchmark::internal::Benchmark *b)
+{
+    b->ArgsProduct({{10000, 1000000}, {4, 64, 4096}})->ArgNames({"n", "delta"});
+}
+
+template<typename Set, typename Op>
+static void runOp(benchmark::State &state, Op op)
+{
+    Set a(makeFragmented(state.range(0), uint32_t(state.range(1)), 1));
+    Set b(makeFragmented(state.range(0), uint32_t(state.range(1)), 2));
+    for (auto _ : state) {
+        Set c = op(a, b);
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+static void BM_roaringUnite(benchmark::State &state)
+{
+    runOp<AMRoaringRangeSet>(state, [](const AMRoaringRangeSet &a, const AMRoaringRangeSet &b) { return a + b; });
+}
+BENCHMARK(BM_roaringUnite)->Apply(countsAndDeltas);
+
+static void BM_flatUnite(benchmark::State &state)
+{
+    runOp<AMRangeSet<uint32_t> >(state, [](const AMRangeSet<uint32_t> &a, const AMRangeSet<uint32_t> &b) { return a + b; });
+}
+BENCHMARK(BM_flatUnite)->Apply(countsAndDeltas);
+
+static void BM_stdSetUnite(benchmark::State &state)
+{
+    AMRangeStdSet<uint32_t> a = makeFragmented(state.range(0), uint32_t(state.range(1)), 1).toSet();
+    AMRangeStdSet<uint32_t> b = makeFragmented(state.range(0), uint32_t(state.range(1)), 2).toSet();
+    for (auto _ : state) {
+        AMRangeStdSet<uint32_t> c = a + b;
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_stdSetUnite)->Apply(countsAndDeltas);
+
+static void BM_roaringSubtract(benchmark::State &state)
+{
+    runOp<AMRoaringRangeSet>(state, [](const AMRoaringRangeSet &a, const AMRoaringRangeSet &b) { return a - b; });
+}
+BENCHMARK(BM_roaringSubtract)->Apply(countsAndDeltas);
+
+static void BM_flatSubtract(benchmark::State &state)
+{
+    runOp<AMRangeSet<uint32_t> >(state, [](const AMRangeSet<uint32_t> &a, const AMRangeSet<uint32_t> &b) { return a - b; });
+}
+BENCHMARK(BM_flatSubtract)->Apply(countsAndDeltas);
+
+static void BM_roaringIntersect(benchmark::State &state)
+{
+    runOp<AMRoaringRangeSet>(state, [](const AMRoaringRangeSet &a, const AMRoaringRangeSet &b) { return a & b; });
+}
+BENCHMARK(BM_roaringIntersect)->Apply(countsAndDeltas);
+
+static void BM_flatIntersect(benchmark::State &state)
+{
+    runOp<AMRangeSet<uint32_t> >(state, [](const AMRangeSet<uint32_t> &a, const AMRangeSet<uint32_t> &b) { return a & b; });
+}
+BENCHMARK(BM_flatIntersect)->Apply(countsAndDeltas);
+
+static void BM_roaringMemory(benchmark::State &state)
+{
+    AMRangeSet<uint32_t> s = makeFragmented(state.range(0), uint32_t(state.range(1)), 1);
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        AMRoaringRangeSet r(s);
+        bytes = r.memoryUsage();
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes_per_range"] = double(bytes) / double(state.range(0));
+}
+BENCHMARK(BM_roaringMemory)->Apply(countsAndDeltas);
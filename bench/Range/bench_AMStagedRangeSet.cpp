@@ -0,0 +1,101 @@
+#include "../../AMStagedRangeSet.h"
+#include "benchmark/benchmark.h"
+#include <random>
+
+using namespace AMCore;
+
+/*
+ * n ranges of length 50 with step 100, and batch of 1000 ranges inserted into region of 1000 of them.
+ */
+static AMRangeSet<int64_t> makeBase(int64_t count)
+{
+    std::vector<AMRange<int64_t> > v(count);
+    for (int64_t i = 0; i < count; i++) {
+        v[i] = AMRange<int64_t>(i * 100, i * 100 + 50);
+    }
+    return AMRangeSet<int64_t>::fromPacked(std::move(v));
+}
+
+static std::vector<AMRange<int64_t> > makeBatch(int64_t count, unsigned seed, bool farRegions = false)
+{
+    std::mt19937_64 random(seed);
+    int64_t region = int64_t(random() % count) * 100;
+    std::vector<AMRange<int64_t> > v(1000);
+    for (std::size_t i = 0; i < v.size(); i++) {
+        AMRange<int64_t> &r = v[i];
+        //half of batch at the beginning, half at the end of set
+        if (farRegions) {
+            region = i % 2 ? 0 : (count - 1000) * 100;
+        }
+        int64_t from = region + int64_t(random() % 100000);
+        r = AMRange<int64_t>(from, from + 1 + int64_t(random() % 60));
+    }
+    return v;
+}
+
+static void counts(benchmark::internal::Benchmark *b)
+{
+    b->RangeMultiplier(100)->Range(10000, 1000000)->ArgNames({"n"});
+}
+
+template<typename Set, typename Insert>
+static void runBatches(benchmark::State &state, const Set &base, Insert insert, bool farRegions = false)
+{
+    unsigned seed = 1;
+    for (auto _ : state) {
+        state.PauseTiming();
+        Set s = base;
+        std::vector<AMRange<int64_t> > batch = makeBatch(state.range(0), seed++, farRegions);
+        state.ResumeTiming();
+        insert(s, batch);
+        benchmark::DoNotOptimize(s);
+    }
+    state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+/*
+ * Batch inserted into std::set, whole set packed.
+ */
+static void BM_stdSetInsertPack(benchmark::State &state)
+{
+    runBatches(state, makeBase(state.range(0)).toSet(),
+               [](AMRangeStdSet<int64_t> &s, const std::vector<AMRange<int64_t> > &batch) {
+                   s.insert(batch.begin(), batch.end());
+                   s = pack(s);
+               });
+}
+BENCHMARK(BM_stdSetInsertPack)->Apply(counts);
+
+static void BM_rangeSetInsertEach(benchmark::State &state)
+{
+    runBatches(state, makeBase(state.range(0)),
+               [](AMRangeSet<int64_t> &s, const std::vector<AMRange<int64_t> > &batch) {
+                   for (const AMRange<int64_t> &r : batch) {
+                       s += r;
+                   }
+               });
+}
+BENCHMARK(BM_rangeSetInsertEach)->Apply(counts);
+
+static void BM_stagedInsertPack(benchmark::State &state)
+{
+    runBatches(state, AMStagedRangeSet<int64_t>(makeBase(state.range(0))),
+               [](AMStagedRangeSet<int64_t> &s, const std::vector<AMRange<int64_t> > &batch) {
+                   s.insert(batch.begin(), batch.end());
+                   s.pack();
+               });
+}
+BENCHMARK(BM_stagedInsertPack)->Apply(counts);
+
+/*
+ * Batch split to both ends of set, only two small regions are dirty.
+ */
+static void BM_stagedInsertPackFarRegions(benchmark::State &state)
+{
+    runBatches(state, AMStagedRangeSet<int64_t>(makeBase(state.range(0))),
+               [](AMStagedRangeSet<int64_t> &s, const std::vector<AMRange<int64_t> > &batch) {
+                   s.insert(batch.begin(), batch.end());
+                   s.pack();
+               }, true);
+}
+BENCHMARK(BM_stagedInsertPackFarRegions)->Apply(counts);
@@ -91,7 +91,20 @@
  *
  * \endcode
  *
- *  For more, see \ref AMRange.h
+ * Flat set of ranges (AMRangeSet.h), always packed, stored in contiguous array
+ *
+ * \code
+ *
+ *   AMRangeSet<int> f07(s07);
+ *   AMRangeSet<int> f05 = {AMRange(1,5), AMRange(3, 9)};
+ *
+ *   //operator+, operator-
+ *   EXPECT_EQ((f07 + f05).toSet(), s11);
+ *   EXPECT_EQ((f07 - f05).toSet(), s13);
+ *
+ * \endcode
+ *
+ *  For more, see \ref AMRange.h and \ref AMRangeSet.h
  *
  * Sources
  * =======
@@ -0,0 +1,67 @@
+/**
+ * @file: AMRangeTestUtil.h
+ * Helpers shared by tests of sets of ranges
+ *
+ * @author Zdeněk Skulínek  &lt;<a href="mailto:me@zdenekskulinek.cz">me@zdenekskulinek.cz</a>&gt;
+ */
+
+#ifndef AMCORE_AMRANGETESTUTIL_H
+#define AMCORE_AMRANGETESTUTIL_H
+
+#include "../../AMRangeSet.h"
+#include "gtest/gtest.h"
+#include <random>
+#include <vector>
+
+namespace AMRangeTest {
+
+    /*
+     * count random ranges starting in <base, base + spread), shorter than maxLength,
+     * unsorted, overlapping and empty ones included.
+     */
+    template<typename T>
+    std::vector<AMCore::AMRange<T> > randomRanges(std::size_t count, T base, unsigned spread, unsigned maxLength,
+                                                  unsigned seed)
+    {
+        std::mt19937 random(seed);
+        std::vector<AMCore::AMRange<T> > v(count);
+        for (AMCore::AMRange<T> &r : v) {
+            T from = T(base + T(random() % spread));
+            r = AMCore::AMRange<T>(from, T(from + T(random() % maxLength)));
+        }
+        return v;
+    }
+
+    /*
+     * Packed set of random ranges.
+     */
+    template<typename T>
+    AMCore::AMRangeSet<T> makeRandom(std::size_t count, T base, unsigned spread, unsigned maxLength, unsigned seed)
+    {
+        return AMCore::AMRangeSet<T>::fromUnsorted(randomRanges<T>(count, base, spread, maxLength, seed));
+    }
+
+    /*
+     * Ranges, their count and total length kept by tested structure are the same as in expected set.
+     */
+    template<typename T, typename Size, typename Measure>
+    void checkSame(const AMCore::AMRangeSet<T> &ranges, Size size, Measure measure,
+                   const AMCore::AMRangeSet<T> &expected)
+    {
+        EXPECT_EQ(ranges, expected);
+        EXPECT_EQ(size, expected.size());
+        EXPECT_EQ(measure, expected.measure());
+    }
+
+    /*
+     * Set of ranges S is the same as expected set.
+     */
+    template<typename S, typename T>
+    void checkSame(const S &s, const AMCore::AMRangeSet<T> &expected)
+    {
+        checkSame(s.toRangeSet(), s.size(), s.measure(), expected);
+        EXPECT_EQ(s.empty(), expected.empty());
+    }
+}
+
+#endif //AMCORE_AMRANGETESTUTIL_H
@@ -0,0 +1,143 @@
+#define AMRANGE_COMPRESSED_BLOCK_SIZE 4
+#include "../../AMCompressedRangeSet.h"
+#include "../../AMRangeView.h"
+#include "gtest/gtest.h"
+#include "AMRangeTestUtil.h"
+#include <limits>
+
+using namespace AMCore;
+using namespace AMRangeTest;
+
+
+template<typename T>
+static void checkCompressed(const AMRangeSet<T> &s, T lo, T hi)
+{
+    AMCompressedRangeSet<T> c(s);
+    EXPECT_EQ(c.size(), s.size());
+    EXPECT_EQ(c.empty(), s.empty());
+    EXPECT_EQ(c.toRangeSet(), s);
+    EXPECT_TRUE(std::equal(c.begin(), c.end(), s.begin(), s.end()));
+    for (T num = lo; num != hi; num++) {
+        typename AMCompressedRangeSet<T>::const_iterator it = c.find(num);
+        typename AMRangeSet<T>::const_iterator is = s.find(num);
+        ASSERT_EQ(it == c.end(), is == s.end());
+        if (is != s.end()) {
+            EXPECT_EQ(*it, *is);
+        }
+        AMRange<T> r(num, T(num + 3));
+        EXPECT_EQ(c.covers(r), s.covers(r));
+        EXPECT_EQ(c.overlaps(r), s.overlaps(r));
+    }
+}
+
+TEST(AMCompressedRangeSet, basicTest)
+{
+    typedef AMRange<int> R;
+    std::set<R> s07 = {R(1, 5), R(7, 9), R(7, 12), R(12, 15), R(17, 19)};
+    AMRangeSet<int> f08 = {R(1, 5), R(7, 15), R(17, 19)};
+    AMCompressedRangeSet<int> c01;
+    AMCompressedRangeSet<int> c07(s07);
+    AMCompressedRangeSet<int> c08(f08);
+
+    EXPECT_EQ(c07, c08);
+    EXPECT_NE(c01, c08);
+
+    //the same lengths and gaps, only first bound of blocks differs
+    EXPECT_NE(AMCompressedRangeSet<int>(AMRangeSet<int>(R(0, 5))), AMCompressedRangeSet<int>(AMRangeSet<int>(R(10, 15))));
+    AMRangeSet<int> f09 = {R(1, 5), R(7, 15), R(17, 19), R(20, 21), R(25, 26)};
+    AMRangeSet<int> f10 = {R(1, 5), R(7, 15), R(17, 19), R(20, 21), R(30, 31)};
+    EXPECT_NE(AMCompressedRangeSet<int>(f09), AMCompressedRangeSet<int>(f10));
+    EXPECT_EQ(AMCompressedRangeSet<int>(f09), AMCompressedRangeSet<int>(f09.begin(), f09.end()));
+    EXPECT_EQ(c08.toRangeSet(), f08);
+    EXPECT_EQ(*c08.find(10), R(7, 15));
+    EXPECT_EQ(c08.find(15), c08.end());
+    EXPECT_TRUE(c08.covers(R(8, 15)));
+    EXPECT_FALSE(c08.covers(R(8, 16)));
+    EXPECT_TRUE(c08.overlaps(R(15, 18)));
+    EXPECT_FALSE(c08.overlaps(R(15, 17)));
+
+    //iterators
+    AMCompressedRangeSet<int>::const_iterator it = c08.begin();
+    EXPECT_EQ(it->from, 1);
+    EXPECT_EQ(*it++, R(1, 5));
+    EXPECT_EQ(*it, R(7, 15));
+    EXPECT_EQ(std::distance(c08.begin(), c08.end()), 3);
+
+    //usable as view operand
+    std::set<R> s09 = {R(16, 17), R(19, 20), R(27, 29)};
+    EXPECT_EQ((rangeView(c08) + rangeView(s09)).toSet(), f08.toSet() + s09);
+
+    //small deltas take one byte per bound, index of tiny test blocks still dominates
+    std::vector<R> v;
+    for (int i = 0; i < 10000; i++) {
+        v.push_back(R(i * 10, i * 10 + 5));
+    }
+    AMCompressedRangeSet<int> c10(v.begin(), v.end());
+    EXPECT_EQ(c10.size(), v.size());
+    EXPECT_LT(c10.memoryUsage(), v.size() * sizeof(R));
+}
+
+TEST(AMCompressedRangeSet, edgeTest)
+{
+    typedef AMRange<int> R;
+
+    //empty set, empty ranges of input are skipped
+    AMCompressedRangeSet<int> c01;
+    std::vector<R> v01 = {R(3, 3), R(5, 5)};
+    AMCompressedRangeSet<int> c02(v01.begin(), v01.end());
+    EXPECT_EQ(c01, c02);
+    EXPECT_TRUE(c02.empty());
+    EXPECT_EQ(c02.size(), 0u);
+    EXPECT_EQ(c02.begin(), c02.end());
+    EXPECT_EQ(c02.find(3), c02.end());
+    EXPECT_TRUE(c02.covers(R(3, 3)));
+    EXPECT_FALSE(c02.overlaps(R(0, 10)));
+    EXPECT_TRUE(c02.toRangeSet().empty());
+
+    //gaps of one number encode zero deltas, over several blocks
+    std::vector<R> v03;
+    for (int i = 0; i < 40; i++) {
+        v03.push_back(R(i * 2, i * 2 + 1));
+    }
+    AMCompressedRangeSet<int> c03(v03.begin(), v03.end());
+    EXPECT_EQ(c03.size(), 40u);
+    EXPECT_EQ(*c03.find(78), R(78, 79));
+    EXPECT_EQ(c03.find(79), c03.end());
+    EXPECT_TRUE(c03.covers(R(40, 41)));
+    EXPECT_FALSE(c03.covers(R(40, 42)));
+    EXPECT_FALSE(c03.overlaps(R(41, 42)));
+    EXPECT_TRUE(std::equal(c03.begin(), c03.end(), v03.begin(), v03.end()));
+
+    //wide gaps need many varint bytes, bounds near limits wrap in unsigned deltas
+    const int64_t lo = std::numeric_limits<int64_t>::min();
+    const int64_t hi = std::numeric_limits<int64_t>::max();
+    AMRangeSet<int64_t> w = {AMRange<int64_t>(lo, lo + 2), AMRange<int64_t>(-5000000000, -1),
+                             AMRange<int64_t>(7, 9), AMRange<int64_t>(hi - 3, hi)};
+    AMCompressedRangeSet<int64_t> cw(w);
+    EXPECT_EQ(cw.toRangeSet(), w);
+    EXPECT_EQ(*cw.find(hi - 1), AMRange<int64_t>(hi - 3, hi));
+    EXPECT_EQ(cw.find(hi), cw.end());
+    EXPECT_EQ(*cw.find(lo), AMRange<int64_t>(lo, lo + 2));
+    EXPECT_EQ(cw.find(0), cw.end());
+    EXPECT_TRUE(cw.covers(AMRange<int64_t>(hi - 3, hi)));
+    AMRangeSet<uint64_t> u = {AMRange<uint64_t>(0, 1), AMRange<uint64_t>(std::numeric_limits<uint64_t>::max() - 1,
+                                                                          std::numeric_limits<uint64_t>::max())};
+    EXPECT_EQ(AMCompressedRangeSet<uint64_t>(u).toRangeSet(), u);
+    AMRangeSet<uint8_t> b = {AMRange<uint8_t>(0, 255)};
+    checkCompressed(b, uint8_t(0), uint8_t(255));
+}
+
+TEST(AMCompressedRangeSet, randomTest)
+{
+    for (unsigned seed = 1; seed < 20; seed++) {
+        checkCompressed(makeRandom<int>(seed * 20, -1000, 3000, 1 + seed * 5, seed), -1100, 2100);
+        checkCompressed(makeRandom<int16_t>(seed * 20, -1000, 3000, 1 + seed * 5, seed), int16_t(-1100), int16_t(2100));
+        checkCompressed(makeRandom<uint8_t>(seed, 0, 250, 5, seed), uint8_t(0), uint8_t(255));
+    }
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
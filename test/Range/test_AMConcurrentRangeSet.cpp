@@ -0,0 +1,133 @@
+#include "../../AMConcurrentRangeSet.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace AMCore;
+
+
+TEST(AMConcurrentRangeSet, basicTest)
+{
+    typedef AMRange<int> R;
+    AMConcurrentRangeSet<int> c01;
+    AMConcurrentRangeSet<int> c07(AMRangeSet<int>{R(1, 5), R(7, 9), R(7, 12), R(12, 15), R(17, 19)});
+
+    EXPECT_EQ(c01.size(), 0u);
+    EXPECT_FALSE(c01.contains(1));
+    EXPECT_EQ(c07.size(), 3u);
+    EXPECT_EQ(c07.measure(), 14u);
+    EXPECT_TRUE(c07.contains(14));
+    EXPECT_FALSE(c07.contains(15));
+    EXPECT_TRUE(c07.covers(R(8, 15)));
+    EXPECT_FALSE(c07.covers(R(8, 16)));
+    EXPECT_TRUE(c07.overlaps(R(15, 18)));
+    EXPECT_FALSE(c07.overlaps(R(15, 17)));
+
+    c07.insert(R(15, 17));
+    EXPECT_EQ(c07.toRangeSet(), AMRangeSet<int>({R(1, 5), R(7, 19)}));
+    c07.erase(R(3, 8));
+    EXPECT_EQ(c07.toRangeSet(), AMRangeSet<int>({R(1, 3), R(8, 19)}));
+
+    //erased after inserted
+    c07.update({R(20, 30), R(40, 50), R(2, 9)}, {R(25, 45), R(0, 2)});
+    EXPECT_EQ(c07.toRangeSet(), AMRangeSet<int>({R(2, 19), R(20, 25), R(45, 50)}));
+
+    c07.modify([](AMRangeSet<int> &s) { s &= R(10, 22); });
+    EXPECT_EQ(c07.toRangeSet(), AMRangeSet<int>({R(10, 19), R(20, 22)}));
+
+    //nothing is published when function throws
+    EXPECT_THROW(c07.modify([](AMRangeSet<int> &s) {
+        s.clear();
+        throw std::runtime_error("failed");
+    }), std::runtime_error);
+    EXPECT_EQ(c07.size(), 2u);
+
+    {
+        AMConcurrentRangeSet<int>::Snapshot s1 = c07.snapshot();
+        AMConcurrentRangeSet<int>::Snapshot s2 = std::move(s1);
+        EXPECT_EQ(s2->measure(), 11u);
+        EXPECT_EQ((*s2).size(), 2u);
+    }
+    EXPECT_EQ(c07.read([](const AMRangeSet<int> &s) { return s.largestGap(); }), 1u);
+
+    c07.assign(AMRangeSet<int>{R(0, 1)});
+    EXPECT_EQ(c07.toRangeSet(), AMRangeSet<int>{R(0, 1)});
+}
+
+TEST(AMConcurrentRangeSet, snapshotWriteTest)
+{
+    typedef AMRange<int> R;
+    AMConcurrentRangeSet<int> c01;
+    AMConcurrentRangeSet<int> c02(AMRangeSet<int>{R(1, 5)});
+
+    //snapshot of other set does not block writer
+    {
+        AMConcurrentRangeSet<int>::Snapshot s = c02.snapshot();
+        c01.insert(R(7, 9));
+        EXPECT_EQ(s->measure(), 4u);
+    }
+    c01.read([&c02](const AMRangeSet<int> &) { c02.insert(R(5, 6)); return 0; });
+    EXPECT_EQ(c01.measure(), 2u);
+    EXPECT_EQ(c02.measure(), 5u);
+    //released snapshots do not count
+    c02.erase(R(1, 2));
+    EXPECT_EQ(c02.measure(), 4u);
+
+#ifndef NDEBUG
+    //writing while holding snapshot of the same set would never finish
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_DEATH(c01.read([&c01](const AMRangeSet<int> &) { c01.insert(R(1, 2)); return 0; }), "snapshot");
+    EXPECT_DEATH({
+        AMConcurrentRangeSet<int>::Snapshot s = c01.snapshot();
+        c01.assign(AMRangeSet<int>());
+    }, "snapshot");
+#endif
+}
+
+TEST(AMConcurrentRangeSet, threadTest)
+{
+    typedef AMRange<int> R;
+    AMRangeSet<int> a, b;
+    for (int i = 0; i < 1000; i++) {
+        a += R(i * 10, i * 10 + 5);
+        b += R(i * 10 + 2, i * 10 + 8);
+    }
+    AMConcurrentRangeSet<int> c(a);
+    std::atomic<bool> stop(false);
+    std::atomic<int> inconsistent(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&]() {
+            while (!stop.load()) {
+                AMConcurrentRangeSet<int>::Snapshot s = c.snapshot();
+                if (*s != a && *s != b) {
+                    inconsistent++;
+                }
+                // every published state contains 3
+                if (!c.contains(3) || !c.covers(R(5002, 5005))) {
+                    inconsistent++;
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 100; i++) {
+        if (i % 2) {
+            c.assign(a);
+        } else {
+            c.modify([&](AMRangeSet<int> &s) { s = b; });
+        }
+    }
+    stop = true;
+    for (std::thread &t : readers) {
+        t.join();
+    }
+    EXPECT_EQ(inconsistent.load(), 0);
+    EXPECT_EQ(c.toRangeSet(), a);
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
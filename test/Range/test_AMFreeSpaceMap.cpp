@@ -0,0 +1,143 @@
+#include "../../AMFreeSpaceMap.h"
+#include "gtest/gtest.h"
+#include "AMRangeTestUtil.h"
+
+using namespace AMCore;
+using namespace AMRangeTest;
+
+
+/*
+ * Linear scans over packed free ranges.
+ */
+static AMRange<int> scanFirstFit(const AMRangeSet<int> &free, unsigned len, const AMRange<int> &bound)
+{
+    for (const AMRange<int> &r : free) {
+        int from = std::max(r.from, bound.from);
+        int to = std::min(r.to, bound.to);
+        if (from < to && unsigned(to - from) >= len) {
+            return AMRange<int>(from, from + int(len));
+        }
+    }
+    return AMRange<int>();
+}
+
+static AMRange<int> scanBestFit(const AMRangeSet<int> &free, unsigned len)
+{
+    const AMRange<int> *best = nullptr;
+    for (const AMRange<int> &r : free) {
+        if (measure(r) >= len && (!best || measure(r) < measure(*best))) {
+            best = &r;
+        }
+    }
+    return best ? AMRange<int>(best->from, best->from + int(len)) : AMRange<int>();
+}
+
+static void checkFree(const AMFreeSpaceMap<int> &m, const AMRangeSet<int> &free)
+{
+    checkSame(m.freeRanges(), m.size(), m.freeMeasure(), free);
+    EXPECT_EQ(m.usedRanges(), AMRangeSet<int>(m.space()) - free);
+    unsigned longest = 0;
+    for (const AMRange<int> &r : free) {
+        longest = std::max(longest, measure(r));
+    }
+    EXPECT_EQ(m.largestFree(), longest);
+}
+
+TEST(AMFreeSpaceMap, basicTest)
+{
+    typedef AMRange<int> R;
+    AMFreeSpaceMap<int> m01(R(0, 100));
+    EXPECT_EQ(m01.size(), 1u);
+    EXPECT_EQ(m01.freeMeasure(), 100u);
+    EXPECT_TRUE(m01.isFree(R(0, 100)));
+    EXPECT_FALSE(m01.isFree(100));
+
+    AMFreeSpaceMap<int> m02(R(0, 100), AMRangeSet<int>{R(10, 20), R(25, 30), R(40, 90)});
+    checkFree(m02, AMRangeSet<int>{R(0, 10), R(20, 25), R(30, 40), R(90, 100)});
+    EXPECT_EQ(m02.firstFit(8), R(0, 8));
+    EXPECT_EQ(m02.firstFit(11), R());
+    EXPECT_EQ(m02.firstFit(4, R(5, 100)), R(5, 9));
+    EXPECT_EQ(m02.firstFit(6, R(5, 100)), R(30, 36));
+    EXPECT_EQ(m02.firstFit(10, R(5, 100)), R(30, 40));
+    EXPECT_EQ(m02.firstFit(10, R(5, 39)), R());
+    EXPECT_EQ(m02.nextFit(5, 22), R(30, 35));
+    EXPECT_EQ(m02.nextFit(9, 95), R(0, 9));
+    EXPECT_EQ(m02.bestFit(5), R(20, 25));
+    EXPECT_EQ(m02.bestFit(6), R(0, 6));
+    EXPECT_EQ(m02.bestFit(11), R());
+
+    //reserve at start of free range, inside it and whole free range
+    EXPECT_EQ(m02.reserveBestFit(5), R(20, 25));
+    EXPECT_EQ(m02.reserveFirstFit(2, R(33, 50)), R(33, 35));
+    EXPECT_EQ(m02.reserveNextFit(10, 35), R(90, 100));
+    checkFree(m02, AMRangeSet<int>{R(0, 10), R(30, 33), R(35, 40)});
+    EXPECT_EQ(m02.reserveFirstFit(11), R());
+
+    //release merges touching free ranges and ignores space outside
+    m02.release(R(33, 35));
+    m02.release(R(95, 120));
+    m02.release(R(-10, 2));
+    checkFree(m02, AMRangeSet<int>{R(0, 10), R(30, 40), R(95, 100)});
+    m02.reserve(R(35, 97));
+    checkFree(m02, AMRangeSet<int>{R(0, 10), R(30, 35), R(97, 100)});
+
+    AMFreeSpaceMap<int> m03(std::move(m02));
+    m02 = std::move(m03);
+    EXPECT_EQ(m02.size(), 3u);
+}
+
+TEST(AMFreeSpaceMap, randomTest)
+{
+    for (unsigned seed = 1; seed < 20; seed++) {
+        std::mt19937 random(seed);
+        AMRange<int> space(0, 100000);
+        AMRangeSet<int> used;
+        for (int i = 0; i < 200; i++) {
+            int from = int(random() % 100000);
+            used += AMRange<int>(from, from + int(random() % 300));
+        }
+        AMFreeSpaceMap<int> m(space, used);
+        AMRangeSet<int> free = AMRangeSet<int>(space) - used;
+        checkFree(m, free);
+        for (int i = 0; i < 2000; i++) {
+            unsigned len = 1 + random() % (i % 10 == 0 ? 3000 : 200);
+            int from = int(random() % 110000) - 5000;
+            AMRange<int> bound(from, from + int(random() % 20000));
+            EXPECT_EQ(m.firstFit(len, bound), scanFirstFit(free, len, bound));
+            EXPECT_EQ(m.bestFit(len), scanBestFit(free, len));
+            AMRange<int> r;
+            switch (random() % 5) {
+                case 0:
+                    r = m.reserveFirstFit(len);
+                    EXPECT_EQ(r, scanFirstFit(free, len, space));
+                    break;
+                case 1:
+                    r = m.reserveBestFit(len);
+                    break;
+                case 2:
+                    r = m.reserveFirstFit(len, bound);
+                    break;
+                case 3:
+                    r = AMRange<int>(from, from + int(len));
+                    m.release(r);
+                    free += intersect(r, space);
+                    r = AMRange<int>();
+                    break;
+                default:
+                    r = AMRange<int>(from, from + int(len));
+                    m.reserve(r);
+                    break;
+            }
+            free -= r;
+            EXPECT_EQ(m.size(), free.size());
+            EXPECT_EQ(m.freeMeasure(), free.measure());
+        }
+        checkFree(m, free);
+    }
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
@@ -0,0 +1,83 @@
+#include "../../AMIntervalIndex.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace AMCore;
+
+
+TEST(AMIntervalIndex, basicTest)
+{
+    typedef AMIntervalIndex<int, std::string> Index;
+    Index empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.containing(1).empty());
+    EXPECT_TRUE(empty.overlapping(AMRange(1, 5)).empty());
+
+    Index idx({{AMRange(5, 10), "b"}, {AMRange(1, 3), "a"}, {AMRange(5, 10), "c"}, {AMRange(8, 20), "d"},
+               {AMRange(9, 9), "e"}, {AMRange(12, 11), "f"}});
+    EXPECT_EQ(idx.size(), 6);
+    EXPECT_EQ(idx[0].payload, "a");
+    EXPECT_EQ(idx[1].payload, "b");
+    EXPECT_EQ(idx[2].payload, "c");
+
+    std::string s;
+    idx.forEachContaining(9, [&s](const Index::Entry &e) { s += e.payload; });
+    EXPECT_EQ(s, "bcd");
+    s.clear();
+    idx.forEachContaining(10, [&s](const Index::Entry &e) { s += e.payload; });
+    EXPECT_EQ(s, "d");
+    s.clear();
+    idx.forEachContaining(3, [&s](const Index::Entry &e) { s += e.payload; });
+    EXPECT_EQ(s, "");
+    s.clear();
+    idx.forEachOverlapping(AMRange(2, 6), [&s](const Index::Entry &e) { s += e.payload; });
+    EXPECT_EQ(s, "abc");
+    s.clear();
+    idx.forEachOverlapping(AMRange(3, 5), [&s](const Index::Entry &e) { s += e.payload; });
+    EXPECT_EQ(s, "");
+    s.clear();
+    idx.forEachOverlapping(AMRange(7, 7), [&s](const Index::Entry &e) { s += e.payload; });
+    EXPECT_EQ(s, "");
+    EXPECT_EQ(idx.containing(1), std::vector<std::size_t>{0});
+    EXPECT_EQ(idx.overlapping(AMRange(10, 30)), std::vector<std::size_t>{3});
+}
+
+TEST(AMIntervalIndex, randomTest)
+{
+    for (int n : {1, 2, 3, 7, 8, 9, 15, 16, 17, 100, 1000, 1025}) {
+        std::vector<AMIntervalIndex<int, int>::Entry> entries;
+        unsigned seed = n;
+        for (int i = 0; i < n; i++) {
+            seed = seed * 1103515245 + 12345;
+            int from = (seed >> 8) % 1000;
+            seed = seed * 1103515245 + 12345;
+            int len = (seed >> 8) % ((seed >> 20) % 3 == 0 ? 300 : 20);
+            entries.push_back({AMRange(from, from + len), i});
+        }
+        AMIntervalIndex<int, int> idx(entries);
+        for (int x = -5; x < 1310; x += 3) {
+            std::vector<std::size_t> expected;
+            for (std::size_t i = 0; i < idx.size(); i++) {
+                if (idx[i].range.in(x)) {
+                    expected.push_back(i);
+                }
+            }
+            EXPECT_EQ(idx.containing(x), expected);
+            AMRange<int> q(x, x + 17);
+            expected.clear();
+            for (std::size_t i = 0; i < idx.size(); i++) {
+                if (intersect(idx[i].range, q).nonEmpty()) {
+                    expected.push_back(i);
+                }
+            }
+            EXPECT_EQ(idx.overlapping(q), expected);
+        }
+    }
+}
+
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
@@ -0,0 +1,100 @@
+#include "../../AMPersistentRangeSet.h"
+#include "gtest/gtest.h"
+#include "AMRangeTestUtil.h"
+#include <cmath>
+
+using namespace AMCore;
+using namespace AMRangeTest;
+
+
+static void checkBalanced(const AMPersistentRangeSet<int> &p, const AMRangeSet<int> &s)
+{
+    checkSame(p, s);
+    EXPECT_LE(p.height(), 1.45 * std::log2(double(s.size()) + 2));
+}
+
+TEST(AMPersistentRangeSet, basicTest)
+{
+    typedef AMRange<int> R;
+    std::set<R> s07 = {R(1, 5), R(7, 9), R(7, 12), R(12, 15), R(17, 19)};
+    AMRangeSet<int> f08 = {R(1, 5), R(7, 15), R(17, 19)};
+    AMPersistentRangeSet<int> p01;
+    AMPersistentRangeSet<int> p07(s07);
+    AMPersistentRangeSet<int> p08(f08);
+
+    EXPECT_TRUE(p01.empty());
+    EXPECT_EQ(p01.begin(), p01.end());
+    EXPECT_FALSE(p01.contains(1));
+    EXPECT_TRUE(p01.covers(R(3, 3)));
+    EXPECT_FALSE(p01.overlaps(R(0, 10)));
+    EXPECT_EQ(p07, p08);
+    EXPECT_NE(p01, p08);
+    EXPECT_EQ(p08.toSet(), f08.toSet());
+    EXPECT_EQ(p08.measure(), 14u);
+    EXPECT_EQ(*p08.find(14), R(7, 15));
+    EXPECT_EQ(p08.find(15), p08.end());
+    EXPECT_EQ(*++p08.find(8), R(17, 19));
+    EXPECT_TRUE(p08.contains(14));
+    EXPECT_FALSE(p08.contains(15));
+    EXPECT_TRUE(p08.covers(R(8, 15)));
+    EXPECT_FALSE(p08.covers(R(8, 16)));
+    EXPECT_TRUE(p08.overlaps(R(15, 18)));
+    EXPECT_FALSE(p08.overlaps(R(15, 17)));
+
+    //versions are not changed by operations
+    AMPersistentRangeSet<int> p09 = p08 + R(15, 17);
+    AMPersistentRangeSet<int> p10 = p09 - R(3, 8);
+    AMPersistentRangeSet<int> p11 = p10 - R(10, 12) + R(0, 1);
+    EXPECT_EQ(p08.toRangeSet(), f08);
+    EXPECT_EQ(p09.toRangeSet(), AMRangeSet<int>({R(1, 5), R(7, 19)}));
+    EXPECT_EQ(p10.toRangeSet(), AMRangeSet<int>({R(1, 3), R(8, 19)}));
+    EXPECT_EQ(p11.toRangeSet(), AMRangeSet<int>({R(0, 3), R(8, 10), R(12, 19)}));
+    EXPECT_EQ(p11.measure(), 12u);
+
+    //nothing changes, whole tree is shared
+    AMPersistentRangeSet<int> p12 = p11 + R(13, 15) - R(20, 30);
+    EXPECT_EQ(p12, p11);
+
+    EXPECT_EQ((p11 + p07).toRangeSet(), AMRangeSet<int>({R(0, 5), R(7, 19)}));
+    EXPECT_EQ((p07 - p11).toRangeSet(), AMRangeSet<int>({R(3, 5), R(7, 8), R(10, 12)}));
+    EXPECT_TRUE((p11 - p11).empty());
+    EXPECT_EQ(p01 + p11, p11);
+    p12.clear();
+    EXPECT_TRUE(p12.empty());
+    EXPECT_EQ(p11.size(), 3u);
+}
+
+TEST(AMPersistentRangeSet, versionTest)
+{
+    //every version stays equal to flat set built by the same operations
+    std::mt19937 random(1);
+    std::vector<AMPersistentRangeSet<int> > versions(1);
+    std::vector<AMRangeSet<int> > expected(1);
+    for (int i = 0; i < 3000; i++) {
+        int from = int(random() % 20000);
+        AMRange<int> r(from, from + int(random() % (i % 50 == 0 ? 2000 : 20)));
+        std::size_t base = random() % versions.size();
+        if (random() % 3) {
+            versions.push_back(versions[base] + r);
+            expected.push_back(expected[base] + r);
+        } else {
+            versions.push_back(versions[base] - r);
+            expected.push_back(expected[base] - r);
+        }
+        EXPECT_EQ(versions.back().contains(from), expected.back().find(from) != expected.back().end());
+        EXPECT_EQ(versions[base].covers(r), expected[base].covers(r));
+        EXPECT_EQ(versions[base].overlaps(r), expected[base].overlaps(r));
+    }
+    for (std::size_t i = 0; i < versions.size(); i++) {
+        checkBalanced(versions[i], expected[i]);
+    }
+    AMPersistentRangeSet<int> built(expected.back());
+    checkBalanced(built, expected.back());
+    EXPECT_EQ(built, versions.back());
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
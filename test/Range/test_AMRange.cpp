@@ -1,5 +1,7 @@
 #include "../../AMRange.h"
 #include "gtest/gtest.h"
+#include <vector>
+#include <memory_resource>
 
 using namespace AMCore;
 
@@ -174,6 +176,17 @@ TEST(AMRange, setTest)
     EXPECT_EQ(s03 + s02, s03);
     EXPECT_EQ(s03 + s04, s12);
     EXPECT_EQ(s07 + s09, s10);
+    EXPECT_EQ(s07 + AMRange(15, 17), (std::set<AMRange<int> >{AMRange(1, 5), AMRange(7, 19)}));
+    EXPECT_EQ(AMRange(3, 3) + s03, s03);
+    EXPECT_EQ(s03 + AMRange(9, 3), s03);
+
+    //unite
+    std::vector<AMRange<int> > v01;
+    unite(s07.begin(), s07.end(), s09.begin(), s09.end(), std::back_inserter(v01));
+    EXPECT_EQ(std::set<AMRange<int> >(v01.begin(), v01.end()), s10);
+    v01.clear();
+    unite(s06.begin(), s06.end(), s01.begin(), s01.end(), std::back_inserter(v01));
+    EXPECT_EQ(v01, std::vector<AMRange<int> >{AMRange(1, 5)});
 
     //operator-
     EXPECT_EQ(s07 - s05, s13);
@@ -186,6 +199,350 @@ TEST(AMRange, setTest)
     EXPECT_EQ(AMRange(0, 35) - s07, s16);
     EXPECT_EQ(s07 - AMRange(18, 20), s17);
     EXPECT_EQ(AMRange(1, 28) - s10, s18);
+
+    //operator&
+    EXPECT_EQ(s07 & s05, (std::set<AMRange<int> >{AMRange(1, 5), AMRange(7, 9)}));
+    EXPECT_EQ(s07 & s09, s01);
+    EXPECT_EQ(s07 & s01, s01);
+    EXPECT_EQ(s03 & s02, s02);
+    EXPECT_EQ(s07 & s14, (std::set<AMRange<int> >{AMRange(1, 5), AMRange(7, 8), AMRange(17, 18)}));
+    EXPECT_EQ(intersect(s14, s07), s07 & s14);
+    EXPECT_EQ(AMRange(0, 35) & s07, s08);
+    EXPECT_EQ(s07 & AMRange(18, 20), std::set<AMRange<int> >{AMRange(18, 19)});
+    EXPECT_EQ(s07 & AMRange(20, 18), s01);
+    EXPECT_EQ(s07 & s05, s07 - (s07 - s05));
+    EXPECT_EQ(s10 & s16, s10 - (s10 - s16));
+
+    //symmetricDifference
+    EXPECT_EQ(s07 ^ s05, (std::set<AMRange<int> >{AMRange(5, 7), AMRange(9, 15), AMRange(17, 19)}));
+    EXPECT_EQ(symmetricDifference(s05, s07), s07 ^ s05);
+    EXPECT_EQ(s07 ^ s01, s08);
+    EXPECT_EQ(s01 ^ s07, s08);
+    EXPECT_EQ(s07 ^ s08, s01);
+    EXPECT_EQ(s03 ^ s04, std::set<AMRange<int> >{AMRange(5, 7)});
+    EXPECT_EQ(s08 ^ s09, (std::set<AMRange<int> >{AMRange(1, 5), AMRange(7, 15), AMRange(16, 20), AMRange(27, 29)}));
+    EXPECT_EQ(s10 ^ s16, (s10 - s16) + (s16 - s10));
+    EXPECT_EQ(s14 ^ s07, (s14 - s07) + (s07 - s14));
+
+    //complement
+    EXPECT_EQ(complement(s07, AMRange(0, 35)), s16);
+    EXPECT_EQ(complement(s07, AMRange(0, 35)), AMRange(0, 35) - s07);
+    EXPECT_EQ(complement(s07, AMRange(3, 18)), (std::set<AMRange<int> >{AMRange(5, 7), AMRange(15, 17)}));
+    EXPECT_EQ(complement(s07, AMRange(7, 15)), s01);
+    EXPECT_EQ(complement(s01, AMRange(7, 15)), std::set<AMRange<int> >{AMRange(7, 15)});
+    EXPECT_EQ(complement(s07, AMRange(15, 7)), s01);
+    EXPECT_EQ(complement(std::set<AMRange<int> >{AMRange(1, 3), AMRange(5, 5), AMRange(7, 9)}, AMRange(0, 10)),
+              (std::set<AMRange<int> >{AMRange(0, 1), AMRange(3, 7), AMRange(9, 10)}));
+
+    //operator+=, operator-=, operator&= in place
+    std::set<AMRange<int> > si = s08;
+    si += AMRange(15, 17);
+    EXPECT_EQ(si, (std::set<AMRange<int> >{AMRange(1, 5), AMRange(7, 19)}));
+    si += AMRange(-3, -1);
+    si += AMRange(30, 31);
+    si += AMRange(2, 3);
+    si += AMRange(4, 3);
+    EXPECT_EQ(si, (std::set<AMRange<int> >{AMRange(-3, -1), AMRange(1, 5), AMRange(7, 19), AMRange(30, 31)}));
+    si += AMRange(0, 30);
+    EXPECT_EQ(si, (std::set<AMRange<int> >{AMRange(-3, -1), AMRange(0, 31)}));
+    si -= AMRange(5, 7);
+    EXPECT_EQ(si, (std::set<AMRange<int> >{AMRange(-3, -1), AMRange(0, 5), AMRange(7, 31)}));
+    si -= AMRange(-2, 3);
+    EXPECT_EQ(si, (std::set<AMRange<int> >{AMRange(-3, -2), AMRange(3, 5), AMRange(7, 31)}));
+    si -= AMRange(-10, 4);
+    si -= AMRange(30, 40);
+    si -= AMRange(20, 10);
+    EXPECT_EQ(si, (std::set<AMRange<int> >{AMRange(4, 5), AMRange(7, 30)}));
+    si &= AMRange(4, 8);
+    EXPECT_EQ(si, (std::set<AMRange<int> >{AMRange(4, 5), AMRange(7, 8)}));
+    si &= AMRange(5, 7);
+    EXPECT_EQ(si, s01);
+    si = s08;
+    si &= AMRange(3, 18);
+    EXPECT_EQ(si, (std::set<AMRange<int> >{AMRange(3, 5), AMRange(7, 15), AMRange(17, 18)}));
+    si &= AMRange(8, 9);
+    EXPECT_EQ(si, std::set<AMRange<int> >{AMRange(8, 9)});
+    si = s08;
+    si += s09;
+    EXPECT_EQ(si, s08 + s09);
+    si -= s14;
+    EXPECT_EQ(si, (s08 + s09) - s14);
+    si &= s16;
+    EXPECT_EQ(si, ((s08 + s09) - s14) & s16);
+
+    //find, covers, overlaps, overlapping
+    EXPECT_EQ(find(s08, 0), s08.end());
+    EXPECT_EQ(*find(s08, 1), AMRange(1, 5));
+    EXPECT_EQ(*find(s08, 4), AMRange(1, 5));
+    EXPECT_EQ(find(s08, 5), s08.end());
+    EXPECT_EQ(find(s08, 6), s08.end());
+    EXPECT_EQ(*find(s08, 7), AMRange(7, 15));
+    EXPECT_EQ(*find(s08, 18), AMRange(17, 19));
+    EXPECT_EQ(find(s08, 19), s08.end());
+    EXPECT_EQ(find(s01, 19), s01.end());
+    EXPECT_TRUE(covers(s08, AMRange(1, 5)));
+    EXPECT_TRUE(covers(s08, AMRange(8, 10)));
+    EXPECT_TRUE(covers(s08, AMRange(30, 30)));
+    EXPECT_TRUE(covers(s01, AMRange(30, 30)));
+    EXPECT_FALSE(covers(s08, AMRange(0, 3)));
+    EXPECT_FALSE(covers(s08, AMRange(4, 8)));
+    EXPECT_FALSE(covers(s08, AMRange(5, 6)));
+    EXPECT_FALSE(covers(s01, AMRange(5, 6)));
+    EXPECT_TRUE(overlaps(s08, AMRange(0, 2)));
+    EXPECT_TRUE(overlaps(s08, AMRange(4, 8)));
+    EXPECT_TRUE(overlaps(s08, AMRange(14, 30)));
+    EXPECT_FALSE(overlaps(s08, AMRange(5, 7)));
+    EXPECT_FALSE(overlaps(s08, AMRange(15, 17)));
+    EXPECT_FALSE(overlaps(s08, AMRange(8, 8)));
+    EXPECT_FALSE(overlaps(s08, AMRange(20, 30)));
+    EXPECT_FALSE(overlaps(s01, AMRange(20, 30)));
+    auto ov = overlapping(s08, AMRange(4, 18));
+    EXPECT_EQ(std::set<AMRange<int> >(ov.first, ov.second), s08);
+    ov = overlapping(s08, AMRange(5, 17));
+    EXPECT_EQ(std::set<AMRange<int> >(ov.first, ov.second), std::set<AMRange<int> >{AMRange(7, 15)});
+    ov = overlapping(s08, AMRange(5, 7));
+    EXPECT_EQ(ov.first, ov.second);
+    ov = overlapping(s08, AMRange(8, 8));
+    EXPECT_EQ(ov.first, ov.second);
+
+    //sortAndPack, packUnsorted give the same result as pack
+    std::vector<AMRange<int> > v07 = {AMRange(17, 19), AMRange(12, 15), AMRange(7, 9), AMRange(1,5), AMRange(7, 12)};
+    EXPECT_EQ(packUnsorted(v07.begin(), v07.end()), pack(s07));
+    EXPECT_TRUE(packUnsorted(v07.begin(), v07.begin()).empty());
+    std::vector<AMRange<int> > v05 = {AMRange(3, 9), AMRange(4, 4), AMRange(1,5), AMRange(12, 9)};
+    sortAndPack(v05);
+    EXPECT_EQ(v05, std::vector<AMRange<int> >{AMRange(1, 9)});
+    std::vector<AMRange<int> > v15 = {AMRange(4, 4), AMRange(12, 9)};
+    sortAndPack(v15);
+    EXPECT_TRUE(v15.empty());
+}
+
+/*
+ * Radix sort gives the same order as std::sort.
+ */
+template<typename T>
+static void checkRadixSort(std::size_t count, T base, unsigned spread)
+{
+    std::vector<AMRange<T> > v(count);
+    unsigned x = 12345;
+    for (std::size_t i = 0; i < count; i++) {
+        x = x * 1103515245u + 12345u;
+        T from = T(base + T((x >> 8) % spread));
+        v[i] = AMRange<T>(from, T(from + T(x % 7)));
+    }
+    std::vector<AMRange<T> > expected = v;
+    std::sort(expected.begin(), expected.end());
+    std::vector<AMRange<T> > sorted = v;
+    radixSortRanges(sorted.begin(), sorted.end());
+    EXPECT_EQ(sorted, expected);
+    sorted = v;
+    sortRanges(sorted.begin(), sorted.end());
+    EXPECT_EQ(sorted, expected);
+    sorted = v;
+    radixSortRanges(sorted.begin(), sorted.end(), true);
+    EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(),
+                               [](const AMRange<T> &a, const AMRange<T> &b) { return a.from < b.from; }));
+    std::vector<AMRange<T> > packed = v;
+    sortAndPack(packed);
+    std::set<AMRange<T> > nonEmpty;
+    std::copy_if(v.begin(), v.end(), std::inserter(nonEmpty, nonEmpty.end()),
+                 [](const AMRange<T> &r) { return r.nonEmpty(); });
+    EXPECT_EQ(std::set<AMRange<T> >(packed.begin(), packed.end()), pack(nonEmpty));
+}
+
+TEST(AMRange, sortTest)
+{
+    checkRadixSort<int>(5000, -2000, 4000);
+    checkRadixSort<uint32_t>(5000, 0xfffff000u, 3000);
+    checkRadixSort<int64_t>(3000, -(int64_t(1) << 40), 100000);
+    checkRadixSort<uint64_t>(3000, uint64_t(1) << 63, 100000);
+    checkRadixSort<int8_t>(2000, -100, 190);
+    checkRadixSort<unsigned short>(2000, 0, 60000);
+    checkRadixSort<int>(10, 0, 5);
+    checkRadixSort<int>(1, 0, 5);
+    checkRadixSort<int>(0, 0, 5);
+}
+
+/*
+ * Numbers out of int range, or not integral.
+ */
+template<typename T>
+T wide(int x);
+
+template<>
+int64_t wide<int64_t>(int x)
+{
+    return (int64_t(1) << 40) + x;
+}
+
+template<>
+uint64_t wide<uint64_t>(int x)
+{
+    return (uint64_t(1) << 63) + x;
+}
+
+template<>
+double wide<double>(int x)
+{
+    return x + 0.25;
+}
+
+template<typename T>
+class AMRangeTyped : public ::testing::Test
+{
+};
+
+typedef ::testing::Types<int64_t, uint64_t, double> WideTypes;
+TYPED_TEST_SUITE(AMRangeTyped, WideTypes);
+
+TYPED_TEST(AMRangeTyped, subtractTest)
+{
+    typedef AMRange<TypeParam> R;
+    typedef std::set<R> S;
+    auto w = [](int x) { return wide<TypeParam>(x); };
+    S s01;
+    S s07 = {R(w(1), w(5)), R(w(7), w(9)), R(w(7), w(12)), R(w(12), w(15)), R(w(17), w(19))};
+    S s08 = {R(w(1), w(5)), R(w(7), w(15)), R(w(17), w(19))};
+    S s19 = {R(w(3), w(8)), R(w(10), w(11)), R(w(10), w(10)), R(w(14), w(18)), R(w(16), w(17))};
+    S s20 = {R(w(1), w(3)), R(w(8), w(10)), R(w(11), w(14)), R(w(18), w(19))};
+
+    //set - set, unpacked operands give packed result
+    EXPECT_EQ(s07 - s19, s20);
+    EXPECT_EQ(s08 - s19, s20);
+    EXPECT_EQ(s07 - s01, s08);
+    EXPECT_EQ(s01 - s07, s01);
+    EXPECT_EQ(s07 - s08, s01);
+    EXPECT_EQ(s07 - (S{R(w(0), w(30))}), s01);
+    EXPECT_EQ(subtract(s07, s19), s20);
+
+    //empty and invalid subtracted ranges do not split
+    EXPECT_EQ(s08 - (S{R(w(8), w(8)), R(w(12), w(10))}), s08);
+    EXPECT_EQ(s08 - R(w(8), w(8)), s08);
+
+    //range - set, set - range
+    EXPECT_EQ(R(w(0), w(20)) - s08, (S{R(w(0), w(1)), R(w(5), w(7)), R(w(15), w(17)), R(w(19), w(20))}));
+    EXPECT_EQ(R(w(2), w(18)) - s07, (S{R(w(5), w(7)), R(w(15), w(17))}));
+    EXPECT_EQ(s07 - R(w(4), w(18)), (S{R(w(1), w(4)), R(w(18), w(19))}));
+    EXPECT_EQ(s07 - R(w(20), w(30)), s08);
+
+    //difference is intersection with complement
+    R universe(w(0), w(30));
+    EXPECT_EQ(s07 - s19, s07 & complement(s19, universe));
+    EXPECT_EQ(s19 - s07, s19 & complement(s07, universe));
+    EXPECT_EQ((s07 - s19) + (s19 - s07), s07 ^ s19);
+
+    //iterator algorithm
+    std::vector<R> v07(s07.begin(), s07.end());
+    std::vector<R> v19(s19.begin(), s19.end());
+    std::vector<R> out;
+    subtract(v07.begin(), v07.end(), v19.begin(), v19.end(), std::back_inserter(out));
+    EXPECT_EQ(out, std::vector<R>(s20.begin(), s20.end()));
+}
+
+
+TEST(AMRange, statsTest)
+{
+    typedef AMRange<int> R;
+    std::set<R> s01;
+    std::set<R> s11 = {R(1, 15), R(17, 19), R(30, 31)};
+    std::set<R> s13 = {R(9, 15), R(18, 40)};
+
+    EXPECT_EQ(measure(R(3, 8)), 5u);
+    EXPECT_EQ(measure(R(8, 3)), 0u);
+    EXPECT_EQ(measure(R(INT32_MIN, INT32_MAX)), 0xffffffffu);
+    EXPECT_EQ(measure(s01), 0u);
+    EXPECT_EQ(measure(s11), 17u);
+    AMRangeStats<int> st = stats(s11);
+    EXPECT_EQ(st.count, 3u);
+    EXPECT_EQ(st.measure, 17u);
+    EXPECT_EQ(st.largestGap, 11u);
+    st = stats(s01);
+    EXPECT_EQ(st.count, 0u);
+    EXPECT_EQ(st.largestGap, 0u);
+    EXPECT_EQ(stats(s13).largestGap, 3u);
+
+    //overlap measure is measure of intersection
+    EXPECT_EQ(overlapMeasure(s11, s13), measure(s11 & s13));
+    EXPECT_EQ(overlapMeasure(s11, s01), 0u);
+    for (int i = 0; i < 50; i++) {
+        std::set<R> a, b;
+        for (int j = 0; j < 20; j++) {
+            int fa = (i * 31 + j * 17) % 200, fb = (i * 13 + j * 29) % 200;
+            a += R(fa, fa + (i + j) % 9);
+            b += R(fb, fb + (i * j) % 11);
+        }
+        EXPECT_EQ(overlapMeasure(a, b), measure(a & b));
+        EXPECT_EQ(overlapMeasure(b, a), measure(a & b));
+    }
+
+    //overlapping unpacked sets are packed first
+    std::set<R> u05 = {R(1, 5), R(3, 9), R(3, 4), R(12, 14), R(14, 16)};
+    std::set<R> u06 = {R(0, 6), R(2, 8), R(13, 20)};
+    EXPECT_FALSE(isPacked(u05));
+    EXPECT_EQ(measure(u05), 12u);
+    EXPECT_EQ(measure(u05), measure(pack(u05)));
+    EXPECT_EQ(overlapMeasure(u05, u06), 10u);
+    EXPECT_EQ(overlapMeasure(u05, u06), measure(u05 & u06));
+    EXPECT_EQ(overlapMeasure(u06, s11), measure(u06 & s11));
+    st = stats(u05);
+    EXPECT_EQ(st.count, 2u);
+    EXPECT_EQ(st.measure, 12u);
+    EXPECT_EQ(st.largestGap, 3u);
+
+    //floating point and wide bounds
+    std::set<AMRange<double> > d = {AMRange<double>(0.5, 1.5), AMRange<double>(4, 4.25)};
+    EXPECT_DOUBLE_EQ(measure(d), 1.25);
+    EXPECT_DOUBLE_EQ(stats(d).largestGap, 2.5);
+    std::set<AMRange<int64_t> > w = {AMRange<int64_t>(INT64_MIN, 0), AMRange<int64_t>(1, INT64_MAX)};
+    EXPECT_EQ(measure(w), UINT64_MAX - 1);
+}
+
+TEST(AMRange, allocatorTest)
+{
+    typedef AMRange<int> R;
+    typedef std::set<R> S;
+    typedef std::pmr::set<R> P;
+    std::pmr::monotonic_buffer_resource arena;
+    //any allocation outside of arena throws
+    std::pmr::memory_resource *previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    P p07({R(1, 5), R(7, 9), R(7, 12), R(12, 15), R(17, 19)}, &arena);
+    P p19({R(3, 8), R(10, 11), R(10, 10), R(14, 18), R(16, 17)}, &arena);
+    S s07(p07.begin(), p07.end(), std::allocator<R>());
+    S s19(p19.begin(), p19.end(), std::allocator<R>());
+    auto same = [](const P &p, const S &s) { return S(p.begin(), p.end()) == s; };
+    R r(4, 16);
+    R universe(0, 30);
+
+    P p = pack(p07);
+    EXPECT_EQ(p.get_allocator().resource(), &arena);
+    EXPECT_TRUE(same(p, pack(s07)));
+    EXPECT_TRUE(same(p07 + p19, s07 + s19));
+    EXPECT_TRUE(same(p07 - p19, s07 - s19));
+    EXPECT_TRUE(same(p07 & p19, s07 & s19));
+    EXPECT_TRUE(same(p07 ^ p19, s07 ^ s19));
+    EXPECT_TRUE(same(r + p19, r + s19));
+    EXPECT_TRUE(same(r - p19, r - s19));
+    EXPECT_TRUE(same(r & p19, r & s19));
+    EXPECT_TRUE(same(p07 + r, s07 + r));
+    EXPECT_TRUE(same(p07 - r, s07 - r));
+    EXPECT_TRUE(same(p07 & r, s07 & r));
+    EXPECT_TRUE(same(complement(p19, universe), complement(s19, universe)));
+    EXPECT_TRUE(same(packUnsorted(s19.rbegin(), s19.rend(), std::pmr::polymorphic_allocator<R>(&arena)), pack(s19)));
+    EXPECT_EQ((p07 - p19).get_allocator().resource(), &arena);
+
+    //in place operations
+    P q = pack(p07);
+    S t = pack(s07);
+    q += R(20, 25);
+    t += R(20, 25);
+    q -= R(2, 3);
+    t -= R(2, 3);
+    q &= p19;
+    t &= s19;
+    EXPECT_TRUE(same(q, t));
+    EXPECT_EQ(*find(q, 8), *find(t, 8));
+    EXPECT_EQ(covers(q, R(4, 5)), covers(t, R(4, 5)));
+    std::pmr::set_default_resource(previous);
 }
 
 
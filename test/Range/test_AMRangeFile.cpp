@@ -0,0 +1,162 @@
+#include "../../AMRangeFile.h"
+#include "../../AMRangeView.h"
+#include "gtest/gtest.h"
+#include <fstream>
+#include <sstream>
+
+using namespace AMCore;
+
+
+TEST(AMRangeFile, streamTest)
+{
+    typedef AMRange<int> R;
+    std::set<R> s07 = {R(1, 5), R(7, 9), R(7, 12), R(12, 15), R(17, 19)};
+    AMRangeSet<int> f08 = {R(1, 5), R(7, 15), R(17, 19)};
+    AMRangeSet<int> f01;
+
+    //round trip of flat set and of unpacked std::set
+    std::stringstream ss01;
+    EXPECT_TRUE(AMRangeFile<int>::write(ss01, f08));
+    EXPECT_EQ(ss01.str().size(), AMRangeFile<int>::headerSize + 3 * sizeof(R));
+    EXPECT_EQ(ss01.str().substr(0, 4), "AMRS");
+    EXPECT_TRUE(AMRangeFile<int>::read(ss01, f01));
+    EXPECT_EQ(f01, f08);
+    std::stringstream ss02;
+    EXPECT_TRUE(AMRangeFile<int>::write(ss02, s07));
+    EXPECT_EQ(ss02.str(), ss01.str());
+
+    //bounds are little endian
+    EXPECT_EQ(ss01.str().substr(AMRangeFile<int>::headerSize, 8), std::string("\1\0\0\0\5\0\0\0", 8));
+
+    //empty set
+    std::stringstream ss03;
+    AMRangeFile<int>::write(ss03, AMRangeSet<int>());
+    EXPECT_TRUE(AMRangeFile<int>::read(ss03, f01));
+    EXPECT_TRUE(f01.empty());
+
+    //bad files leave set unchanged
+    std::string good = ss01.str();
+    std::string bad = good;
+    bad[0] = 'X';
+    std::stringstream ss04(bad);
+    EXPECT_FALSE(AMRangeFile<int>::read(ss04, f08));
+    bad = good;
+    bad[4] = 2;
+    std::stringstream ss05(bad);
+    EXPECT_FALSE(AMRangeFile<int>::read(ss05, f08));
+    std::stringstream ss06(good.substr(0, good.size() - 1));
+    EXPECT_FALSE(AMRangeFile<int>::read(ss06, f08));
+    std::stringstream ss07(good);
+    AMRangeSet<unsigned> u01;
+    EXPECT_FALSE(AMRangeFile<unsigned>::read(ss07, u01));
+    std::stringstream ss08(good);
+    AMRangeSet<float> d01;
+    EXPECT_FALSE(AMRangeFile<float>::read(ss08, d01));
+    bad = good;
+    bad[AMRangeFile<int>::headerSize + 8] = 4;   //second range starts inside first one
+    std::stringstream ss09(bad);
+    EXPECT_FALSE(AMRangeFile<int>::read(ss09, f08));
+    EXPECT_EQ(f08.size(), 3u);
+
+    //huge count in corrupted header does not allocate it
+    bad = good;
+    bad[15] = 0x7f;
+    std::stringstream ss10(bad);
+    EXPECT_FALSE(AMRangeFile<int>::read(ss10, f08));
+
+    //other types
+    AMRangeSet<double> d02 = {AMRange<double>(-1.5, 0.25), AMRange<double>(3, 1e300)};
+    AMRangeSet<double> d03;
+    std::stringstream ss11;
+    AMRangeFile<double>::write(ss11, d02);
+    EXPECT_TRUE(AMRangeFile<double>::read(ss11, d03));
+    EXPECT_EQ(d02, d03);
+    AMRangeSet<int64_t> w01 = {AMRange<int64_t>(INT64_MIN, -5000000000), AMRange<int64_t>(7, INT64_MAX)};
+    AMRangeSet<int64_t> w02;
+    std::stringstream ss12;
+    AMRangeFile<int64_t>::write(ss12, w01);
+    EXPECT_TRUE(AMRangeFile<int64_t>::read(ss12, w02));
+    EXPECT_EQ(w01, w02);
+}
+
+#ifdef AMRANGE_HAS_MMAP
+TEST(AMRangeFile, mappedTest)
+{
+    typedef AMRange<int> R;
+    std::string path = testing::TempDir() + "test_AMRangeFile.amrs";
+    std::vector<R> v;
+    for (int i = 0; i < 100000; i++) {
+        v.push_back(R(i * 10, i * 10 + 5));
+    }
+    AMRangeSet<int> f01 = AMRangeSet<int>::fromPacked(std::vector<R>(v));
+    {
+        std::ofstream out(path, std::ios::binary);
+        EXPECT_TRUE(AMRangeFile<int>::write(out, f01));
+    }
+
+    AMMappedRangeSet<int> m01;
+    EXPECT_FALSE(m01.isOpen());
+    EXPECT_TRUE(m01.empty());
+    EXPECT_EQ(m01.find(1), m01.end());
+    EXPECT_TRUE(m01.open(path.c_str(), true));
+    EXPECT_TRUE(m01.isOpen());
+    EXPECT_EQ(m01.size(), v.size());
+    EXPECT_TRUE(std::equal(m01.begin(), m01.end(), v.begin(), v.end()));
+    EXPECT_EQ(m01[7], R(70, 75));
+    EXPECT_EQ(m01.toRangeSet(), f01);
+
+    //lookups
+    for (int num = -3; num < 2000; num++) {
+        AMMappedRangeSet<int>::const_iterator it = m01.find(num);
+        AMRangeSet<int>::const_iterator is = f01.find(num);
+        ASSERT_EQ(it == m01.end(), is == f01.end());
+        if (is != f01.end()) {
+            EXPECT_EQ(*it, *is);
+        }
+        R r(num, num + 3);
+        EXPECT_EQ(m01.covers(r), f01.covers(r));
+        EXPECT_EQ(m01.overlaps(r), f01.overlaps(r));
+        EXPECT_EQ(std::distance(m01.overlapping(r).first, m01.overlapping(r).second),
+                  std::distance(f01.overlapping(r).first, f01.overlapping(r).second));
+    }
+
+    //operand of set operations
+    std::set<R> s02 = {R(3, 12), R(996, 1000000)};
+    EXPECT_EQ((rangeView(m01) + rangeView(s02)).toRangeSet(), f01 + AMRangeSet<int>(s02));
+    EXPECT_EQ((rangeView(m01) - rangeView(s02)).toRangeSet(), f01 - AMRangeSet<int>(s02));
+
+    //move
+    AMMappedRangeSet<int> m02(std::move(m01));
+    EXPECT_FALSE(m01.isOpen());
+    EXPECT_EQ(m02.size(), v.size());
+    m01 = std::move(m02);
+    EXPECT_EQ(m01.size(), v.size());
+    m01.close();
+    EXPECT_TRUE(m01.empty());
+
+    //bad files
+    EXPECT_FALSE(m01.open((path + ".missing").c_str()));
+    AMMappedRangeSet<int64_t> m03;
+    EXPECT_FALSE(m03.open(path.c_str()));
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        std::string header(AMRangeFile<int>::headerSize, '\0');
+        out.write(header.data(), header.size());
+    }
+    EXPECT_FALSE(m01.open(path.c_str()));
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        AMRangeFile<int>::write(out, f01);
+    }
+    truncate(path.c_str(), AMRangeFile<int>::headerSize + 10 * sizeof(R));
+    EXPECT_FALSE(m01.open(path.c_str()));
+    EXPECT_FALSE(m01.isOpen());
+    std::remove(path.c_str());
+}
+#endif
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
@@ -0,0 +1,153 @@
+#include "../../AMRangeMap.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <type_traits>
+
+using namespace AMCore;
+
+
+TEST(AMRangeMap, basicTest)
+{
+    typedef AMRangeMap<int, std::string> Map;
+    Map m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.find(3), m.end());
+    EXPECT_EQ(m.at(3), nullptr);
+
+    //assign
+    m.assign(AMRange(0, 10), "a");
+    m.assign(AMRange(3, 5), "b");
+    EXPECT_EQ(m.size(), 3);
+    EXPECT_EQ(m[0].range, AMRange(0, 3));
+    EXPECT_EQ(m[1].range, AMRange(3, 5));
+    EXPECT_EQ(m[1].value, "b");
+    EXPECT_EQ(m[2].range, AMRange(5, 10));
+    EXPECT_EQ(*m.at(4), "b");
+    EXPECT_EQ(*m.at(5), "a");
+    EXPECT_EQ(m.at(10), nullptr);
+
+    //coalesce
+    m.assign(AMRange(3, 5), "a");
+    EXPECT_EQ(m.size(), 1);
+    EXPECT_EQ(m[0].range, AMRange(0, 10));
+    m.assign(AMRange(10, 12), "a");
+    m.assign(AMRange(-2, 0), "a");
+    EXPECT_EQ(m.size(), 1);
+    EXPECT_EQ(m[0].range, AMRange(-2, 12));
+    m.assign(AMRange(14, 16), "c");
+    m.assign(AMRange(12, 14), "c");
+    EXPECT_EQ(m.size(), 2);
+    EXPECT_EQ(m[1].range, AMRange(12, 16));
+    m.assign(AMRange(5, 7), "d");
+    m.assign(AMRange(5, 7), "d");
+    m.assign(AMRange(5, 5), "e");
+    m.assign(AMRange(6, 5), "e");
+    EXPECT_EQ(m.size(), 4);
+    m.assign(AMRange(-10, 30), "f");
+    EXPECT_EQ(m.size(), 1);
+    EXPECT_EQ(m[0].range, AMRange(-10, 30));
+
+    //erase
+    m.erase(AMRange(0, 5));
+    m.erase(AMRange(25, 40));
+    m.erase(AMRange(-20, -9));
+    m.erase(AMRange(7, 7));
+    EXPECT_EQ(m.size(), 2);
+    EXPECT_EQ(m[0].range, AMRange(-9, 0));
+    EXPECT_EQ(m[1].range, AMRange(5, 25));
+    EXPECT_EQ(m.ranges(), (AMRangeSet<int>{AMRange(-9, 0), AMRange(5, 25)}));
+    auto ov = m.overlapping(AMRange(-1, 6));
+    EXPECT_EQ(ov.second - ov.first, 2);
+    ov = m.overlapping(AMRange(0, 5));
+    EXPECT_EQ(ov.first, ov.second);
+    m.clear();
+    EXPECT_TRUE(m.empty());
+}
+
+/*
+ * Value without default constructor, counts living instances.
+ */
+struct Owner
+{
+    static int living;
+
+    explicit Owner(int id) : id(id) { living++; }
+    Owner(const Owner &o) : id(o.id) { living++; }
+    Owner &operator=(const Owner &o) = default;
+    ~Owner() { living--; }
+    bool operator==(const Owner &o) const { return id == o.id; }
+
+    int id;
+};
+
+int Owner::living = 0;
+
+TEST(AMRangeMap, noDefaultConstructorTest)
+{
+    static_assert(!std::is_default_constructible<Owner>::value);
+    {
+        AMRangeMap<int, Owner> m;
+        m.assign(AMRange(0, 10), Owner(1));
+        m.assign(AMRange(3, 5), Owner(2));
+        EXPECT_EQ(m.size(), 3);
+        EXPECT_EQ(m[0].value, Owner(1));
+        EXPECT_EQ(m[1].value, Owner(2));
+        EXPECT_EQ(m[2].range, AMRange(5, 10));
+        m.assign(AMRange(5, 12), Owner(2));
+        EXPECT_EQ(m.size(), 2);
+        EXPECT_EQ(m[1].range, AMRange(3, 12));
+        m.erase(AMRange(4, 6));
+        EXPECT_EQ(m.size(), 3);
+        EXPECT_EQ(m[1].range, AMRange(3, 4));
+        EXPECT_EQ(m[2].range, AMRange(6, 12));
+        EXPECT_EQ(m.at(7)->id, 2);
+        EXPECT_EQ(Owner::living, 3);
+    }
+    EXPECT_EQ(Owner::living, 0);
+}
+
+TEST(AMRangeMap, randomTest)
+{
+    const int size = 200;
+    int model[size];
+    std::fill(model, model + size, -1);
+    AMRangeMap<int, int> m;
+    unsigned seed = 7;
+    for (int step = 0; step < 5000; step++) {
+        seed = seed * 1103515245 + 12345;
+        int from = (seed >> 8) % size;
+        seed = seed * 1103515245 + 12345;
+        int to = from + (seed >> 8) % 20;
+        if (to > size) {
+            to = size;
+        }
+        int value = (seed >> 20) % 4;
+        if (value == 3) {
+            m.erase(AMRange(from, to));
+            value = -1;
+        } else {
+            m.assign(AMRange(from, to), value);
+        }
+        for (int i = from; i < to; i++) {
+            model[i] = value;
+        }
+        for (int i = 0; i < size; i++) {
+            const int *v = m.at(i);
+            EXPECT_EQ(v ? *v : -1, model[i]);
+        }
+        for (std::size_t i = 0; i < m.size(); i++) {
+            EXPECT_TRUE(m[i].range.nonEmpty());
+            if (i > 0) {
+                EXPECT_GE(m[i].range.from, m[i - 1].range.to);
+                EXPECT_FALSE(m[i].range.from == m[i - 1].range.to && m[i].value == m[i - 1].value);
+            }
+        }
+    }
+}
+
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
@@ -0,0 +1,107 @@
+#define AMRANGE_PARALLEL_MIN_CHUNK 4
+#include "../../AMRangeParallel.h"
+#include "gtest/gtest.h"
+#include "AMRangeTestUtil.h"
+#include <limits>
+
+using namespace AMCore;
+using namespace AMRangeTest;
+
+
+TEST(AMRangeParallel, packTest)
+{
+    for (unsigned seed = 1; seed < 20; seed++) {
+        std::vector<AMRange<int> > v = randomRanges<int>(seed * 37, -500, 1000, seed % 4 == 0 ? 300 : 12, seed);
+        AMRangeSet<int> expected = AMRangeSet<int>::fromUnsorted(v.begin(), v.end());
+        std::vector<AMRange<int> > sorted = v;
+        std::sort(sorted.begin(), sorted.end());
+        for (unsigned threads = 1; threads <= 9; threads++) {
+            EXPECT_EQ(AMRangeParallel<int>::pack(sorted, threads), expected);
+            std::vector<AMRange<int> > unsorted = v;
+            EXPECT_EQ(AMRangeParallel<int>::fromUnsorted(unsorted, threads), expected);
+        }
+    }
+
+    //one range spanning all chunks
+    std::vector<AMRange<int> > v = randomRanges<int>(200, -500, 1000, 5, 7);
+    v.push_back(AMRange<int>(-1000, 1000));
+    AMRangeSet<int> all(AMRange<int>(-1000, 1000));
+    EXPECT_EQ(AMRangeParallel<int>::fromUnsorted(v, 8), all);
+    std::sort(v.begin(), v.end());
+    EXPECT_EQ(AMRangeParallel<int>::pack(v, 8), all);
+}
+
+TEST(AMRangeParallel, setTest)
+{
+    for (unsigned seed = 1; seed < 20; seed++) {
+        std::vector<AMRange<int> > v1 = randomRanges<int>(seed * 29, -1000, 2000, seed % 5 == 0 ? 400 : 15, seed);
+        std::vector<AMRange<int> > v2 = randomRanges<int>(seed * 13 + 5, -1000, 2000, seed % 3 == 0 ? 100 : 9,
+                                                          seed + 100);
+        AMRangeSet<int> s1 = AMRangeSet<int>::fromUnsorted(v1.begin(), v1.end());
+        AMRangeSet<int> s2 = AMRangeSet<int>::fromUnsorted(v2.begin(), v2.end());
+        for (unsigned threads = 1; threads <= 9; threads++) {
+            EXPECT_EQ(AMRangeParallel<int>::unite(s1, s2, threads), s1 + s2);
+            EXPECT_EQ(AMRangeParallel<int>::subtract(s1, s2, threads), s1 - s2);
+            EXPECT_EQ(AMRangeParallel<int>::subtract(s2, s1, threads), s2 - s1);
+            EXPECT_EQ(AMRangeParallel<int>::intersect(s1, s2, threads), s1 & s2);
+            EXPECT_EQ(AMRangeParallel<int>::symmetricDifference(s1, s2, threads), s1 ^ s2);
+        }
+    }
+}
+
+TEST(AMRangeParallel, edgeTest)
+{
+    typedef AMRange<int> R;
+    const int lo = std::numeric_limits<int>::min();
+    const int hi = std::numeric_limits<int>::max();
+
+    //empty input
+    std::vector<R> empty;
+    AMRangeSet<int> e;
+    AMRangeSet<int> s = makeRandom<int>(100, -500, 1000, 5, 3);
+    for (unsigned threads = 1; threads <= 9; threads++) {
+        EXPECT_TRUE(AMRangeParallel<int>::pack(empty, threads).empty());
+        EXPECT_TRUE(AMRangeParallel<int>::fromUnsorted(empty, threads).empty());
+        EXPECT_EQ(AMRangeParallel<int>::unite(e, s, threads), s);
+        EXPECT_EQ(AMRangeParallel<int>::subtract(s, e, threads), s);
+        EXPECT_TRUE(AMRangeParallel<int>::subtract(e, s, threads).empty());
+        EXPECT_TRUE(AMRangeParallel<int>::intersect(e, s, threads).empty());
+        EXPECT_EQ(AMRangeParallel<int>::symmetricDifference(s, e, threads), s);
+    }
+
+    //touching ranges split to every chunk boundary are merged into one
+    std::vector<R> touching;
+    for (int i = 0; i < 100; i++) {
+        touching.push_back(R(i * 3, i * 3 + 3));
+    }
+    std::vector<R> odd, even;
+    for (int i = 0; i < 100; i++) {
+        (i % 2 ? odd : even).push_back(touching[i]);
+    }
+    AMRangeSet<int> so = AMRangeSet<int>::fromPacked(std::vector<R>(odd));
+    AMRangeSet<int> se = AMRangeSet<int>::fromPacked(std::vector<R>(even));
+    for (unsigned threads = 1; threads <= 9; threads++) {
+        EXPECT_EQ(AMRangeParallel<int>::pack(touching, threads), AMRangeSet<int>(R(0, 300)));
+        EXPECT_EQ(AMRangeParallel<int>::unite(so, se, threads), AMRangeSet<int>(R(0, 300)));
+        EXPECT_EQ(AMRangeParallel<int>::symmetricDifference(so, se, threads), AMRangeSet<int>(R(0, 300)));
+        EXPECT_TRUE(AMRangeParallel<int>::intersect(so, se, threads).empty());
+        EXPECT_EQ(AMRangeParallel<int>::subtract(so, se, threads), so);
+    }
+
+    //bounds of number space
+    std::vector<R> bounds = {R(hi - 5, hi), R(lo, lo + 5), R(0, 10), R(lo + 5, lo + 7), R(hi - 9, hi - 5)};
+    AMRangeSet<int> expected = {R(lo, lo + 7), R(0, 10), R(hi - 9, hi)};
+    AMRangeSet<int> cut = {R(lo + 1, lo + 2), R(hi - 1, hi)};
+    for (unsigned threads = 1; threads <= 9; threads++) {
+        std::vector<R> unsorted = bounds;
+        EXPECT_EQ(AMRangeParallel<int>::fromUnsorted(unsorted, threads), expected);
+        EXPECT_EQ(AMRangeParallel<int>::subtract(expected, cut, threads), expected - cut);
+        EXPECT_EQ(AMRangeParallel<int>::intersect(expected, cut, threads), cut);
+    }
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
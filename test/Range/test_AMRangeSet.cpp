@@ -0,0 +1,444 @@
+#include "../../AMRangeSet.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <random>
+#include <limits>
+
+using namespace AMCore;
+
+
+TEST(AMRangeSet, basicTest)
+{
+    AMRangeSet<int> s01;
+    AMRangeSet<int> s02 = {AMRange(1,5)};
+    AMRangeSet<int> s03 = {AMRange(7, 9), AMRange(1,5)};
+    AMRangeSet<int> s04 = {AMRange(1,5), AMRange(5, 9)};
+    AMRangeSet<int> s05 = {AMRange(1,5), AMRange(3, 9), AMRange(4, 4), AMRange(12, 9)};
+
+    //empty, size
+    EXPECT_TRUE(s01.empty());
+    EXPECT_EQ(s01.size(), 0);
+    EXPECT_FALSE(s02.empty());
+    EXPECT_EQ(s02.size(), 1);
+
+    //packed on construction
+    EXPECT_EQ(s03.size(), 2);
+    EXPECT_EQ(s03[0], AMRange(1, 5));
+    EXPECT_EQ(s03[1], AMRange(7, 9));
+    EXPECT_EQ(s04.size(), 1);
+    EXPECT_EQ(s04[0], AMRange(1, 9));
+    EXPECT_EQ(s05, s04);
+    EXPECT_TRUE(AMRangeSet<int>(AMRange(3, 3)).empty());
+    EXPECT_TRUE(AMRangeSet<int>(AMRange(3, 1)).empty());
+
+    //conversion
+    std::set<AMRange<int> > ss07 = {AMRange(1,5), AMRange(7, 9), AMRange(7, 12), AMRange(12, 15), AMRange(17, 19)};
+    std::set<AMRange<int> > ss08 = {AMRange(1, 5), AMRange(7,15), AMRange(17, 19)};
+    EXPECT_EQ(AMRangeSet<int>(ss07).toSet(), ss08);
+    EXPECT_EQ(AMRangeSet<int>(ss08).toSet(), ss08);
+    EXPECT_TRUE(isPacked(AMRangeSet<int>(ss07).toSet()));
+    EXPECT_EQ(s01.toSet(), std::set<AMRange<int> >());
+
+    //bulk construction from unsorted ranges
+    std::vector<AMRange<int> > v09 = {AMRange(17, 19), AMRange(12, 15), AMRange(7, 9), AMRange(3, 3), AMRange(1,5),
+                                      AMRange(9, 7), AMRange(7, 12), AMRange(13, 14)};
+    EXPECT_EQ(AMRangeSet<int>::fromUnsorted(v09.begin(), v09.end()).toSet(), ss08);
+    EXPECT_EQ(AMRangeSet<int>::fromUnsorted(std::vector<AMRange<int> >(v09)).toSet(), ss08);
+    EXPECT_TRUE(AMRangeSet<int>::fromUnsorted(v09.begin(), v09.begin()).empty());
+    EXPECT_TRUE(AMRangeSet<int>::fromUnsorted(std::vector<AMRange<int> >{AMRange(3, 3), AMRange(9, 7)}).empty());
+
+    //clear
+    s04.clear();
+    EXPECT_TRUE(s04.empty());
+}
+
+TEST(AMRangeSet, setTest)
+{
+    std::set<AMRange<int> > s01;
+    std::set<AMRange<int> > s02 = {AMRange(1,5)};
+    std::set<AMRange<int> > s03 = {AMRange(1,5), AMRange(7, 9)};
+    std::set<AMRange<int> > s04 = {AMRange(1,5), AMRange(5, 9)};
+    std::set<AMRange<int> > s05 = {AMRange(1,5), AMRange(3, 9)};
+    std::set<AMRange<int> > s07 = {AMRange(1,5), AMRange(7, 9), AMRange(7, 12), AMRange(12, 15), AMRange(17, 19)};
+    std::set<AMRange<int> > s08 = {AMRange(1, 5), AMRange(7,15), AMRange(17, 19)};
+    std::set<AMRange<int> > s09 = {AMRange(16, 17), AMRange(19,20), AMRange(27, 29)};
+    std::set<AMRange<int> > s10 = {AMRange(1, 5), AMRange(7,15),AMRange(16, 20), AMRange(27, 29)};
+    std::set<AMRange<int> > s14 = {AMRange(-1, 8), AMRange(15,18)};
+
+    AMRangeSet<int> f01(s01), f02(s02), f03(s03), f04(s04), f05(s05), f07(s07), f08(s08), f09(s09), f10(s10), f14(s14);
+
+    //operator+ gives the same result as for std::set
+    EXPECT_EQ((f07 + f05).toSet(), s07 + s05);
+    EXPECT_EQ((f03 + f01).toSet(), s03 + s01);
+    EXPECT_EQ((f03 + f02).toSet(), s03 + s02);
+    EXPECT_EQ((f03 + f04).toSet(), s03 + s04);
+    EXPECT_EQ((f07 + f09).toSet(), s07 + s09);
+    EXPECT_EQ((f01 + f01).toSet(), s01);
+    EXPECT_EQ((f07 + AMRange(15, 17)).toSet(), (std::set<AMRange<int> >{AMRange(1, 5), AMRange(7, 19)}));
+    EXPECT_EQ((AMRange(0, 1) + f07).toSet(), (std::set<AMRange<int> >{AMRange(0, 5), AMRange(7,15), AMRange(17, 19)}));
+    EXPECT_EQ(f07 + AMRange(15, 12), f08);
+
+    //operator- gives the same result as for std::set
+    EXPECT_EQ((f07 - f05).toSet(), s07 - s05);
+    EXPECT_EQ((f03 - f01).toSet(), s03 - s01);
+    EXPECT_EQ((f03 - f02).toSet(), s03 - s02);
+    EXPECT_EQ((f04 - f03).toSet(), s04 - s03);
+    EXPECT_EQ((f07 - f09).toSet(), s07 - s09);
+    EXPECT_EQ((f07 - f08).toSet(), s07 - s08);
+    EXPECT_EQ((f07 - f14).toSet(), s07 - s14);
+    EXPECT_EQ((f01 - f07).toSet(), s01);
+    EXPECT_EQ((AMRange(0, 35) - f07).toSet(), AMRange(0, 35) - s07);
+    EXPECT_EQ((f07 - AMRange(18, 20)).toSet(), s07 - AMRange(18, 20));
+    EXPECT_EQ((AMRange(1, 28) - f10).toSet(), AMRange(1, 28) - s10);
+
+    //operator& gives the same result as for std::set
+    EXPECT_EQ((f07 & f05).toSet(), s07 & s05);
+    EXPECT_EQ((f07 & f09).toSet(), s07 & s09);
+    EXPECT_EQ((f07 & f14).toSet(), s07 & s14);
+    EXPECT_EQ((f14 & f07).toSet(), s07 & s14);
+    EXPECT_EQ((f03 & f01).toSet(), s01);
+    EXPECT_EQ((AMRange(0, 35) & f07).toSet(), AMRange(0, 35) & s07);
+    EXPECT_EQ((f07 & AMRange(18, 20)).toSet(), s07 & AMRange(18, 20));
+
+    //symmetricDifference, complement give the same result as for std::set
+    EXPECT_EQ((f07 ^ f05).toSet(), s07 ^ s05);
+    EXPECT_EQ((f07 ^ f14).toSet(), s07 ^ s14);
+    EXPECT_EQ((f07 ^ f01).toSet(), s08);
+    EXPECT_EQ(symmetricDifference(f10, f07).toSet(), s10 ^ s07);
+    EXPECT_EQ(complement(f07, AMRange(0, 35)).toSet(), complement(s07, AMRange(0, 35)));
+    EXPECT_EQ(complement(f07, AMRange(3, 18)).toSet(), complement(s07, AMRange(3, 18)));
+    EXPECT_EQ(complement(f01, AMRange(3, 18)), AMRangeSet<int>(AMRange(3, 18)));
+
+    //operator+=, operator-=, operator&= give the same result as for std::set
+    const AMRange<int> ops[] = {AMRange(15, 17), AMRange(-3, -1), AMRange(30, 31), AMRange(2, 3), AMRange(4, 3),
+                                AMRange(0, 12), AMRange(5, 7), AMRange(-2, 3), AMRange(12, 12), AMRange(6, 40)};
+    for (const AMRange<int> &r : ops) {
+        AMRangeSet<int> fi = f10;
+        std::set<AMRange<int> > si = s10;
+        fi += r;
+        si += r;
+        EXPECT_EQ(fi.toSet(), si);
+        EXPECT_EQ(si, s10 + r);
+        fi = f10;
+        si = s10;
+        fi -= r;
+        si -= r;
+        EXPECT_EQ(fi.toSet(), si);
+        EXPECT_EQ(si, s10 - r);
+        fi = f10;
+        si = s10;
+        fi &= r;
+        si &= r;
+        EXPECT_EQ(fi.toSet(), si);
+        EXPECT_EQ(si, s10 & r);
+    }
+    AMRangeSet<int> fi = f08;
+    fi += f09;
+    EXPECT_EQ(fi, f08 + f09);
+    fi -= f14;
+    EXPECT_EQ(fi, (f08 + f09) - f14);
+    fi &= f02;
+    EXPECT_EQ(fi, ((f08 + f09) - f14) & f02);
+
+    //few added ranges are merged in place, ranges around them are kept
+    AMRangeSet<int> fr;
+    for (int i = 0; i < 100; i++) {
+        fr += AMRange(i * 10, i * 10 + 2);
+    }
+    AMRangeSet<int> fa = {AMRange(-5, -3), AMRange(12, 14), AMRange(16, 20), AMRange(502, 503), AMRange(995, 1005)};
+    AMRangeSet<int> fe = fr;
+    for (const AMRange<int> &r : fa) {
+        fe += r;
+    }
+    fr += fa;
+    EXPECT_EQ(fr, fe);
+    EXPECT_EQ(fr.measure(), fe.measure());
+    const AMRange<int> *kept = &fr[50];
+    AMRange<int> keptValue = fr[50];
+    fr += AMRangeSet<int>{AMRange(2, 5), AMRange(995, 1010)};
+    EXPECT_EQ(&fr[50], kept);
+    EXPECT_EQ(fr[50], keptValue);
+    EXPECT_EQ(fr[1], AMRange(0, 5));
+    std::mt19937 random(5);
+    for (int round = 0; round < 200; round++) {
+        AMRangeSet<int> left;
+        AMRangeSet<int> right;
+        for (int i = 0; i < 200; i++) {
+            int from = random() % 4000;
+            left += AMRange<int>(from, from + random() % 15);
+        }
+        for (int i = 0; i < int(random() % 12); i++) {
+            int from = random() % 4200 - 100;
+            right += AMRange<int>(from, from + random() % 200);
+        }
+        AMRangeSet<int> sum = left;
+        sum += right;
+        EXPECT_EQ(sum, AMRangeSet<int>::unite(left, right));
+        EXPECT_EQ(sum.measure(), AMRangeSet<int>::unite(left, right).measure());
+    }
+
+    //find, covers, overlaps, overlapping give the same result as for std::set
+    for (int i = -2; i < 32; i++) {
+        EXPECT_EQ(f10.find(i) == f10.end(), find(s10, i) == s10.end());
+        if (f10.find(i) != f10.end()) {
+            EXPECT_EQ(*f10.find(i), *find(s10, i));
+        }
+        for (int j = i; j < i + 6; j++) {
+            AMRange<int> r(i, j);
+            EXPECT_EQ(f10.covers(r), covers(s10, r));
+            EXPECT_EQ(f10.overlaps(r), overlaps(s10, r));
+            auto fo = f10.overlapping(r);
+            auto so = overlapping(s10, r);
+            EXPECT_EQ(std::set<AMRange<int> >(fo.first, fo.second), std::set<AMRange<int> >(so.first, so.second));
+        }
+    }
+}
+
+TEST(AMRangeSet, batchTest)
+{
+    AMRangeSet<int> s;
+    for (int i = 0; i < 1000; i++) {
+        s += AMRange<int>(i * 10 + (i % 3), i * 10 + 5 + (i % 7));
+    }
+    std::vector<int> nums;
+    for (int i = 0; i < 2000; i++) {
+        nums.push_back((i * 7919) % 10030 - 15);
+    }
+    std::vector<std::size_t> indices(nums.size());
+    s.findBatch(nums.data(), nums.size(), indices.data());
+    for (std::size_t i = 0; i < nums.size(); i++) {
+        AMRangeSet<int>::const_iterator it = s.find(nums[i]);
+        EXPECT_EQ(indices[i], it == s.end() ? AMRangeSet<int>::npos : std::size_t(it - s.begin()));
+    }
+    std::sort(nums.begin(), nums.end());
+    s.findBatch(nums.data(), nums.size(), indices.data(), true);
+    for (std::size_t i = 0; i < nums.size(); i++) {
+        AMRangeSet<int>::const_iterator it = s.find(nums[i]);
+        EXPECT_EQ(indices[i], it == s.end() ? AMRangeSet<int>::npos : std::size_t(it - s.begin()));
+    }
+
+    //unsigned and 64 bit types
+    AMRangeSet<unsigned> su = {AMRange<unsigned>(1, 5), AMRange<unsigned>(7, 9), AMRange<unsigned>(0x80000000u, 0xffffff00u)};
+    std::vector<unsigned> nu = {0, 1, 4, 5, 6, 7, 8, 9, 10, 0x7fffffffu, 0x80000000u, 0xfffffeffu, 0xffffff00u, 2, 3, 8};
+    std::vector<std::size_t> iu(nu.size());
+    const std::size_t np = AMRangeSet<unsigned>::npos;
+    su.findBatch(nu.data(), nu.size(), iu.data());
+    EXPECT_EQ(iu, (std::vector<std::size_t>{np, 0, 0, np, np, 1, 1, np, np, np, 2, 2, np, 0, 0, 1}));
+    AMRangeSet<int64_t> s64 = {AMRange<int64_t>(-5000000000, -1), AMRange<int64_t>(7, 9)};
+    std::vector<int64_t> n64 = {-5000000001, -5000000000, -1, 7, 9};
+    std::vector<std::size_t> i64(n64.size());
+    s64.findBatch(n64.data(), n64.size(), i64.data(), true);
+    EXPECT_EQ(i64, (std::vector<std::size_t>{np, 0, np, 1, np}));
+    AMRangeSet<int> se;
+    se.findBatch(nums.data(), 3, indices.data());
+    EXPECT_EQ(indices[0], AMRangeSet<int>::npos);
+    se.findBatch(nums.data(), 17, indices.data());
+    EXPECT_EQ(std::count(indices.begin(), indices.begin() + 17, AMRangeSet<int>::npos), 17);
+
+    //limits of bound type, numbers in full vector lanes and in scalar tail
+    const int imin = std::numeric_limits<int>::min();
+    const int imax = std::numeric_limits<int>::max();
+    AMRangeSet<int> sl = {AMRange(imin, imin + 2), AMRange(-1, 1), AMRange(imax - 2, imax)};
+    std::vector<int> nl = {imin, imin + 1, imin + 2, -2, -1, 0, 1, imax - 3, imax - 2, imax - 1, imax, imin};
+    std::vector<std::size_t> il(nl.size());
+    sl.findBatch(nl.data(), nl.size(), il.data());
+    EXPECT_EQ(il, (std::vector<std::size_t>{0, 0, np, np, 1, 1, np, np, 2, 2, np, 0}));
+
+    //32 bit bounds are searched in vector lanes when SIMD is enabled, results must match scalar search
+    std::mt19937 random(3);
+    for (std::size_t size : {1u, 2u, 3u, 7u, 8u, 9u, 1000u}) {
+        AMRangeSet<unsigned> sr;
+        while (sr.size() < size) {
+            unsigned from = random();
+            sr += AMRange<unsigned>(from, from + unsigned(random() % 0x10000u));
+        }
+        std::vector<unsigned> nr(37);
+        for (std::size_t i = 0; i < nr.size(); i++) {
+            nr[i] = i % 2 ? sr[random() % sr.size()].from + i : unsigned(random());
+        }
+        std::vector<std::size_t> ir(nr.size());
+        sr.findBatch(nr.data(), nr.size(), ir.data());
+        for (std::size_t i = 0; i < nr.size(); i++) {
+            AMRangeSet<unsigned>::const_iterator it = sr.find(nr[i]);
+            EXPECT_EQ(ir[i], it == sr.end() ? np : std::size_t(it - sr.begin()));
+        }
+    }
+    AMRangeSet<int> s1 = {AMRange(1, 3)};
+    std::vector<int> n1 = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    std::vector<std::size_t> i1(n1.size());
+    s1.findBatch(n1.data(), n1.size(), i1.data());
+    EXPECT_EQ(i1, (std::vector<std::size_t>{np, 0, 0, np, np, np, np, np, np}));
+}
+
+TEST(AMRangeSet, measureTest)
+{
+    typedef AMRange<int> R;
+    AMRangeSet<int> f01;
+    AMRangeSet<int> f11 = {R(1, 15), R(17, 19), R(30, 31)};
+    AMRangeSet<int> f13 = {R(9, 15), R(18, 40)};
+
+    EXPECT_EQ(f01.measure(), 0u);
+    EXPECT_EQ(f01.largestGap(), 0u);
+    EXPECT_EQ(f11.measure(), 17u);
+    EXPECT_EQ(f11.largestGap(), 11u);
+    AMRangeStats<int> st = f11.stats();
+    EXPECT_EQ(st.count, 3u);
+    EXPECT_EQ(st.measure, 17u);
+    EXPECT_EQ(st.largestGap, 11u);
+    EXPECT_EQ(f11.overlapMeasure(R(10, 18)), 6u);
+    EXPECT_EQ(f11.overlapMeasure(R(15, 17)), 0u);
+    EXPECT_EQ(overlapMeasure(f11, f13), (f11 & f13).measure());
+    EXPECT_EQ((f11 + f13).measure(), 37u);
+    EXPECT_EQ((f11 - f13).measure(), 9u);
+    EXPECT_EQ((f11 ^ f13).measure(), 29u);
+    EXPECT_EQ(complement(f11, R(0, 40)).measure(), 23u);
+    EXPECT_EQ(AMRangeSet<int>::fromPacked(std::vector<R>{R(1, 3), R(5, 6)}).measure(), 3u);
+
+    //measure is kept by every operation
+    auto check = [](const AMRangeSet<int> &s) {
+        unsigned sum = 0;
+        for (const R &r : s) {
+            sum += r.to - r.from;
+        }
+        EXPECT_EQ(s.measure(), sum);
+    };
+    AMRangeSet<int> f;
+    std::set<R> s;
+    for (int i = 0; i < 2000; i++) {
+        int from = (i * 7919) % 1000;
+        R r(from, from + (i * 31) % 40);
+        switch (i % 5) {
+            case 0:
+            case 1:
+                f += r;
+                s += r;
+                break;
+            case 2:
+                f -= r;
+                s -= r;
+                break;
+            case 3:
+                if (i % 50 == 3) {
+                    f &= R(from - 700, from + 300);
+                    s &= R(from - 700, from + 300);
+                }
+                break;
+            default:
+                f += AMRangeSet<int>{r, R(from + 100, from + 120)};
+                f -= AMRangeSet<int>{R(from + 50, from + 60), R(from + 200, from + 205)};
+                s += std::set<R>{r, R(from + 100, from + 120)};
+                s -= std::set<R>{R(from + 50, from + 60), R(from + 200, from + 205)};
+        }
+        check(f);
+        ASSERT_EQ(f.measure(), measure(s));
+        ASSERT_EQ(f.largestGap(), stats(s).largestGap);
+        AMRangeSet<int> g = AMRangeSet<int>::fromUnsorted(std::vector<R>{R(from, from + 10), R(from + 300, from + 400)});
+        ASSERT_EQ(overlapMeasure(f, g), (f & g).measure());
+        ASSERT_EQ(overlapMeasure(g, f), (f & g).measure());
+    }
+    f &= R(5, 5);
+    EXPECT_EQ(f.measure(), 0u);
+    f = f11;
+    f.clear();
+    EXPECT_EQ(f.measure(), 0u);
+
+    //float sums lengths
+    AMRangeSet<double> d = {AMRange<double>(0.5, 1.5), AMRange<double>(4, 4.25)};
+    d -= AMRange<double>(1, 4.125);
+    EXPECT_DOUBLE_EQ(d.measure(), 0.625);
+}
+
+/*
+ * Memory resource counting bytes allocated from new_delete_resource.
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocated = 0;
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        allocated += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(AMRangeSet, allocatorTest)
+{
+    typedef AMRange<int> R;
+    typedef pmr::AMRangeSet<int> P;
+    std::pmr::monotonic_buffer_resource arena;
+    //any allocation outside of arena throws
+    std::pmr::memory_resource *previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    P p07({R(1, 5), R(7, 9), R(7, 12), R(12, 15), R(17, 19)}, &arena);
+    P p19({R(3, 8), R(10, 11), R(10, 10), R(14, 18), R(16, 17)}, &arena);
+    AMRangeSet<int> s07 = AMRangeSet<int>::fromUnsorted(p07.begin(), p07.end());
+    AMRangeSet<int> s19 = AMRangeSet<int>::fromUnsorted(p19.begin(), p19.end());
+    auto same = [](const P &p, const AMRangeSet<int> &s) {
+        return std::equal(p.begin(), p.end(), s.begin(), s.end());
+    };
+    R r(4, 16);
+
+    EXPECT_EQ(p07.get_allocator().resource(), &arena);
+    EXPECT_TRUE(same(p07 + p19, s07 + s19));
+    EXPECT_TRUE(same(p07 - p19, s07 - s19));
+    EXPECT_TRUE(same(p07 & p19, s07 & s19));
+    EXPECT_TRUE(same(p07 ^ p19, s07 ^ s19));
+    EXPECT_TRUE(same(r + p19, r + s19));
+    EXPECT_TRUE(same(r - p19, r - s19));
+    EXPECT_TRUE(same(p07 & r, s07 & r));
+    EXPECT_TRUE(same(complement(p19, R(0, 30)), complement(s19, R(0, 30))));
+    EXPECT_EQ((p07 - p19).get_allocator().resource(), &arena);
+    EXPECT_EQ(p19.toSet().get_allocator().resource(), &arena);
+
+    P u(&arena);
+    u += p07;
+    u -= R(2, 3);
+    u &= p19;
+    AMRangeSet<int> v = s07;
+    v -= R(2, 3);
+    v &= s19;
+    EXPECT_TRUE(same(u, v));
+    std::vector<R, std::pmr::polymorphic_allocator<R> > w({R(9, 12), R(1, 3), R(2, 5)}, &arena);
+    EXPECT_TRUE(same(P::fromUnsorted(std::move(w)), AMRangeSet<int>{R(1, 5), R(9, 12)}));
+
+    //copy and buffer of radix sort are allocated by allocator of container too
+    const std::size_t n = 4 * AMRANGE_RADIX_SORT_THRESHOLD;
+    std::vector<R> random(n);
+    std::mt19937 mt(1);
+    for (R &rr : random) {
+        int from = int(mt() % 100000);
+        rr = R(from, from + int(mt() % 50));
+    }
+    AMRangeSet<int> expected = AMRangeSet<int>::fromUnsorted(random.begin(), random.end());
+    CountingResource counting;
+    std::pmr::vector<R> x(random.begin(), random.end(), &counting);
+    counting.allocated = 0;
+    EXPECT_TRUE(same(P::fromUnsorted(std::move(x)), expected));
+    EXPECT_GE(counting.allocated, 2 * n * sizeof(R));
+    counting.allocated = 0;
+    EXPECT_TRUE(same(P::fromUnsorted(random.begin(), random.end(), &counting), expected));
+    EXPECT_GE(counting.allocated, 3 * n * sizeof(R));
+    counting.allocated = 0;
+    std::pmr::set<R> y = packUnsorted(random.begin(), random.end(), std::pmr::polymorphic_allocator<R>(&counting));
+    EXPECT_EQ(y.size(), expected.size());
+    EXPECT_GE(counting.allocated, 3 * n * sizeof(R));
+    std::pmr::set_default_resource(previous);
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
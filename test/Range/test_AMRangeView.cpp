@@ -0,0 +1,96 @@
+#include "../../AMRangeView.h"
+#include "gtest/gtest.h"
+#include "AMRangeTestUtil.h"
+#include <limits>
+
+using namespace AMCore;
+using namespace AMRangeTest;
+
+
+TEST(AMRangeView, basicTest)
+{
+    std::set<AMRange<int> > s08 = {AMRange(1, 5), AMRange(7,15), AMRange(17, 19)};
+    std::set<AMRange<int> > s09 = {AMRange(16, 17), AMRange(19,20), AMRange(27, 29)};
+    std::set<AMRange<int> > s14 = {AMRange(-1, 8), AMRange(15,18)};
+    std::set<AMRange<int> > s01;
+
+    //the same result as for std::set, touching pieces are merged
+    EXPECT_EQ((rangeView(s08) + rangeView(s09)).toSet(), s08 + s09);
+    EXPECT_EQ((rangeView(s08) - rangeView(s14)).toSet(), s08 - s14);
+    EXPECT_EQ((rangeView(s08) & rangeView(s14)).toSet(), s08 & s14);
+    EXPECT_EQ((rangeView(s08) ^ rangeView(s14)).toSet(), s08 ^ s14);
+    EXPECT_EQ((rangeView(s08) ^ rangeView(s09)).toSet(), s08 ^ s09);
+
+    //chained expression, mixed containers
+    AMRangeSet<int> f14(s14);
+    auto chain = (rangeView(s08) + rangeView(s09)) - (rangeView(f14) & rangeView(s08));
+    EXPECT_EQ(chain.toSet(), (s08 + s09) - (s14 & s08));
+    EXPECT_EQ(chain.toRangeSet(), AMRangeSet<int>((s08 + s09) - (s14 & s08)));
+
+    //iteration
+    std::vector<AMRange<int> > v;
+    for (const AMRange<int> &r : rangeView(s08) + rangeView(s09)) {
+        v.push_back(r);
+    }
+    EXPECT_EQ(v, (std::vector<AMRange<int> >{AMRange(1, 5), AMRange(7, 15), AMRange(16, 20), AMRange(27, 29)}));
+    auto u = rangeView(s08) + rangeView(s09);
+    auto it = u.begin();
+    EXPECT_EQ(it->from, 1);
+    EXPECT_EQ(*it++, AMRange(1, 5));
+    EXPECT_EQ(*it, AMRange(7, 15));
+    EXPECT_EQ(std::distance(u.begin(), u.end()), 4);
+}
+
+TEST(AMRangeView, edgeTest)
+{
+    typedef AMRange<int> R;
+    const int lo = std::numeric_limits<int>::min();
+    const int hi = std::numeric_limits<int>::max();
+    std::set<R> s01;
+    AMRangeSet<int> f02 = {R(1, 5), R(7, 15)};
+
+    //empty operands, end of empty view is its begin
+    EXPECT_EQ((rangeView(s01) + rangeView(f02)).toRangeSet(), f02);
+    EXPECT_EQ((rangeView(f02) - rangeView(s01)).toRangeSet(), f02);
+    EXPECT_TRUE((rangeView(s01) - rangeView(f02)).toRangeSet().empty());
+    EXPECT_TRUE((rangeView(f02) & rangeView(s01)).toRangeSet().empty());
+    auto e = rangeView(s01) ^ rangeView(s01);
+    EXPECT_TRUE(e.begin() == e.end());
+
+    //touching but not overlapping ranges, union is merged, intersection is empty
+    AMRangeSet<int> f03 = {R(5, 7), R(15, 20)};
+    EXPECT_EQ((rangeView(f02) + rangeView(f03)).toRangeSet(), AMRangeSet<int>(R(1, 20)));
+    EXPECT_EQ((rangeView(f02) ^ rangeView(f03)).toRangeSet(), AMRangeSet<int>(R(1, 20)));
+    EXPECT_EQ((rangeView(f02) - rangeView(f03)).toRangeSet(), f02);
+    EXPECT_TRUE((rangeView(f02) & rangeView(f03)).toRangeSet().empty());
+
+    //bounds of number space
+    AMRangeSet<int> f04 = {R(lo, lo + 3), R(hi - 3, hi)};
+    AMRangeSet<int> f05 = {R(lo + 3, 0), R(hi - 1, hi)};
+    EXPECT_EQ((rangeView(f04) + rangeView(f05)).toRangeSet(), (AMRangeSet<int>{R(lo, 0), R(hi - 3, hi)}));
+    EXPECT_EQ((rangeView(f04) - rangeView(f05)).toRangeSet(), (AMRangeSet<int>{R(lo, lo + 3), R(hi - 3, hi - 1)}));
+    EXPECT_EQ((rangeView(f04) & rangeView(f05)).toRangeSet(), AMRangeSet<int>(R(hi - 1, hi)));
+    EXPECT_EQ((rangeView(f04) ^ rangeView(f05)).toRangeSet(), (AMRangeSet<int>{R(lo, 0), R(hi - 3, hi - 1)}));
+}
+
+TEST(AMRangeView, randomTest)
+{
+    for (unsigned seed = 1; seed < 30; seed++) {
+        AMRangeSet<int> a = makeRandom<int>(seed * 7, 0, 500, 20, seed);
+        AMRangeSet<int> b = makeRandom<int>(seed * 5, 0, 500, 30, seed + 100);
+        AMRangeSet<int> c = makeRandom<int>(seed * 3, 0, 500, 60, seed + 200);
+        AMRangeSet<int> d = makeRandom<int>(seed * 11, 0, 500, 10, seed + 300);
+        EXPECT_EQ((rangeView(a) + rangeView(b)).toRangeSet(), a + b);
+        EXPECT_EQ((rangeView(a) - rangeView(b)).toRangeSet(), a - b);
+        EXPECT_EQ((rangeView(a) & rangeView(b)).toRangeSet(), a & b);
+        EXPECT_EQ((rangeView(a) ^ rangeView(b)).toRangeSet(), a ^ b);
+        EXPECT_EQ(((rangeView(a) + rangeView(b)) - (rangeView(c) + rangeView(d))).toRangeSet(), (a + b) - (c + d));
+        EXPECT_EQ(((rangeView(a) ^ rangeView(b)) & (rangeView(c) - rangeView(d))).toRangeSet(), (a ^ b) & (c - d));
+    }
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
@@ -0,0 +1,165 @@
+#define AMRANGE_ROARING_MAX_RUNS 8
+#include "../../AMRoaringRangeSet.h"
+#include "gtest/gtest.h"
+#include "AMRangeTestUtil.h"
+#include <limits>
+
+using namespace AMCore;
+using namespace AMRangeTest;
+
+
+static void checkCanonical(const AMRoaringRangeSet &r, const AMRangeSet<uint32_t> &s)
+{
+    checkSame(r, s);
+    //canonical chunks
+    EXPECT_EQ(r, AMRoaringRangeSet(s));
+}
+
+TEST(AMRoaringRangeSet, basicTest)
+{
+    typedef AMRange<uint32_t> R;
+    std::set<R> s07 = {R(1, 5), R(7, 9), R(7, 12), R(12, 15), R(17, 19)};
+    AMRangeSet<uint32_t> f08 = {R(1, 5), R(7, 15), R(17, 19)};
+    AMRoaringRangeSet r01;
+    AMRoaringRangeSet r07(s07);
+    AMRoaringRangeSet r08(f08);
+
+    EXPECT_EQ(r07, r08);
+    EXPECT_NE(r01, r08);
+    EXPECT_EQ(r08.toRangeSet(), f08);
+    EXPECT_EQ(r08.toSet(), f08.toSet());
+    EXPECT_TRUE(r08.contains(14));
+    EXPECT_FALSE(r08.contains(15));
+    EXPECT_TRUE(r08.covers(R(8, 15)));
+    EXPECT_FALSE(r08.covers(R(8, 16)));
+    EXPECT_TRUE(r08.overlaps(R(15, 18)));
+    EXPECT_FALSE(r08.overlaps(R(15, 17)));
+    EXPECT_EQ(r08.measure(), 14u);
+
+    //ranges crossing chunks are joined
+    AMRoaringRangeSet r09 = {R(65530, 65536), R(65536, 131072), R(131072, 131080), R(200000, 300000)};
+    EXPECT_EQ(r09.size(), 2u);
+    EXPECT_EQ(*r09.begin(), R(65530, 131080));
+    EXPECT_TRUE(r09.covers(R(65535, 131075)));
+    EXPECT_FALSE(r09.covers(R(65535, 131085)));
+    r09 -= R(65536, 65537);
+    EXPECT_EQ(r09.toRangeSet(), AMRangeSet<uint32_t>({R(65530, 65536), R(65537, 131080), R(200000, 300000)}));
+    r09 &= R(100000, 250000);
+    EXPECT_EQ(r09.toRangeSet(), AMRangeSet<uint32_t>({R(100000, 131080), R(200000, 250000)}));
+
+    //many tiny ranges switch chunk to bitmap and back
+    AMRoaringRangeSet r11;
+    for (uint32_t i = 0; i < 20; i++) {
+        r11 += R(i * 4, i * 4 + 2);
+    }
+    EXPECT_EQ(r11.bitmapChunks(), 1u);
+    EXPECT_EQ(r11.size(), 20u);
+    EXPECT_EQ(r11.measure(), 40u);
+    r11 += R(0, 60);
+    EXPECT_EQ(r11.bitmapChunks(), 0u);
+    EXPECT_EQ(r11.size(), 5u);
+    r11 -= R(0, 100);
+    EXPECT_TRUE(r11.empty());
+}
+
+TEST(AMRoaringRangeSet, edgeTest)
+{
+    typedef AMRange<uint32_t> R;
+    const uint32_t hi = std::numeric_limits<uint32_t>::max();
+
+    //empty set and empty ranges
+    AMRoaringRangeSet r01;
+    AMRoaringRangeSet r02 = {R(3, 3), R(70000, 70000)};
+    EXPECT_EQ(r01, r02);
+    EXPECT_TRUE(r02.empty());
+    EXPECT_EQ(r02.begin(), r02.end());
+    EXPECT_EQ(r02.size(), 0u);
+    EXPECT_EQ(r02.measure(), 0u);
+    EXPECT_FALSE(r02.contains(3));
+    EXPECT_TRUE(r02.covers(R(3, 3)));
+    EXPECT_FALSE(r02.overlaps(R(0, 10)));
+    AMRoaringRangeSet r03 = {R(1, 5)};
+    EXPECT_EQ(r01 + r03, r03);
+    EXPECT_EQ(r03 - r01, r03);
+    EXPECT_TRUE((r01 - r03).empty());
+    EXPECT_TRUE((r03 & r01).empty());
+    EXPECT_EQ(r01 ^ r03, r03);
+    r03 -= R(0, 10);
+    EXPECT_EQ(r03, r01);
+
+    //touching ranges in bitmap chunk and across chunk boundary are merged, intersection is empty
+    AMRoaringRangeSet even, odd;
+    for (uint32_t i = 0; i < 40; i++) {
+        (i % 2 ? odd : even) += R(i * 2, i * 2 + 2);
+    }
+    even += R(65530, 65536);
+    odd += R(65536, 65540);
+    EXPECT_EQ(even.bitmapChunks(), 1u);
+    EXPECT_EQ(even + odd, AMRoaringRangeSet({R(0, 80), R(65530, 65540)}));
+    EXPECT_EQ(even ^ odd, even + odd);
+    EXPECT_TRUE((even & odd).empty());
+    EXPECT_EQ(even - odd, even);
+    EXPECT_EQ((even + odd).bitmapChunks(), 0u);
+
+    //bottom and top of number space
+    AMRoaringRangeSet r04 = {R(hi - 70000, hi), R(0, 1)};
+    EXPECT_EQ(*r04.begin(), R(0, 1));
+    EXPECT_EQ(*++r04.begin(), R(hi - 70000, hi));
+    EXPECT_TRUE(r04.contains(0));
+    EXPECT_TRUE(r04.contains(hi - 1));
+    EXPECT_FALSE(r04.contains(hi));
+    EXPECT_TRUE(r04.covers(R(hi - 1, hi)));
+    EXPECT_EQ(r04.measure(), 70001u);
+    r04 -= R(hi - 1, hi);
+    r04 += R(1, 2);
+    EXPECT_EQ(r04.toRangeSet(), AMRangeSet<uint32_t>({R(0, 2), R(hi - 70000, hi - 1)}));
+}
+
+TEST(AMRoaringRangeSet, randomTest)
+{
+    for (unsigned seed = 1; seed < 30; seed++) {
+        //around chunk boundaries, lengths from tiny to spanning several chunks
+        uint32_t base = 65536 * 3 - 3000;
+        uint32_t length = seed % 3 == 0 ? 200000 : 2 + seed;
+        AMRangeSet<uint32_t> a = makeRandom(seed * 30, base, 400000, length, seed);
+        AMRangeSet<uint32_t> b = makeRandom(seed * 40, base, 400000, 3 + seed % 7, seed + 100);
+        AMRoaringRangeSet ra(a);
+        AMRoaringRangeSet rb(b.begin(), b.end());
+        checkCanonical(ra, a);
+        checkCanonical(rb, b);
+        checkCanonical(ra + rb, a + b);
+        checkCanonical(ra - rb, a - b);
+        checkCanonical(ra & rb, a & b);
+        checkCanonical(ra ^ rb, a ^ b);
+        checkCanonical(rb - ra, b - a);
+
+        std::mt19937 random(seed);
+        AMRoaringRangeSet rc = ra;
+        AMRangeSet<uint32_t> c = a;
+        for (int i = 0; i < 50; i++) {
+            uint32_t from = base + random() % 400000;
+            AMRange<uint32_t> r(from, from + random() % (i % 5 == 0 ? 150000 : 50));
+            EXPECT_EQ(ra.contains(from), a.find(from) != a.end());
+            EXPECT_EQ(ra.covers(r), a.covers(r));
+            EXPECT_EQ(ra.overlaps(r), a.overlaps(r));
+            if (i % 2) {
+                rc += r;
+                c += r;
+            } else {
+                rc -= r;
+                c -= r;
+            }
+        }
+        checkCanonical(rc, c);
+        AMRange<uint32_t> window(base + 50000, base + 250000);
+        rc &= window;
+        c &= window;
+        checkCanonical(rc, c);
+    }
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
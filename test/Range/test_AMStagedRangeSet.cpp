@@ -0,0 +1,156 @@
+#define AMRANGE_STAGED_LIMIT 64
+#define AMRANGE_STAGED_DIRTY_REGIONS 4
+#include "../../AMStagedRangeSet.h"
+#include "gtest/gtest.h"
+#include <random>
+#include <limits>
+
+using namespace AMCore;
+
+
+TEST(AMStagedRangeSet, basicTest)
+{
+    typedef AMRange<int> R;
+    AMStagedRangeSet<int> s01(AMRangeSet<int>{R(1, 5), R(7, 15), R(17, 19)});
+    EXPECT_TRUE(s01.isPacked());
+    EXPECT_TRUE(s01.dirty().empty());
+
+    s01.insert(R(20, 22));
+    s01.insert(R(5, 6));
+    s01.insert(R(3, 2));
+    EXPECT_FALSE(s01.isPacked());
+    EXPECT_EQ(s01.staged(), 2u);
+    EXPECT_EQ(s01.dirty(), std::vector<R>({R(5, 6), R(20, 22)}));
+    EXPECT_EQ(s01.clean(), AMRangeSet<int>({R(1, 5), R(7, 15), R(17, 19)}));
+    EXPECT_TRUE(s01.contains(21));
+    EXPECT_TRUE(s01.contains(5));
+    EXPECT_FALSE(s01.contains(6));
+    EXPECT_FALSE(s01.contains(25));
+
+    //touching regions are joined
+    s01.insert(R(6, 8));
+    EXPECT_EQ(s01.dirty(), std::vector<R>({R(5, 8), R(20, 22)}));
+
+    EXPECT_EQ(s01.packed(), AMRangeSet<int>({R(1, 15), R(17, 19), R(20, 22)}));
+    EXPECT_TRUE(s01.isPacked());
+    EXPECT_TRUE(s01.dirty().empty());
+
+    s01.insert(R(15, 17));
+    s01.erase(R(0, 8));
+    EXPECT_EQ(s01.clean(), AMRangeSet<int>({R(8, 19), R(20, 22)}));
+    s01.clear();
+    EXPECT_TRUE(s01.packed().empty());
+
+    //empty set, limits of bound type
+    AMStagedRangeSet<int> s02;
+    s02.insert(R(std::numeric_limits<int>::min(), std::numeric_limits<int>::min() + 2));
+    s02.insert(R(std::numeric_limits<int>::max() - 1, std::numeric_limits<int>::max()));
+    EXPECT_EQ(s02.dirty().size(), 2u);
+    EXPECT_TRUE(s02.contains(std::numeric_limits<int>::min()));
+    EXPECT_FALSE(s02.contains(0));
+    EXPECT_EQ(s02.packed().size(), 2u);
+
+    //too many regions, nearest ones are joined
+    AMStagedRangeSet<int> s03;
+    for (int from : {0, 100, 110, 300, 500}) {
+        s03.insert(R(from, from + 5));
+    }
+    EXPECT_EQ(s03.dirty(), std::vector<R>({R(0, 5), R(100, 115), R(300, 305), R(500, 505)}));
+    EXPECT_FALSE(s03.contains(107));
+    EXPECT_TRUE(s03.contains(112));
+}
+
+TEST(AMStagedRangeSet, farRegionsTest)
+{
+    //inserts at both ends leave middle untouched
+    typedef AMRange<int> R;
+    AMRangeSet<int> base;
+    for (int i = 0; i < 1000; i++) {
+        base += R(i * 100, i * 100 + 50);
+    }
+    AMStagedRangeSet<int> s(base);
+    s.insert(R(20, 70));
+    s.insert(R(99920, 99960));
+    s.insert(R(5, 10));
+    s.insert(R(99955, 99958));
+    EXPECT_EQ(s.dirty(), std::vector<R>({R(5, 10), R(20, 70), R(99920, 99960)}));
+    EXPECT_FALSE(s.contains(75));
+    EXPECT_TRUE(s.contains(50010));
+    const AMRange<int> *middle = &s.clean()[500];
+    s.pack();
+    EXPECT_EQ(&s.clean()[500], middle);
+    EXPECT_EQ(s.clean()[500], R(50000, 50050));
+    EXPECT_EQ(s.clean()[0], R(0, 70));
+    EXPECT_EQ(s.clean().size(), 1000u);
+    EXPECT_EQ(s.clean()[999], R(99900, 99960));
+
+    //more staged than packed ranges, still merged in place
+    AMRangeSet<int> small;
+    for (int i = 0; i < 40; i++) {
+        small += R(i * 100, i * 100 + 50);
+    }
+    AMStagedRangeSet<int> t(small);
+    for (int i = 0; i < 30; i++) {
+        t.insert(i % 2 ? R(i, i + 20) : R(3960 - i, 3980));
+    }
+    EXPECT_EQ(t.dirty().size(), 2u);
+    const AMRange<int> *first = &t.clean()[0];
+    middle = &t.clean()[20];
+    t.pack();
+    EXPECT_EQ(&t.clean()[0], first);
+    EXPECT_EQ(&t.clean()[20], middle);
+    EXPECT_EQ(t.clean().size(), 40u);
+    EXPECT_EQ(t.clean()[0], R(0, 50));
+    EXPECT_EQ(t.clean()[39], R(3900, 3980));
+    EXPECT_EQ(t.clean().measure(), 40u * 50u + 30u);
+
+    //packed range spanning two regions, touching and new ranges
+    AMStagedRangeSet<int> u(AMRangeSet<int>{R(0, 1000), R(2000, 2010), R(3000, 3010)});
+    u.insert(R(10, 20));
+    u.insert(R(30, 40));
+    u.insert(R(1000, 1005));
+    u.insert(R(1990, 2000));
+    u.insert(R(2500, 2600));
+    u.insert(R(2550, 2700));
+    u.insert(R(4000, 4001));
+    EXPECT_EQ(u.packed(), (AMRangeSet<int>{R(0, 1005), R(1990, 2010), R(2500, 2700), R(3000, 3010), R(4000, 4001)}));
+    EXPECT_EQ(u.packed().measure(), 1005u + 20u + 200u + 10u + 1u);
+}
+
+TEST(AMStagedRangeSet, randomTest)
+{
+    std::mt19937 random(1);
+    AMRangeSet<int> base;
+    for (int i = 0; i < 1000; i++) {
+        base += AMRange<int>(i * 100, i * 100 + 50);
+    }
+    AMStagedRangeSet<int> s(base);
+    AMRangeSet<int> expected = base;
+    for (int round = 0; round < 50; round++) {
+        //inserts into one region, some of them spill anywhere
+        int region = int(random() % 100000);
+        int count = int(random() % 200);
+        for (int i = 0; i < count; i++) {
+            int from = i % 10 == 0 ? int(random() % 100000) : region + int(random() % 2000);
+            AMRange<int> r(from, from + int(random() % 120));
+            s.insert(r);
+            expected += r;
+            EXPECT_LE(s.staged(), 64u);
+            if (!s.isPacked() && r.nonEmpty()) {
+                EXPECT_TRUE(std::any_of(s.dirty().begin(), s.dirty().end(),
+                                        [&r](const AMRange<int> &d) { return d.from <= r.from && d.to >= r.to; }));
+                EXPECT_LE(s.dirty().size(), 4u);
+            }
+            int num = int(random() % 100000);
+            EXPECT_EQ(s.contains(num), expected.find(num) != expected.end());
+        }
+        EXPECT_EQ(s.packed(), expected);
+        EXPECT_EQ(s.packed().measure(), expected.measure());
+    }
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}
@@ -0,0 +1,115 @@
+#include "../../AMStaticRangeSet.h"
+#include "gtest/gtest.h"
+#include <random>
+
+using namespace AMCore;
+
+typedef AMRange<int> R;
+typedef AMStaticRangeSet<int, 8> S;
+
+//range operations in constant expressions
+static_assert(R(1, 5) + R(4, 10) == R(1, 10));
+static_assert(R(1, 5) - R(4, 10) == R(1, 4));
+static_assert(intersect(R(1, 8), R(5, 12)) == R(5, 8));
+static_assert(R(-5, 5).in(0) && !R(-5, 5).in(5));
+static_assert(R(1, 5).valid() && !R(5, 1).valid() && R(2, 2).empty());
+static_assert(measure(R(3, 10)) == 7u);
+static_assert(noexcept(R(1, 5) += R(4, 10)) && noexcept(R(1, 5).in(3)));
+
+//tables built by compiler
+static constexpr S s07 = {R(1, 5), R(7, 9), R(7, 12), R(12, 15), R(17, 19)};
+static constexpr S s05 = {R(3, 9), R(1, 5)};
+static constexpr S s11 = s07 + s05;
+static constexpr S s13 = s07 - s05;
+static constexpr S s14 = s07 & s05;
+
+static_assert(s07.size() == 3 && s07[1] == R(7, 15));
+static_assert(s11 == S{R(1, 15), R(17, 19)});
+static_assert(s13 == S{R(9, 15), R(17, 19)});
+static_assert(s14 == S{R(1, 5), R(7, 9)});
+static_assert(s07.measure() == 14u);
+static_assert(s07.contains(14) && !s07.contains(15) && !s07.contains(0));
+static_assert(s07.find(8)->from == 7);
+static_assert(s07.covers(R(8, 15)) && !s07.covers(R(8, 16)) && s07.covers(R(30, 30)));
+static_assert(s07.overlaps(R(15, 18)) && !s07.overlaps(R(15, 17)));
+
+static constexpr S makeSplit()
+{
+    S s(R(0, 100));
+    s -= R(10, 20);
+    s -= R(30, 40);
+    s += R(15, 35);
+    s &= R(5, 95);
+    return s;
+}
+static_assert(makeSplit() == S{R(5, 10), R(15, 35), R(40, 95)});
+
+TEST(AMStaticRangeSet, basicTest)
+{
+    EXPECT_EQ(s07.toRangeSet(), AMRangeSet<int>({R(1, 5), R(7, 15), R(17, 19)}));
+    EXPECT_EQ(s13.toRangeSet(), s07.toRangeSet() - s05.toRangeSet());
+    EXPECT_EQ(S::capacity(), 8u);
+
+    S s01;
+    EXPECT_TRUE(s01.empty());
+    EXPECT_EQ(s01.begin(), s01.end());
+    EXPECT_FALSE(s01.contains(0));
+    EXPECT_TRUE(S(R(5, 5)).empty());
+
+    //capacity exceeded, set is unchanged
+    AMStaticRangeSet<int, 2> s02 = {R(1, 10)};
+    s02 -= R(3, 4);
+    EXPECT_THROW(s02 -= R(6, 7), std::length_error);
+    EXPECT_THROW(s02 += R(12, 14), std::length_error);
+    EXPECT_EQ(s02.toRangeSet(), AMRangeSet<int>({R(1, 3), R(4, 10)}));
+    s02 += R(3, 4);
+    EXPECT_EQ(s02.size(), 1u);
+    EXPECT_EQ(s02[0], R(1, 10));
+}
+
+TEST(AMStaticRangeSet, randomTest)
+{
+    std::mt19937 random(7);
+    for (int round = 0; round < 2000; round++) {
+        AMStaticRangeSet<int, 64> s;
+        AMStaticRangeSet<int, 64> t;
+        AMRangeSet<int> f;
+        AMRangeSet<int> g;
+        for (int i = 0; i < 12; i++) {
+            int from = random() % 200;
+            R r(from, from + random() % 20);
+            t += r;
+            g += r;
+            from = random() % 200;
+            r = R(from, from + random() % 30);
+            switch (random() % 3) {
+            case 0:
+                s += r;
+                f += r;
+                break;
+            case 1:
+                s -= r;
+                f -= r;
+                break;
+            default:
+                s &= R(from - 100, from + 100);
+                f &= R(from - 100, from + 100);
+                break;
+            }
+            ASSERT_EQ(s.toRangeSet(), f);
+            ASSERT_EQ(s.measure(), f.measure());
+        }
+        EXPECT_EQ((s + t).toRangeSet(), f + g);
+        EXPECT_EQ((s - t).toRangeSet(), f - g);
+        EXPECT_EQ((s & t).toRangeSet(), f & g);
+        for (int num = -1; num < 230; num++) {
+            ASSERT_EQ(s.contains(num), f.find(num) != f.end());
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+
+     ::testing::InitGoogleTest(&argc, argv);
+     return RUN_ALL_TESTS();
+}